@@ -1,15 +1,23 @@
 #include "buchungsstapel_importer.hpp"
+#include "data_source.hpp"
+#include "directory_walker.hpp"
+#include "encoding_detector.hpp"
+#include "gdpdu_table_creator.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/common/types/date.hpp"
+#include "duckdb/main/appender.hpp"
+#include "duckdb/main/client_context.hpp"
 #include <sstream>
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
-#include <sys/stat.h>
-
-#ifdef _WIN32
-#include <windows.h>
-#include <fileapi.h>
-#else
-#include <dirent.h>
-#endif
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 namespace duckdb {
 
@@ -78,398 +86,1473 @@ static std::string escape_sql(const std::string& value) {
     return result;
 }
 
-// Convert UTF-8 string to wide string (Windows)
-#ifdef _WIN32
-static std::wstring utf8_to_wide(const std::string& utf8) {
-    if (utf8.empty()) return std::wstring();
-    int size_needed = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), (int)utf8.size(), NULL, 0);
-    if (size_needed <= 0) return std::wstring();
-    std::wstring result(size_needed, 0);
-    MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), (int)utf8.size(), &result[0], size_needed);
-    return result;
+// Text of a field as UTF-8: passed through when valid, else converted from the file's encoding
+// (stray bytes in a UTF-8 file are read as Windows-1252)
+static void field_to_utf8(const char* data, size_t size, const std::string& encoding, std::string& out) {
+    out.clear();
+    if (encoding == "UTF-8" && is_valid_utf8(data, size)) {
+        out.append(data, size);
+    } else {
+        append_as_utf8(out, data, size, encoding == "UTF-8" ? std::string("Windows-1252") : encoding);
+    }
 }
 
-// Convert wide string to UTF-8 string (Windows)
-static std::string wide_to_utf8(const std::wstring& wide) {
-    if (wide.empty()) return std::string();
-    int size_needed = WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), (int)wide.size(), NULL, 0, NULL, NULL);
-    if (size_needed <= 0) return std::string();
-    std::string result(size_needed, 0);
-    WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), (int)wide.size(), &result[0], size_needed, NULL, NULL);
-    return result;
+// Check for the DATEV export name pattern: "EXTF_Buchungsstapel*.csv" (extension case-insensitive)
+static bool is_buchungsstapel_file(const std::string& filename) {
+    if (filename.size() < 23 || filename.compare(0, 19, "EXTF_Buchungsstapel") != 0) {
+        return false;
+    }
+    std::string ext = filename.substr(filename.size() - 4);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".csv";
 }
-#endif
 
-// Scan folder for files starting with "EXTF_Buchungsstapel" and ending with ".csv"
-static std::vector<std::string> get_matching_buchungsstapel_files(const std::string& folder_path) {
-    std::vector<std::string> files;
+// Check for any DATEV EXTF export: "EXTF_*.csv" (Buchungsstapel, Debitoren_Kreditoren, ...)
+static bool is_extf_file(const std::string& filename) {
+    if (filename.size() < 9 || filename.compare(0, 5, "EXTF_") != 0) {
+        return false;
+    }
+    std::string ext = filename.substr(filename.size() - 4);
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".csv";
+}
 
-#ifdef _WIN32
-    // Windows implementation using wide-char FindFirstFileW/FindNextFileW
-    // to properly handle UTF-8 paths with non-ASCII characters (e.g. umlauts)
-    std::string search_path = join_path(folder_path, "*");
-    std::wstring wide_search = utf8_to_wide(search_path);
-    WIN32_FIND_DATAW find_data;
-    HANDLE find_handle = FindFirstFileW(wide_search.c_str(), &find_data);
+// Scan folder for files accepted by name_filter
+// Returns paths relative to folder_path
+static std::vector<std::string> get_matching_extf_files(const std::string& folder_path, bool recursive,
+                                                        bool (*name_filter)(const std::string&)) {
+    DirectoryWalkOptions walk;
+    walk.recursive = recursive;
+    walk.name_filter = name_filter;
 
-    if (find_handle == INVALID_HANDLE_VALUE) {
-        return files;
+    std::vector<std::string> files;
+    for (const auto& entry : walk_directory(folder_path, walk)) {
+        files.push_back(entry.relative_path);
     }
+    return files;
+}
 
-    do {
-        std::string filename = wide_to_utf8(find_data.cFileName);
-
-        // Skip hidden files and directories
-        if (filename.empty() || filename[0] == '.' || filename == ".." || filename == ".") {
-            continue;
-        }
+// ============================================================================
+// Section 2: Buffered record reader
+// ============================================================================
 
-        // Check if it's a regular file (not a directory)
-        if (!(find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
-            // Check prefix: starts with "EXTF_Buchungsstapel"
-            if (filename.size() >= 19 && filename.substr(0, 19) == "EXTF_Buchungsstapel") {
-                // Check suffix: ends with ".csv" (case-insensitive)
-                if (filename.size() >= 4) {
-                    std::string ext = filename.substr(filename.size() - 4);
-                    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-                    if (ext == ".csv") {
-                        files.push_back(filename);
+// One field of a record. Points into the reader's buffer (quotes removed and "" collapsed
+// in place) and stays valid until the next call to ExtfRecordReader::Next().
+struct FieldView {
+    const char* data;
+    size_t size;
+
+    FieldView() : data(nullptr), size(0) {}
+    FieldView(const char* d, size_t s) : data(d), size(s) {}
+};
+
+// Split a semicolon-delimited record respecting quoted fields.
+// Quoted fields are unquoted in place, so no field is copied.
+static void split_record(char* start, char* stop, std::vector<FieldView>& fields) {
+    char* p = start;
+    for (;;) {
+        char* field_start = p;
+        if (p < stop && *p == '"') {
+            char* out = p;
+            ++p;
+            while (p < stop) {
+                if (*p == '"') {
+                    // Escaped quote ("" inside quoted field)
+                    if (p + 1 < stop && p[1] == '"') {
+                        *out++ = '"';
+                        p += 2;
+                        continue;
                     }
+                    ++p;  // end of quoted field
+                    break;
                 }
+                *out++ = *p++;
+            }
+            // Anything between the closing quote and the delimiter is kept
+            while (p < stop && *p != ';') {
+                *out++ = *p++;
+            }
+            fields.push_back(FieldView(field_start, static_cast<size_t>(out - field_start)));
+        } else {
+            while (p < stop && *p != ';') {
+                ++p;
             }
+            fields.push_back(FieldView(field_start, static_cast<size_t>(p - field_start)));
         }
-    } while (FindNextFileW(find_handle, &find_data) != 0);
-
-    FindClose(find_handle);
-#else
-    // Unix/Linux/macOS implementation using opendir/readdir
-    DIR* dir = opendir(folder_path.c_str());
-    if (!dir) {
-        return files;
+        if (p >= stop) {
+            break;
+        }
+        ++p;  // skip the delimiter
     }
+}
 
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        std::string filename = entry->d_name;
+// Reads an EXTF file record by record in a single pass through a fixed-size buffer.
+// A record ends at a newline outside quotes; only a record cut by the buffer end is moved.
+// The buffer grows for a longer record, up to MAX_RECORD_SIZE.
+class ExtfRecordReader {
+public:
+    static const size_t MAX_RECORD_SIZE = 8 << 20;
 
-        // Skip hidden files and directories
-        if (filename[0] == '.' || filename == ".." || filename == ".") {
-            continue;
+    explicit ExtfRecordReader(const std::string& path)
+        : file_(path, std::ios::binary), buffer_(1 << 20), begin_(0), end_(0), eof_(false), started_(false),
+          records_(0), line_(1) {}
+
+    bool IsOpen() const { return file_.is_open(); }
+
+    // Why Next() returned false before the end of the file, empty otherwise
+    const std::string& Error() const { return error_; }
+
+    // The first buffer of the file, for encoding detection
+    const char* Peek(size_t& size, bool& complete) {
+        if (!started_) {
+            Fill();
         }
+        size = end_ - begin_;
+        complete = eof_;
+        return buffer_.data() + begin_;
+    }
 
-        // Check if it's a regular file
-        std::string full_path = join_path(folder_path, filename);
-        struct stat st;
-        if (stat(full_path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
-            // Check prefix: starts with "EXTF_Buchungsstapel"
-            if (filename.size() >= 19 && filename.substr(0, 19) == "EXTF_Buchungsstapel") {
-                // Check suffix: ends with ".csv" (case-insensitive)
-                if (filename.size() >= 4) {
-                    std::string ext = filename.substr(filename.size() - 4);
-                    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-                    if (ext == ".csv") {
-                        files.push_back(filename);
-                    }
+    // Next record split into fields; false at the end of the file, or with Error() set if the
+    // rest of the file is a quote that is never closed or a record exceeds MAX_RECORD_SIZE
+    bool Next(std::vector<FieldView>& fields) {
+        fields.clear();
+        if (!started_) {
+            Fill();
+        }
+        if (!error_.empty()) {
+            return false;
+        }
+
+        // Find the first newline outside quotes, reading more as needed
+        size_t scan = begin_;
+        bool in_quotes = false;
+        int64_t quoted_lines = 0;  // newlines inside quotes
+        for (;;) {
+            const char* data = buffer_.data();
+            while (scan < end_ && (data[scan] != '\n' || in_quotes)) {
+                if (data[scan] == '"') {
+                    in_quotes = !in_quotes;
+                } else if (data[scan] == '\n') {
+                    quoted_lines++;
                 }
+                ++scan;
+            }
+            if (scan < end_ || eof_) {
+                break;
+            }
+            if (end_ - begin_ >= MAX_RECORD_SIZE) {
+                error_ = in_quotes ? UnterminatedQuote()
+                                   : "record " + std::to_string(records_ + 1) + " (line " + std::to_string(line_) +
+                                         ") is longer than " + std::to_string(MAX_RECORD_SIZE >> 20) + " MB";
+                return false;
+            }
+            size_t offset = scan - begin_;
+            Fill();
+            scan = begin_ + offset;
+        }
+        if (scan == begin_ && scan == end_) {
+            return false;
+        }
+        if (in_quotes) {
+            // Returning the rest of the file as one record would lose every later record silently
+            error_ = UnterminatedQuote();
+            return false;
+        }
+        records_++;
+        line_ += quoted_lines + 1;
+
+        size_t stop = scan;
+        if (stop > begin_ && buffer_[stop - 1] == '\r') {
+            --stop;
+        }
+        split_record(&buffer_[begin_], &buffer_[0] + stop, fields);
+        begin_ = scan < end_ ? scan + 1 : scan;
+        return true;
+    }
+
+private:
+    // Move the unread tail to the front of the buffer and read more of the file
+    void Fill() {
+        if (begin_ > 0) {
+            std::memmove(&buffer_[0], &buffer_[begin_], end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+        }
+        if (end_ == buffer_.size()) {
+            buffer_.resize(buffer_.size() * 2);  // a single record larger than the buffer
+        }
+        file_.read(&buffer_[end_], static_cast<std::streamsize>(buffer_.size() - end_));
+        end_ += static_cast<size_t>(file_.gcount());
+        if (!file_) {
+            eof_ = true;
+        }
+        if (!started_) {
+            started_ = true;
+            // Skip a UTF-8 byte order mark
+            if (end_ >= 3 && static_cast<unsigned char>(buffer_[0]) == 0xEF &&
+                static_cast<unsigned char>(buffer_[1]) == 0xBB && static_cast<unsigned char>(buffer_[2]) == 0xBF) {
+                begin_ = 3;
             }
         }
     }
 
-    closedir(dir);
-#endif
+    std::string UnterminatedQuote() const {
+        return "unterminated quote starting at record " + std::to_string(records_ + 1) + " (line " +
+               std::to_string(line_) + ")";
+    }
 
-    return files;
+    std::ifstream file_;
+    std::vector<char> buffer_;
+    size_t begin_;  // start of the unread data
+    size_t end_;    // end of the valid data
+    bool eof_;
+    bool started_;
+    int64_t records_;  // records returned so far, header rows included
+    int64_t line_;     // line the next record starts on
+    std::string error_;
+};
+
+// Field with surrounding spaces/tabs removed
+static FieldView trim_field(const FieldView& field) {
+    const char* data = field.data;
+    size_t size = field.size;
+    while (size > 0 && (*data == ' ' || *data == '\t')) {
+        ++data;
+        --size;
+    }
+    while (size > 0 && (data[size - 1] == ' ' || data[size - 1] == '\t' || data[size - 1] == '\r')) {
+        --size;
+    }
+    return FieldView(data, size);
 }
 
 // ============================================================================
-// Section 2: CSV line parser
+// Section 3: Header parser
 // ============================================================================
 
-// Split a semicolon-delimited line respecting quoted fields
-static std::vector<std::string> split_csv_line(const std::string& line) {
-    std::vector<std::string> fields;
-    std::string current;
-    bool in_quotes = false;
-
-    for (size_t i = 0; i < line.size(); ++i) {
-        char c = line[i];
-
-        if (in_quotes) {
-            if (c == '"') {
-                // Check for escaped quote ("" inside quoted field)
-                if (i + 1 < line.size() && line[i + 1] == '"') {
-                    current += '"';
-                    ++i;  // skip the second quote
-                } else {
-                    // End of quoted field
-                    in_quotes = false;
-                }
-            } else {
-                current += c;
-            }
-        } else {
-            if (c == '"') {
-                in_quotes = true;
-            } else if (c == ';') {
-                fields.push_back(current);
-                current.clear();
-            } else {
-                current += c;
-            }
+// Metadata from the EXTF header row. Text fields are kept in the file's encoding.
+struct ExtfHeader {
+    int category;                         // Formatkategorie (21 = Buchungsstapel, 16 = Debitoren/Kreditoren, ...)
+    int format_version;                   // Formatversion
+    std::string format_name;              // Formatname
+    std::string created;                  // Erzeugt am, YYYYMMDDHHMMSSFFF
+    std::string herkunft;                 // Herkunft (source system code, e.g. "RE")
+    std::string exportiert_von;
+    int sachkontenlaenge;                 // length of G/L account numbers, 0 if missing
+    std::string diktatkuerzel;
+    int buchungstyp;                      // 1 = Finanzbuchführung, 2 = Jahresabschluss, 0 if missing
+    int festschreibung;                   // 0/1, -1 if missing
+    std::string wkz;                      // currency code
+    std::string skr;                      // chart of accounts, e.g. "03"
+    int from_year, from_month, from_day;  // Datum-von, 0 if missing (only Buchungsstapel has a period)
+    int to_year, to_month, to_day;        // Datum-bis, 0 if missing
+    int fy_year, fy_month, fy_day;        // WJ-Beginn (start of fiscal year), 0 if missing
+    std::string berater;                  // Berater-Nr
+    std::string mandant;                  // Mandanten-Nr
+    std::string bezeichnung;              // batch description
+
+    ExtfHeader()
+        : category(0), format_version(0), sachkontenlaenge(0), buchungstyp(0), festschreibung(-1), from_year(0), from_month(0), from_day(0), to_year(0), to_month(0),
+          to_day(0), fy_year(0), fy_month(0), fy_day(0) {}
+};
+
+// Parse a YYYYMMDD date field; false if it is not 8 digits forming a valid date
+static bool parse_yyyymmdd(const FieldView& field, int& year, int& month, int& day) {
+    FieldView value = trim_field(field);
+    if (value.size != 8) {
+        return false;
+    }
+    int digits = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        char c = value.data[i];
+        if (c < '0' || c > '9') {
+            return false;
         }
+        digits = digits * 10 + (c - '0');
+    }
+    year = digits / 10000;
+    month = digits / 100 % 100;
+    day = digits % 100;
+    return Date::IsValid(year, month, day);
+}
+
+static std::string header_text(const std::vector<FieldView>& fields, size_t index) {
+    if (index >= fields.size()) {
+        return "";
     }
+    FieldView value = trim_field(fields[index]);
+    return std::string(value.data, value.size);
+}
 
-    // Push the last field
-    fields.push_back(current);
+// Parse the first record (header/metadata row): the "EXTF" marker ("DTVF" in files written by
+// DATEV itself), Formatkategorie (field 2), Formatname (3) and Formatversion (4) are required.
+// Datum-von (14) and Datum-bis (15) are YYYYMMDD; they and the other metadata fields (Erzeugt am,
+// Berater, Mandant, WJ-Beginn, Sachkontenlänge, Bezeichnung, Festschreibung, WKZ, ...) are optional.
+static bool parse_extf_header(const std::vector<FieldView>& fields, ExtfHeader& header) {
+    std::string marker = header_text(fields, 0);
+    if (fields.size() <= 4 || (marker != "EXTF" && marker != "DTVF")) {
+        return false;
+    }
+    header.category = std::atoi(header_text(fields, 2).c_str());
+    header.format_name = header_text(fields, 3);
+    header.format_version = std::atoi(header_text(fields, 4).c_str());
+    if (header.category <= 0) {
+        return false;
+    }
 
-    return fields;
+    if (fields.size() <= 14 ||
+        !parse_yyyymmdd(fields[14], header.from_year, header.from_month, header.from_day)) {
+        header.from_year = header.from_month = header.from_day = 0;
+    }
+    if (header.from_year == 0 || fields.size() <= 15 ||
+        !parse_yyyymmdd(fields[15], header.to_year, header.to_month, header.to_day) ||
+        header.to_year < header.from_year) {
+        header.to_year = header.to_month = header.to_day = 0;
+    }
+    if (fields.size() <= 12 || !parse_yyyymmdd(fields[12], header.fy_year, header.fy_month, header.fy_day)) {
+        header.fy_year = header.fy_month = header.fy_day = 0;
+    }
+    header.berater = header_text(fields, 10);
+    header.mandant = header_text(fields, 11);
+    header.bezeichnung = header_text(fields, 16);
+    header.created = header_text(fields, 5);
+    header.herkunft = header_text(fields, 7);
+    header.exportiert_von = header_text(fields, 8);
+    header.sachkontenlaenge = std::atoi(header_text(fields, 13).c_str());
+    header.diktatkuerzel = header_text(fields, 17);
+    header.buchungstyp = std::atoi(header_text(fields, 18).c_str());
+    std::string festschreibung = header_text(fields, 20);
+    header.festschreibung = festschreibung == "1" ? 1 : festschreibung == "0" ? 0 : -1;
+    header.wkz = header_text(fields, 21);
+    header.skr = header_text(fields, 26);
+    return true;
 }
 
 // ============================================================================
-// Section 3: Header parser
+// Section 4: Format tables and column types
 // ============================================================================
 
-// Strip surrounding quotes from a field
-static std::string strip_quotes(const std::string& field) {
-    if (field.size() >= 2 && field.front() == '"' && field.back() == '"') {
-        return field.substr(1, field.size() - 2);
+// How a column is converted
+enum class ExtfColumnKind {
+    TEXT,        // VARCHAR as in the file
+    BELEGDATUM,  // compact DDMM -> DATE, year from the booking period
+    DATE,        // TTMMJJJJ -> DATE
+    DECIMAL_2,   // German decimal -> DECIMAL(18,2): amounts, percentages, weights
+    DECIMAL_6,   // German decimal -> DECIMAL(18,6): Kurs, quantities
+    INTEGER,     // whole number -> INTEGER: account numbers, keys, days
+    FLAG         // 0/1 -> BOOLEAN
+};
+
+// A typed column of a DATEV format, by its name in row 2; columns not listed are TEXT.
+// A strict column that doesn't parse skips the record, any other becomes NULL.
+struct ExtfColumnSpec {
+    const char* name;
+    ExtfColumnKind kind;
+    bool strict;
+};
+
+// Formatkategorie 21, versions up to 13
+static const ExtfColumnSpec BUCHUNGSSTAPEL_COLUMNS[] = {
+    {"Umsatz (ohne Soll/Haben-Kz)", ExtfColumnKind::DECIMAL_2, true},
+    {"Kurs", ExtfColumnKind::DECIMAL_6, true},
+    {"Basis-Umsatz", ExtfColumnKind::DECIMAL_2, true},
+    {"Konto", ExtfColumnKind::INTEGER, false},
+    {"Gegenkonto (ohne BU-Schlüssel)", ExtfColumnKind::INTEGER, false},
+    {"Belegdatum", ExtfColumnKind::BELEGDATUM, true},
+    {"Skonto", ExtfColumnKind::DECIMAL_2, false},
+    {"Postensperre", ExtfColumnKind::FLAG, false},
+    {"Geschäftspartnerbank", ExtfColumnKind::INTEGER, false},
+    {"Sachverhalt", ExtfColumnKind::INTEGER, false},
+    {"Zinssperre", ExtfColumnKind::FLAG, false},
+    {"KOST-Menge", ExtfColumnKind::DECIMAL_6, false},
+    {"EU-Steuersatz", ExtfColumnKind::DECIMAL_2, false},  // name before version 7
+    {"EU-Steuersatz (Bestimmung)", ExtfColumnKind::DECIMAL_2, false},
+    {"Sachverhalt L+L", ExtfColumnKind::INTEGER, false},
+    {"Funktionsergänzung L+L", ExtfColumnKind::INTEGER, false},
+    {"BU 49 Hauptfunktionstyp", ExtfColumnKind::INTEGER, false},
+    {"BU 49 Hauptfunktionsnummer", ExtfColumnKind::INTEGER, false},
+    {"BU 49 Funktionsergänzung", ExtfColumnKind::INTEGER, false},
+    {"Stück", ExtfColumnKind::INTEGER, false},
+    {"Gewicht", ExtfColumnKind::DECIMAL_2, false},
+    {"Zahlweise", ExtfColumnKind::INTEGER, false},
+    {"Veranlagungsjahr", ExtfColumnKind::INTEGER, false},
+    {"Zugeordnete Fälligkeit", ExtfColumnKind::DATE, false},
+    {"Skontotyp", ExtfColumnKind::INTEGER, false},
+    {"USt-Schlüssel (Anzahlungen)", ExtfColumnKind::INTEGER, false},
+    {"Sachverhalt L+L (Anzahlungen)", ExtfColumnKind::INTEGER, false},
+    {"EU-Steuersatz (Anzahlungen)", ExtfColumnKind::DECIMAL_2, false},
+    {"Erlöskonto (Anzahlungen)", ExtfColumnKind::INTEGER, false},
+    {"KOST-Datum", ExtfColumnKind::DATE, false},
+    {"Skontosperre", ExtfColumnKind::FLAG, false},
+    {"Beteiligtennummer", ExtfColumnKind::INTEGER, false},
+    {"Postensperre bis", ExtfColumnKind::DATE, false},
+    {"Kennzeichen SoBil-Buchung", ExtfColumnKind::INTEGER, false},
+    {"Festschreibung", ExtfColumnKind::FLAG, false},
+    {"Leistungsdatum", ExtfColumnKind::DATE, false},
+    {"Datum Zuord. Steuerperiode", ExtfColumnKind::DATE, false},
+    {"Fälligkeit", ExtfColumnKind::DATE, false},
+    {"Generalumkehr (GU)", ExtfColumnKind::FLAG, false},
+    {"Steuersatz", ExtfColumnKind::DECIMAL_2, false},
+    {"BVV-Position", ExtfColumnKind::INTEGER, false},
+    {"EU-Steuersatz (Ursprung)", ExtfColumnKind::DECIMAL_2, false},
+    {"Abw. Skontokonto", ExtfColumnKind::INTEGER, false},
+};
+
+// Bank connection fields of the address formats, repeated for bank connections 1 to 10
+#define EXTF_BANK_COLUMNS(n)                                                 \
+    {"Kennz. Hauptbankverb. " #n, ExtfColumnKind::FLAG, false},              \
+    {"Bankverb " #n " Gültig von", ExtfColumnKind::DATE, false},             \
+    {"Bankverb " #n " Gültig bis", ExtfColumnKind::DATE, false}
+
+// Formatkategorie 16, versions up to 5
+static const ExtfColumnSpec DEBITOREN_KREDITOREN_COLUMNS[] = {
+    {"Konto", ExtfColumnKind::INTEGER, true},
+    {"Adressattyp", ExtfColumnKind::INTEGER, false},
+    {"Kennz. Korrespondenzadresse", ExtfColumnKind::INTEGER, false},
+    {"Adresse Gültig von", ExtfColumnKind::DATE, false},
+    {"Adresse Gültig bis", ExtfColumnKind::DATE, false},
+    EXTF_BANK_COLUMNS(1), EXTF_BANK_COLUMNS(2), EXTF_BANK_COLUMNS(3), EXTF_BANK_COLUMNS(4),
+    EXTF_BANK_COLUMNS(5), EXTF_BANK_COLUMNS(6), EXTF_BANK_COLUMNS(7), EXTF_BANK_COLUMNS(8),
+    EXTF_BANK_COLUMNS(9), EXTF_BANK_COLUMNS(10),
+    {"Sprache", ExtfColumnKind::INTEGER, false},
+    {"Diverse-Konto", ExtfColumnKind::FLAG, false},
+    {"Ausgabeziel", ExtfColumnKind::INTEGER, false},
+    {"Währungssteuerung", ExtfColumnKind::INTEGER, false},
+    {"Kreditlimit (Debitor)", ExtfColumnKind::DECIMAL_2, false},
+    {"Zahlungsbedingung", ExtfColumnKind::INTEGER, false},
+    {"Fälligkeit in Tagen (Debitor)", ExtfColumnKind::INTEGER, false},
+    {"Skonto in Prozent (Debitor)", ExtfColumnKind::DECIMAL_2, false},
+    {"Kreditoren-Ziel 1 Tg.", ExtfColumnKind::INTEGER, false},
+    {"Kreditoren-Skonto 1 %", ExtfColumnKind::DECIMAL_2, false},
+    {"Kreditoren-Ziel 2 Tg.", ExtfColumnKind::INTEGER, false},
+    {"Kreditoren-Skonto 2 %", ExtfColumnKind::DECIMAL_2, false},
+    {"Kreditoren-Ziel 3 Brutto Tg.", ExtfColumnKind::INTEGER, false},
+    {"Kreditoren-Ziel 4 Tg.", ExtfColumnKind::INTEGER, false},
+    {"Kreditoren-Skonto 4 %", ExtfColumnKind::DECIMAL_2, false},
+    {"Kreditoren-Ziel 5 Tg.", ExtfColumnKind::INTEGER, false},
+    {"Kreditoren-Skonto 5 %", ExtfColumnKind::DECIMAL_2, false},
+    {"Mahnung", ExtfColumnKind::INTEGER, false},
+    {"Kontoauszug", ExtfColumnKind::INTEGER, false},
+    {"Mahntext 1", ExtfColumnKind::INTEGER, false},
+    {"Mahntext 2", ExtfColumnKind::INTEGER, false},
+    {"Mahntext 3", ExtfColumnKind::INTEGER, false},
+    {"Kontoauszugstext", ExtfColumnKind::INTEGER, false},
+    {"Mahnlimit Betrag", ExtfColumnKind::DECIMAL_2, false},
+    {"Mahnlimit %", ExtfColumnKind::DECIMAL_2, false},
+    {"Zinsberechnung", ExtfColumnKind::INTEGER, false},
+    {"Mahnzinssatz 1", ExtfColumnKind::DECIMAL_2, false},
+    {"Mahnzinssatz 2", ExtfColumnKind::DECIMAL_2, false},
+    {"Mahnzinssatz 3", ExtfColumnKind::DECIMAL_2, false},
+    {"Lastschrift", ExtfColumnKind::INTEGER, false},
+    {"Mandantenbank", ExtfColumnKind::INTEGER, false},
+    {"Zahlungsträger", ExtfColumnKind::INTEGER, false},
+    {"Kennz. Korrespondenzadresse (Rechnungsadresse)", ExtfColumnKind::INTEGER, false},
+    {"Adresse Gültig von (Rechnungsadresse)", ExtfColumnKind::DATE, false},
+    {"Adresse Gültig bis (Rechnungsadresse)", ExtfColumnKind::DATE, false},
+    {"Gebührenberechnung", ExtfColumnKind::INTEGER, false},
+    {"Mahngebühr 1", ExtfColumnKind::DECIMAL_2, false},
+    {"Mahngebühr 2", ExtfColumnKind::DECIMAL_2, false},
+    {"Mahngebühr 3", ExtfColumnKind::DECIMAL_2, false},
+    {"Pauschalenberechnung", ExtfColumnKind::INTEGER, false},
+    {"Verzugspauschale 1", ExtfColumnKind::DECIMAL_2, false},
+    {"Verzugspauschale 2", ExtfColumnKind::DECIMAL_2, false},
+    {"Verzugspauschale 3", ExtfColumnKind::DECIMAL_2, false},
+    {"Status", ExtfColumnKind::INTEGER, false},
+    {"Anschrift manuell geändert (Korrespondenzadresse)", ExtfColumnKind::FLAG, false},
+    {"Anschrift manuell geändert (Rechnungsadresse)", ExtfColumnKind::FLAG, false},
+    {"Fristberechnung bei Debitor", ExtfColumnKind::INTEGER, false},
+    {"Mahnfrist 1", ExtfColumnKind::INTEGER, false},
+    {"Mahnfrist 2", ExtfColumnKind::INTEGER, false},
+    {"Mahnfrist 3", ExtfColumnKind::INTEGER, false},
+    {"Letzte Frist", ExtfColumnKind::INTEGER, false},
+};
+
+// Formatkategorie 20, versions up to 3
+static const ExtfColumnSpec SACHKONTENBESCHRIFTUNGEN_COLUMNS[] = {
+    {"Konto", ExtfColumnKind::INTEGER, true},
+};
+
+// Formatkategorie 46, versions up to 2. The "Rechnung bis" block repeats three times;
+// the repeated columns get a suffix (skonto_1_datum, skonto_1_datum_2, ...).
+static const ExtfColumnSpec ZAHLUNGSBEDINGUNGEN_COLUMNS[] = {
+    {"Nummer", ExtfColumnKind::INTEGER, true},
+    {"Fälligkeitstyp", ExtfColumnKind::INTEGER, false},
+    {"Skonto 1%", ExtfColumnKind::DECIMAL_2, false},
+    {"Skonto 1 Tage", ExtfColumnKind::INTEGER, false},
+    {"Skonto 2%", ExtfColumnKind::DECIMAL_2, false},
+    {"Skonto 2 Tage", ExtfColumnKind::INTEGER, false},
+    {"Fällig Tage", ExtfColumnKind::INTEGER, false},
+    {"Rechnung bis 1", ExtfColumnKind::INTEGER, false},
+    {"Rechnung bis 2", ExtfColumnKind::INTEGER, false},
+    {"Rechnung bis 3", ExtfColumnKind::INTEGER, false},
+    {"Skonto 1 Datum", ExtfColumnKind::INTEGER, false},
+    {"Skonto 1 Monat", ExtfColumnKind::INTEGER, false},
+    {"Skonto 2 Datum", ExtfColumnKind::INTEGER, false},
+    {"Skonto 2 Monat", ExtfColumnKind::INTEGER, false},
+    {"Fällig Datum", ExtfColumnKind::INTEGER, false},
+    {"Fällig Monat", ExtfColumnKind::INTEGER, false},
+    {"Verwendung", ExtfColumnKind::INTEGER, false},
+};
+
+// Formatkategorie 48, versions up to 2
+static const ExtfColumnSpec DIVERSE_ADRESSEN_COLUMNS[] = {
+    {"Adressattyp", ExtfColumnKind::INTEGER, false},
+    {"Kennz. Korrespondenzadresse", ExtfColumnKind::INTEGER, false},
+    {"Adresse Gültig von", ExtfColumnKind::DATE, false},
+    {"Adresse Gültig bis", ExtfColumnKind::DATE, false},
+    {"Geburtsdatum", ExtfColumnKind::DATE, false},
+    EXTF_BANK_COLUMNS(1), EXTF_BANK_COLUMNS(2), EXTF_BANK_COLUMNS(3), EXTF_BANK_COLUMNS(4),
+    EXTF_BANK_COLUMNS(5), EXTF_BANK_COLUMNS(6), EXTF_BANK_COLUMNS(7), EXTF_BANK_COLUMNS(8),
+    EXTF_BANK_COLUMNS(9), EXTF_BANK_COLUMNS(10),
+    {"Sprache", ExtfColumnKind::INTEGER, false},
+    {"Ausgabeziel", ExtfColumnKind::INTEGER, false},
+    {"Status", ExtfColumnKind::INTEGER, false},
+};
+
+#undef EXTF_BANK_COLUMNS
+
+// A DATEV format: Formatkategorie from header field 2 and its column table. Versions of a format
+// only append or add columns, so one table per category covers all versions by column name.
+struct ExtfFormat {
+    int category;
+    const char* name;
+    const ExtfColumnSpec* columns;
+    size_t column_count;
+};
+
+static const ExtfFormat EXTF_FORMATS[] = {
+    {21, "Buchungsstapel", BUCHUNGSSTAPEL_COLUMNS,
+     sizeof(BUCHUNGSSTAPEL_COLUMNS) / sizeof(BUCHUNGSSTAPEL_COLUMNS[0])},
+    {16, "Debitoren/Kreditoren", DEBITOREN_KREDITOREN_COLUMNS,
+     sizeof(DEBITOREN_KREDITOREN_COLUMNS) / sizeof(DEBITOREN_KREDITOREN_COLUMNS[0])},
+    {20, "Sachkontenbeschriftungen", SACHKONTENBESCHRIFTUNGEN_COLUMNS,
+     sizeof(SACHKONTENBESCHRIFTUNGEN_COLUMNS) / sizeof(SACHKONTENBESCHRIFTUNGEN_COLUMNS[0])},
+    {46, "Zahlungsbedingungen", ZAHLUNGSBEDINGUNGEN_COLUMNS,
+     sizeof(ZAHLUNGSBEDINGUNGEN_COLUMNS) / sizeof(ZAHLUNGSBEDINGUNGEN_COLUMNS[0])},
+    {48, "Diverse Adressen", DIVERSE_ADRESSEN_COLUMNS,
+     sizeof(DIVERSE_ADRESSEN_COLUMNS) / sizeof(DIVERSE_ADRESSEN_COLUMNS[0])},
+};
+
+static const ExtfFormat* find_extf_format(int category) {
+    for (const auto& format : EXTF_FORMATS) {
+        if (format.category == category) {
+            return &format;
+        }
     }
-    return field;
+    return nullptr;
 }
 
-// Parse the first line (header/metadata row) to extract the year from Datum-von field
-// Returns the 4-digit year as an integer, or -1 on parse failure
-static int parse_buchungsstapel_header(const std::string& file_path) {
-    std::ifstream file(file_path);
-    if (!file.is_open()) {
-        return -1;
+// Column tables keyed by (category, normalized name), built once. The table names are UTF-8;
+// normalization drops the umlauts, so they match the column row in any encoding.
+static std::map<std::pair<int, std::string>, const ExtfColumnSpec*> build_extf_column_index() {
+    std::map<std::pair<int, std::string>, const ExtfColumnSpec*> index;
+    for (const auto& format : EXTF_FORMATS) {
+        for (size_t i = 0; i < format.column_count; ++i) {
+            index[std::make_pair(format.category, normalize_column_name(format.columns[i].name))] =
+                &format.columns[i];
+        }
     }
+    return index;
+}
 
-    std::string first_line;
-    if (!std::getline(file, first_line)) {
-        return -1;
+// A column of a file: its table column name and conversion
+struct ExtfColumn {
+    std::string name;
+    ExtfColumnKind kind;
+    bool strict;
+
+    ExtfColumn() : kind(ExtfColumnKind::TEXT), strict(false) {}
+};
+
+// Conversion of a normalized column name in a file of the given category
+static ExtfColumn resolve_column(int category, const std::string& name) {
+    static const std::map<std::pair<int, std::string>, const ExtfColumnSpec*> index = build_extf_column_index();
+
+    ExtfColumn column;
+    column.name = name;
+    auto it = index.find(std::make_pair(category, name));
+    if (it != index.end()) {
+        column.kind = it->second->kind;
+        column.strict = it->second->strict;
     }
+    return column;
+}
 
-    // Split by semicolons
-    std::vector<std::string> fields = split_csv_line(first_line);
-
-    // Strip quotes from each field
-    for (size_t i = 0; i < fields.size(); ++i) {
-        fields[i] = strip_quotes(fields[i]);
+static LogicalType get_column_type(ExtfColumnKind kind) {
+    switch (kind) {
+    case ExtfColumnKind::BELEGDATUM:
+    case ExtfColumnKind::DATE:
+        return LogicalType::DATE;
+    case ExtfColumnKind::DECIMAL_2:
+        return LogicalType::DECIMAL(18, 2);
+    case ExtfColumnKind::DECIMAL_6:
+        return LogicalType::DECIMAL(18, 6);
+    case ExtfColumnKind::INTEGER:
+        return LogicalType::INTEGER;
+    case ExtfColumnKind::FLAG:
+        return LogicalType::BOOLEAN;
+    default:
+        return LogicalType::VARCHAR;
     }
+}
 
-    // Field 14 (0-indexed) is Datum-von in YYYYMMDD format
-    if (fields.size() <= 14) {
-        return -1;
+// Format of a file for the result, e.g. "Buchungsstapel v13"
+static std::string describe_format(const ExtfHeader& header, const std::string& encoding) {
+    const ExtfFormat* format = find_extf_format(header.category);
+    std::string name;
+    if (format) {
+        name = format->name;
+    } else if (!header.format_name.empty()) {
+        field_to_utf8(header.format_name.data(), header.format_name.size(), encoding, name);
+    } else {
+        name = "Kategorie " + std::to_string(header.category);
     }
+    if (header.format_version > 0) {
+        name += " v" + std::to_string(header.format_version);
+    }
+    return name;
+}
 
-    std::string datum_von = fields[14];
-    // Trim whitespace
-    while (!datum_von.empty() && (datum_von.front() == ' ' || datum_von.front() == '\t')) {
-        datum_von.erase(datum_von.begin());
+// Open an EXTF file: detects the encoding from the first buffer and reads the header and the
+// column row, leaving the reader at the first data record. Columns are typed by the format
+// category; a name repeated in the column row gets a suffix ("leerfeld", "leerfeld_2").
+// False with error set on failure.
+static bool open_extf_file(ExtfRecordReader& reader, ExtfHeader& header, std::vector<ExtfColumn>& columns,
+                           std::string& encoding, std::string& error) {
+    if (!reader.IsOpen()) {
+        error = "Load failed: could not open file";
+        return false;
     }
-    while (!datum_von.empty() && (datum_von.back() == ' ' || datum_von.back() == '\t' || datum_von.back() == '\r')) {
-        datum_von.pop_back();
+
+    // Encoding from the first buffer: UTF-8 or a single-byte code page (DATEV writes ANSI)
+    size_t sample_size = 0;
+    bool complete = false;
+    const char* sample = reader.Peek(sample_size, complete);
+    encoding = detect_encoding(sample, sample_size, complete).encoding;
+    if (encoding == "UTF-16") {
+        error = "Load failed: UTF-16 encoded files are not supported";
+        return false;
     }
 
-    // Extract 4-digit year (first 4 characters of YYYYMMDD)
-    if (datum_von.size() < 4) {
-        return -1;
+    std::vector<FieldView> fields;
+    if (!reader.Next(fields) || !parse_extf_header(fields, header)) {
+        error = reader.Error().empty() ? "Failed to parse header (not a DATEV EXTF header row)"
+                                       : "Load failed: " + reader.Error();
+        return false;
     }
 
-    // Verify the first 4 characters are digits
-    for (int i = 0; i < 4; ++i) {
-        if (!std::isdigit(static_cast<unsigned char>(datum_von[i]))) {
-            return -1;
+    columns.clear();
+    std::map<std::string, int> name_count;
+    bool has_belegdatum = false;
+    if (reader.Next(fields)) {
+        for (const auto& field : fields) {
+            FieldView name = trim_field(field);
+            ExtfColumn column = resolve_column(header.category, normalize_column_name(std::string(name.data, name.size)));
+            int count = ++name_count[column.name];
+            if (count > 1) {
+                column.name += "_" + std::to_string(count);
+            }
+            has_belegdatum = has_belegdatum || column.kind == ExtfColumnKind::BELEGDATUM;
+            columns.push_back(column);
         }
     }
+    if (!reader.Error().empty()) {
+        error = "Load failed: " + reader.Error();
+        return false;
+    }
+    if (columns.empty() || (columns.size() == 1 && columns[0].name.empty())) {
+        error = "Failed to parse column names from row 2";
+        return false;
+    }
+    if (has_belegdatum && header.from_year == 0) {
+        error = "Failed to parse header (could not read Datum-von field)";
+        return false;
+    }
+    return true;
+}
+
+// Build CREATE OR REPLACE TABLE statement with typed columns + file_name VARCHAR
+// extra_columns: further column definitions after file_name (", \"x\" BIGINT, ...")
+static std::string build_create_table_sql(const std::string& table_name, const std::vector<ExtfColumn>& columns,
+                                          const std::string& extra_columns = "") {
+    std::ostringstream sql;
+    sql << "CREATE OR REPLACE TABLE \"" << table_name << "\" (";
+
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (i > 0) sql << ", ";
+        sql << "\"" << escape_sql(columns[i].name) << "\" " << get_column_type(columns[i].kind).ToString();
+    }
 
-    int year = std::stoi(datum_von.substr(0, 4));
-    return year;
+    sql << ", \"file_name\" VARCHAR" << extra_columns << ")";
+    return sql.str();
 }
 
 // ============================================================================
-// Section 4: Column name parser
+// Section 5: Value parsers
 // ============================================================================
 
-// Parse the second line of the CSV file to get column names
-static std::vector<std::string> parse_buchungsstapel_columns(const std::string& file_path) {
-    std::vector<std::string> columns;
+// German decimal ("1.234,56", "-0,5") as an integer scaled by 10^scale, rounded half away
+// from zero like CAST(... AS DECIMAL(18,scale)). False if not a number or > 18 digits.
+static bool parse_german_decimal(const FieldView& field, int scale, int64_t& result) {
+    const int64_t limit = 1000000000000000000LL;  // 10^18
+    const char* p = field.data;
+    const char* end = field.data + field.size;
+
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
 
-    std::ifstream file(file_path);
-    if (!file.is_open()) {
-        return columns;
+    int64_t value = 0;
+    int decimals = 0;
+    bool in_fraction = false;
+    bool any_digit = false;
+    bool round_up = false;
+    bool rounding_digit_seen = false;
+    for (; p < end; ++p) {
+        char c = *p;
+        if (c >= '0' && c <= '9') {
+            any_digit = true;
+            if (in_fraction && decimals == scale) {
+                if (!rounding_digit_seen) {
+                    round_up = c >= '5';
+                    rounding_digit_seen = true;
+                }
+                continue;
+            }
+            if (value >= limit / 10) {
+                return false;
+            }
+            value = value * 10 + (c - '0');
+            if (in_fraction) {
+                decimals++;
+            }
+        } else if (c == '.' && !in_fraction) {
+            continue;  // thousands separator
+        } else if (c == ',' && !in_fraction) {
+            in_fraction = true;
+        } else {
+            return false;
+        }
     }
+    if (!any_digit) {
+        return false;
+    }
+    for (; decimals < scale; ++decimals) {
+        if (value >= limit / 10) {
+            return false;
+        }
+        value *= 10;
+    }
+    if (round_up && ++value >= limit) {
+        return false;
+    }
+    result = negative ? -value : value;
+    return true;
+}
 
-    // Skip the first line (metadata header)
-    std::string line;
-    if (!std::getline(file, line)) {
-        return columns;
+// Whole number ("1200", "-3") that fits INTEGER; at most 9 digits
+static bool parse_integer(const FieldView& field, int32_t& result) {
+    const char* p = field.data;
+    const char* end = field.data + field.size;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
     }
+    if (p == end || end - p > 9) {
+        return false;
+    }
+    int32_t value = 0;
+    for (; p < end; ++p) {
+        unsigned digit = static_cast<unsigned>(*p - '0');
+        if (digit > 9) {
+            return false;
+        }
+        value = value * 10 + static_cast<int32_t>(digit);
+    }
+    result = negative ? -value : value;
+    return true;
+}
 
-    // Read the second line (column names)
-    if (!std::getline(file, line)) {
-        return columns;
+// DATEV flag: "0" or "1"
+static bool parse_flag(const FieldView& field, bool& result) {
+    if (field.size != 1 || (field.data[0] != '0' && field.data[0] != '1')) {
+        return false;
     }
+    result = field.data[0] == '1';
+    return true;
+}
 
-    // Split by semicolons
-    std::vector<std::string> fields = split_csv_line(line);
+// Full date in DATEV's TTMMJJJJ form ("15012024" = 2024-01-15)
+static bool parse_ddmmyyyy(const FieldView& field, date_t& result) {
+    if (field.size != 8) {
+        return false;
+    }
+    int value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        unsigned digit = static_cast<unsigned>(field.data[i] - '0');
+        if (digit > 9) {
+            return false;
+        }
+        value = value * 10 + static_cast<int>(digit);
+    }
+    int day = value / 1000000;
+    int month = value / 10000 % 100;
+    int year = value % 10000;
+    if (!Date::IsValid(year, month, day)) {
+        return false;
+    }
+    result = Date::FromDate(year, month, day);
+    return true;
+}
 
-    // Strip surrounding quotes from each column name
-    for (size_t i = 0; i < fields.size(); ++i) {
-        std::string col = strip_quotes(fields[i]);
-        // Trim whitespace and carriage return
-        while (!col.empty() && (col.back() == ' ' || col.back() == '\t' || col.back() == '\r')) {
-            col.pop_back();
+// Resolves compact DDMM Belegdatum values against the booking period of the header.
+// The year of each month is fixed per file: Datum-von's year, or Datum-bis's year for months
+// before Datum-von's month when the period crosses a year end (fiscal year Jul-Jun, or a batch
+// Dec-Jan). First day and length of each month are precomputed, so a value costs one digit scan.
+struct BelegdatumKernel {
+    int32_t month_start[13];  // date_t days of the 1st of each month
+    int month_days[13];
+
+    explicit BelegdatumKernel(const ExtfHeader& header) {
+        bool crosses_year = header.to_year > header.from_year;
+        for (int month = 1; month <= 12; ++month) {
+            int year = (crosses_year && month < header.from_month) ? header.to_year : header.from_year;
+            month_start[month] = Date::FromDate(year, month, 1).days;
+            month_days[month] = Date::IsValid(year, month, 31) ? 31 : Date::IsValid(year, month, 30) ? 30
+                              : Date::IsValid(year, month, 29) ? 29 : 28;
+        }
+    }
+
+    // "2001" = 20th Jan, "103" = 1st Mar
+    bool Parse(const FieldView& field, date_t& result) const {
+        if (field.size < 3 || field.size > 4) {
+            return false;
+        }
+        int value = 0;
+        for (size_t i = 0; i < field.size; ++i) {
+            unsigned digit = static_cast<unsigned>(field.data[i] - '0');
+            if (digit > 9) {
+                return false;
+            }
+            value = value * 10 + static_cast<int>(digit);
         }
-        while (!col.empty() && (col.front() == ' ' || col.front() == '\t')) {
-            col.erase(col.begin());
+        int day = value / 100;
+        int month = value % 100;
+        if (month < 1 || month > 12 || day < 1 || day > month_days[month]) {
+            return false;
         }
-        columns.push_back(normalize_column_name(col));
+        result.days = month_start[month] + day - 1;
+        return true;
     }
+};
+
+// ============================================================================
+// Section 6: Record loader
+// ============================================================================
+
+// Where the records of one file go
+struct ExtfLoadTarget {
+    std::string table_name;
+    std::vector<LogicalType> types;                  // all columns of the table
+    std::vector<ExtfColumn> columns;                 // conversion of each file column
+    std::vector<idx_t> file_columns;                 // table column of each file column
+    std::vector<std::pair<idx_t, Value>> constants;  // table columns with one value for the whole file
+    bool has_ordinal;                                // ordinal_column gets the record number
+    idx_t ordinal_column;
+
+    ExtfLoadTarget() : has_ordinal(false), ordinal_column(0) {}
+};
+
+// Values that didn't parse while loading a file
+struct ExtfLoadStats {
+    int64_t skipped_rows;  // records dropped for an invalid value in a strict column
+    int64_t null_values;   // invalid values in other columns, loaded as NULL
+
+    ExtfLoadStats() : skipped_rows(0), null_values(0) {}
+};
+
+// Stream the data records of an EXTF file into the target table as typed chunks via the Appender.
+// Constant columns (file name, header metadata, columns the file lacks) are constant vectors.
+// Records with a strict value (amount, Kurs, Belegdatum, master data key) that doesn't parse are
+// skipped and counted; the record ordinal still counts them, so it always matches the position
+// in the file. Other typed values that don't parse become NULL.
+static int64_t load_extf_records(Connection& conn, ExtfRecordReader& reader, const ExtfLoadTarget& target,
+                                 const ExtfHeader& header, const std::string& encoding, ExtfLoadStats& stats) {
+    const std::vector<ExtfColumn>& columns = target.columns;
+
+    DataChunk chunk;
+    chunk.Initialize(Allocator::DefaultAllocator(), target.types);
+    Appender appender(conn, target.table_name);
+
+    BelegdatumKernel belegdatum(header);
+    std::vector<FieldView> fields;
+    std::string converted;
+    int64_t row_count = 0;
+    int64_t ordinal = 0;
+    idx_t row = 0;
+    stats = ExtfLoadStats();
+
+    auto flush = [&]() {
+        if (row == 0) return;
+        for (const auto& constant : target.constants) {
+            chunk.data[constant.first].Reference(constant.second);
+        }
+        chunk.SetCardinality(row);
+        appender.AppendDataChunk(chunk);
+        chunk.Reset();
+        row = 0;
+    };
+
+    while (reader.Next(fields)) {
+        if (fields.size() == 1 && fields[0].size == 0) {
+            continue;  // blank line
+        }
+        ordinal++;
+
+        bool valid = true;
+        int64_t row_nulls = 0;
+        for (size_t col = 0; col < columns.size() && valid; ++col) {
+            const ExtfColumnKind kind = columns[col].kind;
+            Vector& vec = chunk.data[target.file_columns[col]];
+            FieldView field = col < fields.size() ? fields[col] : FieldView();
+            if (kind != ExtfColumnKind::TEXT) {
+                field = trim_field(field);
+            }
+            if (field.size == 0) {
+                FlatVector::SetNull(vec, row, true);
+                continue;
+            }
+            FlatVector::SetNull(vec, row, false);
+
+            bool parsed = true;
+            switch (kind) {
+            case ExtfColumnKind::BELEGDATUM:
+                parsed = belegdatum.Parse(field, FlatVector::GetData<date_t>(vec)[row]);
+                break;
+            case ExtfColumnKind::DATE:
+                parsed = parse_ddmmyyyy(field, FlatVector::GetData<date_t>(vec)[row]);
+                break;
+            case ExtfColumnKind::DECIMAL_2:
+                parsed = parse_german_decimal(field, 2, FlatVector::GetData<int64_t>(vec)[row]);
+                break;
+            case ExtfColumnKind::DECIMAL_6:
+                parsed = parse_german_decimal(field, 6, FlatVector::GetData<int64_t>(vec)[row]);
+                break;
+            case ExtfColumnKind::INTEGER:
+                parsed = parse_integer(field, FlatVector::GetData<int32_t>(vec)[row]);
+                break;
+            case ExtfColumnKind::FLAG:
+                parsed = parse_flag(field, FlatVector::GetData<bool>(vec)[row]);
+                break;
+            default:
+                if (encoding == "UTF-8" && is_valid_utf8(field.data, field.size)) {
+                    FlatVector::GetData<string_t>(vec)[row] = StringVector::AddString(vec, field.data, field.size);
+                } else {
+                    field_to_utf8(field.data, field.size, encoding, converted);
+                    FlatVector::GetData<string_t>(vec)[row] = StringVector::AddString(vec, converted);
+                }
+                break;
+            }
+            if (!parsed) {
+                if (columns[col].strict) {
+                    valid = false;
+                } else {
+                    FlatVector::SetNull(vec, row, true);
+                    row_nulls++;
+                }
+            }
+        }
+        if (!valid) {
+            stats.skipped_rows++;
+            continue;  // the row slot is overwritten by the next record
+        }
+        stats.null_values += row_nulls;
 
-    return columns;
+        if (target.has_ordinal) {
+            FlatVector::GetData<int64_t>(chunk.data[target.ordinal_column])[row] = ordinal;
+        }
+        row++;
+        row_count++;
+        if (row == STANDARD_VECTOR_SIZE) {
+            flush();
+        }
+    }
+    flush();
+    appender.Close();
+    if (!reader.Error().empty()) {
+        throw std::runtime_error(reader.Error());
+    }
+    return row_count;
 }
 
 // ============================================================================
-// Section 5: SQL builders
+// Section 7: Main function
 // ============================================================================
 
-// Returns SQL type based on normalized column name
-static std::string get_column_sql_type(const std::string& col_name) {
-    if (col_name == "belegdatum") {
-        return "DATE";
+static std::string format_status(const ExtfLoadStats& stats) {
+    std::vector<std::string> notes;
+    if (stats.skipped_rows > 0) {
+        notes.push_back(std::to_string(stats.skipped_rows) + " rows with invalid values skipped");
     }
-    if (col_name == "umsatz_ohne_soll_haben_kz") {
-        return "DECIMAL(18,2)";
+    if (stats.null_values > 0) {
+        notes.push_back(std::to_string(stats.null_values) + " invalid values set to NULL");
     }
-    if (col_name == "basis_umsatz") {
-        return "DECIMAL(18,2)";
+    std::string status = "OK";
+    for (size_t i = 0; i < notes.size(); ++i) {
+        status += (i == 0 ? " (" : ", ") + notes[i];
     }
-    if (col_name == "kurs") {
-        return "DECIMAL(18,6)";
+    if (!notes.empty()) {
+        status += ")";
     }
-    return "VARCHAR";
+    return status;
 }
 
-// Returns SQL expression for a column in the SELECT clause
-static std::string build_column_select_expr(const std::string& col_name, size_t col_index, int year) {
-    std::string col_ref = "column" + std::to_string(col_index);
+static Value header_date(int year, int month, int day) {
+    return year > 0 ? Value::DATE(Date::FromDate(year, month, day)) : Value(LogicalType::DATE);
+}
 
-    if (col_name == "belegdatum") {
-        // Belegdatum has compact DDMM format (e.g. "2001" = 20th Jan, "103" = 1st Mar)
-        // Extract month from last 2 chars, day from remaining leading chars
-        std::ostringstream ss;
-        ss << "CASE WHEN " << col_ref << " IS NOT NULL AND TRIM(" << col_ref << ") != '' THEN "
-           << "MAKE_DATE(" << year << ", "
-           << "CAST(RIGHT(TRIM(" << col_ref << "), 2) AS INTEGER), "
-           << "CAST(LEFT(TRIM(" << col_ref << "), LENGTH(TRIM(" << col_ref << ")) - 2) AS INTEGER)) "
-           << "ELSE NULL END";
-        return ss.str();
+static Value header_value(const std::string& text, const std::string& encoding) {
+    if (text.empty()) {
+        return Value(LogicalType::VARCHAR);
     }
+    std::string converted;
+    field_to_utf8(text.data(), text.size(), encoding, converted);
+    return Value(converted);
+}
 
-    if (col_name == "umsatz_ohne_soll_haben_kz" || col_name == "basis_umsatz") {
-        // German decimal format: dot = thousands separator, comma = decimal separator
-        std::ostringstream ss;
-        ss << "CASE WHEN " << col_ref << " IS NOT NULL AND TRIM(" << col_ref << ") != '' THEN "
-           << "CAST(REPLACE(REPLACE(TRIM(" << col_ref << "), '.', ''), ',', '.') AS DECIMAL(18,2)) "
-           << "ELSE NULL END";
-        return ss.str();
-    }
+// Journal columns taken from the header row, in table order after file_name and row_ordinal
+static const char* const JOURNAL_HEADER_COLUMNS[] = {
+    "stapel_datum_von", "stapel_datum_bis", "stapel_wj_beginn", "stapel_berater", "stapel_mandant",
+    "stapel_bezeichnung"};
+static const size_t JOURNAL_HEADER_COLUMN_COUNT = 6;
+
+static std::vector<Value> journal_header_values(const ExtfHeader& header, const std::string& encoding) {
+    std::vector<Value> values;
+    values.push_back(header_date(header.from_year, header.from_month, header.from_day));
+    values.push_back(header_date(header.to_year, header.to_month, header.to_day));
+    values.push_back(header_date(header.fy_year, header.fy_month, header.fy_day));
+    values.push_back(header_value(header.berater, encoding));
+    values.push_back(header_value(header.mandant, encoding));
+    values.push_back(header_value(header.bezeichnung, encoding));
+    return values;
+}
+
+// Table name for one file: the file name without .csv, subdirectory paths folded in
+// ("2024/EXTF_Buchungsstapel_01.csv" -> "2024_EXTF_Buchungsstapel_01")
+static std::string file_table_name(const std::string& filename) {
+    size_t last_dot = filename.find_last_of('.');
+    std::string table_name = (last_dot != std::string::npos) ? filename.substr(0, last_dot) : filename;
+    std::replace(table_name.begin(), table_name.end(), '/', '_');
+    return table_name;
+}
+
+// Header metadata of every loaded file, so batches can be filtered by Mandant or period
+// without reading the files again
+static const char* const HEADER_TABLE = "buchungsstapel_header";
+
+// Header of one loaded file, recorded after the import
+struct ExtfHeaderRecord {
+    std::string file_name;
+    std::string table_name;
+    ExtfHeader header;
+    std::string encoding;
+};
 
-    if (col_name == "kurs") {
-        // Same German decimal format but with higher precision
-        std::ostringstream ss;
-        ss << "CASE WHEN " << col_ref << " IS NOT NULL AND TRIM(" << col_ref << ") != '' THEN "
-           << "CAST(REPLACE(REPLACE(TRIM(" << col_ref << "), '.', ''), ',', '.') AS DECIMAL(18,6)) "
-           << "ELSE NULL END";
-        return ss.str();
+static bool ensure_header_table(Connection& conn, std::string& error) {
+    std::ostringstream sql;
+    sql << "CREATE TABLE IF NOT EXISTS " << HEADER_TABLE << " ("
+        << "folder VARCHAR, file_name VARCHAR, table_name VARCHAR, "
+        << "format_category INTEGER, format_name VARCHAR, format_version INTEGER, "
+        << "erzeugt_am TIMESTAMP, herkunft VARCHAR, exportiert_von VARCHAR, "
+        << "berater VARCHAR, mandant VARCHAR, wj_beginn DATE, sachkontenlaenge INTEGER, "
+        << "datum_von DATE, datum_bis DATE, bezeichnung VARCHAR, diktatkuerzel VARCHAR, "
+        << "buchungstyp INTEGER, festschreibung BOOLEAN, wkz VARCHAR, skr VARCHAR, "
+        << "imported_at TIMESTAMP, "
+        << "PRIMARY KEY (folder, file_name))";
+    auto result = conn.Query(sql.str());
+    if (result->HasError()) {
+        error = result->GetError();
+        return false;
     }
+    return true;
+}
 
-    // All other columns: pass-through
-    return col_ref;
+// SQL literals for header values; missing values become NULL
+static std::string header_sql_text(const std::string& text, const std::string& encoding) {
+    if (text.empty()) {
+        return "NULL";
+    }
+    std::string converted;
+    field_to_utf8(text.data(), text.size(), encoding, converted);
+    return "'" + escape_sql(converted) + "'";
 }
 
-// Build CREATE OR REPLACE TABLE statement with typed columns + file_name VARCHAR
-static std::string build_create_table_sql(const std::string& table_name, const std::vector<std::string>& columns) {
-    std::ostringstream sql;
-    sql << "CREATE OR REPLACE TABLE \"" << table_name << "\" (";
+static std::string header_sql_int(int value, bool valid) {
+    return valid ? std::to_string(value) : std::string("NULL");
+}
 
-    for (size_t i = 0; i < columns.size(); ++i) {
-        if (i > 0) sql << ", ";
-        sql << "\"" << escape_sql(columns[i]) << "\" " << get_column_sql_type(columns[i]);
+static std::string header_sql_date(int year, int month, int day) {
+    if (year == 0) {
+        return "NULL";
     }
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "DATE '%04d-%02d-%02d'", year, month, day);
+    return buffer;
+}
 
-    sql << ", \"file_name\" VARCHAR)";
-    return sql.str();
+// Erzeugt am: YYYYMMDDHHMMSS followed by milliseconds
+static std::string header_sql_timestamp(const std::string& created) {
+    if (created.size() < 14 || created.size() > 17 ||
+        created.find_first_not_of("0123456789") != std::string::npos) {
+        return "NULL";
+    }
+    int year = std::atoi(created.substr(0, 4).c_str());
+    int month = std::atoi(created.substr(4, 2).c_str());
+    int day = std::atoi(created.substr(6, 2).c_str());
+    int hour = std::atoi(created.substr(8, 2).c_str());
+    int minute = std::atoi(created.substr(10, 2).c_str());
+    int second = std::atoi(created.substr(12, 2).c_str());
+    if (!Date::IsValid(year, month, day) || hour > 23 || minute > 59 || second > 59) {
+        return "NULL";
+    }
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "TIMESTAMP '%04d-%02d-%02d %02d:%02d:%02d.%s'", year, month, day, hour, minute,
+             second, created.size() > 14 ? created.substr(14).c_str() : "0");
+    return buffer;
 }
 
-// Build INSERT INTO ... SELECT ... FROM read_csv(...) statement
-static std::string build_insert_sql(const std::string& table_name,
-                                     const std::vector<std::string>& columns,
-                                     const std::string& file_path,
-                                     const std::string& file_name,
-                                     int year,
-                                     const std::string& encoding,
-                                     bool ignore_errors) {
-    std::ostringstream sql;
+// Record the headers of the loaded files in one statement, keyed by folder and file name.
+// folder is the source URI for zip:// and webdav:// sources (see header_folder), whose local
+// copy changes from mount to mount.
+// replaced_table: a journal run first drops the rows of its previous run, so files that left
+// the folder don't linger.
+static void record_extf_headers(Connection& conn, const std::string& folder,
+                                const std::vector<ExtfHeaderRecord>& records,
+                                const std::string& replaced_table = "") {
+    std::string error;
+    if (!ensure_header_table(conn, error)) {
+        return;
+    }
+    if (!replaced_table.empty()) {
+        conn.Query(std::string("DELETE FROM ") + HEADER_TABLE + " WHERE folder = '" + escape_sql(folder) +
+                   "' AND table_name = '" + escape_sql(replaced_table) + "'");
+    }
+    if (records.empty()) {
+        return;
+    }
 
-    // INSERT INTO ... (columns..., file_name)
-    sql << "INSERT INTO \"" << table_name << "\" (";
-    for (size_t i = 0; i < columns.size(); ++i) {
+    std::ostringstream sql;
+    sql << "INSERT OR REPLACE INTO " << HEADER_TABLE << " VALUES ";
+    for (size_t i = 0; i < records.size(); ++i) {
+        const ExtfHeader& h = records[i].header;
+        const std::string& encoding = records[i].encoding;
         if (i > 0) sql << ", ";
-        sql << "\"" << escape_sql(columns[i]) << "\"";
+        sql << "("
+            << "'" << escape_sql(folder) << "', "
+            << "'" << escape_sql(records[i].file_name) << "', "
+            << "'" << escape_sql(records[i].table_name) << "', "
+            << h.category << ", "
+            << header_sql_text(h.format_name, encoding) << ", "
+            << header_sql_int(h.format_version, h.format_version > 0) << ", "
+            << header_sql_timestamp(h.created) << ", "
+            << header_sql_text(h.herkunft, encoding) << ", "
+            << header_sql_text(h.exportiert_von, encoding) << ", "
+            << header_sql_text(h.berater, encoding) << ", "
+            << header_sql_text(h.mandant, encoding) << ", "
+            << header_sql_date(h.fy_year, h.fy_month, h.fy_day) << ", "
+            << header_sql_int(h.sachkontenlaenge, h.sachkontenlaenge > 0) << ", "
+            << header_sql_date(h.from_year, h.from_month, h.from_day) << ", "
+            << header_sql_date(h.to_year, h.to_month, h.to_day) << ", "
+            << header_sql_text(h.bezeichnung, encoding) << ", "
+            << header_sql_text(h.diktatkuerzel, encoding) << ", "
+            << header_sql_int(h.buchungstyp, h.buchungstyp > 0) << ", "
+            << (h.festschreibung < 0 ? "NULL" : h.festschreibung == 1 ? "true" : "false") << ", "
+            << header_sql_text(h.wkz, encoding) << ", "
+            << header_sql_text(h.skr, encoding) << ", "
+            << "now()::TIMESTAMP)";
+    }
+    conn.Query(sql.str());
+}
+
+// One table per file (mode 'tables', and every file of read_datev_extf). The header of a
+// loaded file is added to headers.
+static BuchungsstapelImportResult import_extf_file(Connection& conn, const std::string& norm_folder,
+                                                   const std::string& filename,
+                                                   std::vector<ExtfHeaderRecord>& headers) {
+    BuchungsstapelImportResult result;
+    result.file_name = filename;
+    result.table_name = file_table_name(filename);
+
+    // Header, column row and data are read in one pass
+    ExtfRecordReader reader(join_path(norm_folder, filename));
+    ExtfHeader header;
+    std::vector<ExtfColumn> columns;
+    std::string encoding;
+    if (!open_extf_file(reader, header, columns, encoding, result.status)) {
+        return result;
     }
-    sql << ", \"file_name\") ";
+    result.format = describe_format(header, encoding);
 
-    // SELECT expressions..., filename literal
-    sql << "SELECT ";
+    ExtfLoadTarget target;
+    target.table_name = result.table_name;
+    target.columns = columns;
     for (size_t i = 0; i < columns.size(); ++i) {
-        if (i > 0) sql << ", ";
-        sql << build_column_select_expr(columns[i], i, year);
-    }
-    sql << ", '" << escape_sql(file_name) << "' AS \"file_name\" ";
-
-    // FROM read_csv(...)
-    sql << "FROM read_csv('" << escape_sql(file_path) << "', ";
-    sql << "skip=2, ";
-    sql << "delim=';', ";
-    sql << "quote='\"', ";
-    sql << "all_varchar=true, ";
-    sql << "auto_detect=false, ";
-    sql << "strict_mode=false, ";
-    sql << "null_padding=true, ";
-    sql << "encoding='" << encoding << "', ";
-    if (ignore_errors) {
-        sql << "ignore_errors=true, ";
-    }
-
-    // Column definitions: columns={'column0': 'VARCHAR', 'column1': 'VARCHAR', ...}
-    sql << "columns={";
-    for (size_t i = 0; i < columns.size(); ++i) {
-        if (i > 0) sql << ", ";
-        sql << "'column" << i << "': 'VARCHAR'";
+        target.types.push_back(get_column_type(columns[i].kind));
+        target.file_columns.push_back(i);
     }
-    sql << "})";
+    target.types.push_back(LogicalType::VARCHAR);
+    target.constants.push_back(std::make_pair(static_cast<idx_t>(columns.size()), Value(filename)));
+
+    // Build and execute CREATE TABLE
+    std::string create_sql = build_create_table_sql(result.table_name, columns);
+    try {
+        auto create_result = conn.Query(create_sql);
+        if (create_result->HasError()) {
+            result.status = "Create table failed: " + create_result->GetError();
+            return result;
+        }
+    } catch (const std::exception& e) {
+        result.status = std::string("Create table failed: ") + e.what();
+        return result;
+    }
+    bump_table_generation(conn, result.table_name);
+
+    try {
+        ExtfLoadStats stats;
+        result.row_count = load_extf_records(conn, reader, target, header, encoding, stats);
+        result.status = format_status(stats);
+
+        ExtfHeaderRecord record;
+        record.file_name = filename;
+        record.table_name = result.table_name;
+        record.header = header;
+        record.encoding = encoding;
+        headers.push_back(record);
+    } catch (const std::exception& e) {
+        // No table with the rows up to the failure: the file is loaded fully or not at all
+        conn.Query("DROP TABLE IF EXISTS \"" + result.table_name + "\"");
+        result.row_count = 0;
+        result.status = std::string("Load failed: ") + e.what();
+    }
+    return result;
+}
 
-    return sql.str();
+// All files into one journal table (mode 'journal'). The table has the union of the files'
+// columns (DATEV versions differ), then file_name, row_ordinal and the header metadata.
+// Headers are read first to build the schema; the files are then loaded concurrently, each
+// worker on its own connection and Appender. ORDER BY file_name, row_ordinal gives file order.
+static std::vector<BuchungsstapelImportResult> import_buchungsstapel_journal(
+    Connection& conn,
+    const std::string& norm_folder,
+    const std::string& header_folder,
+    const std::vector<std::string>& files,
+    const std::string& table_name) {
+
+    std::vector<BuchungsstapelImportResult> results(files.size());
+    std::vector<ExtfHeaderRecord> headers(files.size());  // file_name set once the file is loaded
+    std::vector<ExtfColumn> journal_columns;
+    std::map<std::string, idx_t> journal_index;
+
+    for (size_t i = 0; i < files.size(); ++i) {
+        results[i].table_name = table_name;
+        results[i].file_name = files[i];
+        ExtfRecordReader reader(join_path(norm_folder, files[i]));
+        ExtfHeader header;
+        std::vector<ExtfColumn> columns;
+        std::string encoding;
+        if (!open_extf_file(reader, header, columns, encoding, results[i].status)) {
+            continue;
+        }
+        results[i].format = describe_format(header, encoding);
+        for (const auto& col : columns) {
+            if (journal_index.find(col.name) == journal_index.end()) {
+                journal_index[col.name] = journal_columns.size();
+                journal_columns.push_back(col);
+            }
+        }
+    }
+    if (journal_columns.empty()) {
+        return results;  // every file failed to open
+    }
+
+    std::vector<LogicalType> types;
+    for (const auto& col : journal_columns) {
+        types.push_back(get_column_type(col.kind));
+    }
+    const idx_t file_name_column = types.size();
+    types.push_back(LogicalType::VARCHAR);
+    const idx_t ordinal_column = types.size();
+    types.push_back(LogicalType::BIGINT);
+
+    std::string extra_columns = ", \"row_ordinal\" BIGINT";
+    const idx_t header_column = types.size();
+    for (size_t h = 0; h < JOURNAL_HEADER_COLUMN_COUNT; ++h) {
+        bool is_date = h < 3;
+        extra_columns += std::string(", \"") + JOURNAL_HEADER_COLUMNS[h] + "\" " + (is_date ? "DATE" : "VARCHAR");
+        types.push_back(is_date ? LogicalType::DATE : LogicalType::VARCHAR);
+    }
+
+    auto create_result = conn.Query(build_create_table_sql(table_name, journal_columns, extra_columns));
+    if (create_result->HasError()) {
+        for (auto& r : results) {
+            if (r.status.empty()) {
+                r.status = "Create table failed: " + create_result->GetError();
+            }
+        }
+        return results;
+    }
+    bump_table_generation(conn, table_name);
+
+    auto load_file = [&](Connection& file_conn, size_t i) {
+        BuchungsstapelImportResult& result = results[i];
+        ExtfRecordReader reader(join_path(norm_folder, files[i]));
+        ExtfHeader header;
+        std::vector<ExtfColumn> columns;
+        std::string encoding;
+        if (!open_extf_file(reader, header, columns, encoding, result.status)) {
+            return;
+        }
+
+        ExtfLoadTarget target;
+        target.table_name = table_name;
+        target.types = types;
+        target.columns = columns;
+        std::vector<bool> present(journal_columns.size(), false);
+        for (const auto& col : columns) {
+            idx_t index = journal_index.find(col.name)->second;
+            // A file of another format category may type a column differently
+            if (get_column_type(col.kind) != types[index]) {
+                result.status = "Load failed: column '" + col.name + "' is " + get_column_type(col.kind).ToString() +
+                                " in this file but " + types[index].ToString() + " in the journal";
+                return;
+            }
+            target.file_columns.push_back(index);
+            present[index] = true;
+        }
+        for (size_t c = 0; c < journal_columns.size(); ++c) {
+            if (!present[c]) {
+                target.constants.push_back(std::make_pair(static_cast<idx_t>(c), Value(types[c])));
+            }
+        }
+        target.constants.push_back(std::make_pair(file_name_column, Value(files[i])));
+        std::vector<Value> header_values = journal_header_values(header, encoding);
+        for (size_t h = 0; h < header_values.size(); ++h) {
+            target.constants.push_back(std::make_pair(header_column + h, header_values[h]));
+        }
+        target.has_ordinal = true;
+        target.ordinal_column = ordinal_column;
+
+        try {
+            ExtfLoadStats stats;
+            result.row_count = load_extf_records(file_conn, reader, target, header, encoding, stats);
+            result.status = format_status(stats);
+            headers[i].file_name = files[i];
+            headers[i].table_name = table_name;
+            headers[i].header = header;
+            headers[i].encoding = encoding;
+        } catch (const std::exception& e) {
+            // Rows already flushed for this file are removed so the journal has it fully or not at all
+            file_conn.Query("DELETE FROM \"" + table_name + "\" WHERE \"file_name\" = '" + escape_sql(files[i]) + "'");
+            result.row_count = 0;
+            result.status = std::string("Load failed: ") + e.what();
+        }
+    };
+
+    size_t thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+    thread_count = std::min<size_t>(std::min<size_t>(thread_count, 8), files.size());
+    std::atomic<size_t> next_file(0);
+    std::mutex worker_error_lock;
+    std::string worker_error;
+    auto worker = [&]() {
+        try {
+            Connection file_conn(*conn.context->db);
+            for (size_t i = next_file++; i < files.size(); i = next_file++) {
+                if (results[i].status.empty()) {
+                    load_file(file_conn, i);
+                }
+            }
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(worker_error_lock);
+            worker_error = e.what();
+        }
+    };
+
+    if (thread_count <= 1) {
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (results[i].status.empty()) {
+                load_file(conn, i);
+            }
+        }
+    } else {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < thread_count; ++t) {
+            threads.push_back(std::thread(worker));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        // Files no worker got to (a worker could not open its connection)
+        for (auto& r : results) {
+            if (r.status.empty()) {
+                r.status = "Load failed: " + worker_error;
+            }
+        }
+    }
+
+    std::vector<ExtfHeaderRecord> loaded;
+    for (const auto& record : headers) {
+        if (!record.file_name.empty()) {
+            loaded.push_back(record);
+        }
+    }
+    record_extf_headers(conn, header_folder, loaded, table_name);
+    return results;
 }
 
-// ============================================================================
-// Section 6: Main function
-// ============================================================================
+// Folder the headers are recorded under: the source URI (password removed) for zip:// and
+// webdav:// sources, the normalized local folder otherwise
+static std::string header_folder(const std::string& folder_path, const SourceMount& mount,
+                                 const std::string& norm_folder) {
+    return is_source_uri(folder_path) ? mount.uri() : norm_folder;
+}
 
 std::vector<BuchungsstapelImportResult> import_buchungsstapel(
     Connection& conn,
-    const std::string& folder_path) {
+    const std::string& folder_path,
+    bool recursive,
+    const std::string& mode,
+    const std::string& table_name) {
 
     std::vector<BuchungsstapelImportResult> results;
 
+    std::string mode_lower = mode;
+    std::transform(mode_lower.begin(), mode_lower.end(), mode_lower.begin(), ::tolower);
+    if (mode_lower != "tables" && mode_lower != "journal") {
+        BuchungsstapelImportResult r;
+        r.table_name = "(error)";
+        r.status = "Unknown mode '" + mode + "' (expected 'tables' or 'journal')";
+        results.push_back(r);
+        return results;
+    }
+
+    // zip:// and webdav:// sources are read from a local copy
+    SourceMount mount(folder_path, recursive);
+    if (!mount.ok()) {
+        BuchungsstapelImportResult r;
+        r.table_name = "(source)";
+        r.status = mount.error();
+        results.push_back(r);
+        return results;
+    }
+
     // Normalize the folder path
-    std::string norm_folder = normalize_path(folder_path);
+    std::string norm_folder = normalize_path(mount.local_path());
 
     // Get matching files
-    std::vector<std::string> files = get_matching_buchungsstapel_files(norm_folder);
+    std::vector<std::string> files = get_matching_extf_files(norm_folder, recursive, is_buchungsstapel_file);
 
     if (files.empty()) {
         BuchungsstapelImportResult r;
@@ -481,145 +1564,51 @@ std::vector<BuchungsstapelImportResult> import_buchungsstapel(
         return results;
     }
 
+    if (mode_lower == "journal") {
+        return import_buchungsstapel_journal(conn, norm_folder, header_folder(folder_path, mount, norm_folder), files,
+                                             table_name.empty() ? std::string("buchungsstapel") : table_name);
+    }
+
     // Process each file
+    std::vector<ExtfHeaderRecord> headers;
     for (const auto& filename : files) {
-        BuchungsstapelImportResult result;
-        result.file_name = filename;
-
-        // Derive table name from filename (remove .csv extension)
-        size_t last_dot = filename.find_last_of('.');
-        std::string table_name = (last_dot != std::string::npos)
-            ? filename.substr(0, last_dot)
-            : filename;
-        result.table_name = table_name;
-
-        std::string file_path = join_path(norm_folder, filename);
-
-        // Parse header -> get year
-        int year = parse_buchungsstapel_header(file_path);
-        if (year < 0) {
-            result.row_count = 0;
-            result.status = "Failed to parse header (could not extract year from Datum-von field)";
-            results.push_back(result);
-            continue;
-        }
-
-        // Parse column names
-        std::vector<std::string> columns = parse_buchungsstapel_columns(file_path);
-        if (columns.empty()) {
-            result.row_count = 0;
-            result.status = "Failed to parse column names from row 2";
-            results.push_back(result);
-            continue;
-        }
-
-        // Build and execute CREATE TABLE
-        std::string create_sql = build_create_table_sql(table_name, columns);
-        try {
-            auto create_result = conn.Query(create_sql);
-            if (create_result->HasError()) {
-                result.row_count = 0;
-                result.status = "Create table failed: " + create_result->GetError();
-                results.push_back(result);
-                continue;
-            }
-        } catch (const std::exception& e) {
-            result.row_count = 0;
-            result.status = std::string("Create table failed: ") + e.what();
-            results.push_back(result);
-            continue;
-        }
-
-        // Try encoding fallback loop
-        std::vector<std::string> encodings_to_try = {
-            "CP1250",
-            "UTF-8",
-            "ISO-8859-1",
-            "Windows-1252",
-            "CP850"
-        };
-
-        bool success = false;
-        std::string load_error;
-
-        // First pass: try each encoding without ignore_errors
-        for (const auto& encoding : encodings_to_try) {
-            std::string insert_sql = build_insert_sql(table_name, columns, file_path, filename, year, encoding, false);
-
-            try {
-                auto query_result = conn.Query(insert_sql);
-                if (!query_result->HasError()) {
-                    success = true;
-                    break;
-                }
-                // If error contains encoding info, try next encoding
-                std::string error = query_result->GetError();
-                if (error.find("unicode") != std::string::npos ||
-                    error.find("encoding") != std::string::npos ||
-                    error.find("utf") != std::string::npos) {
-                    continue;  // Try next encoding
-                }
-                // Other error, stop trying
-                load_error = error;
-                break;
-            } catch (const std::exception& e) {
-                std::string error = e.what();
-                if (error.find("unicode") != std::string::npos ||
-                    error.find("encoding") != std::string::npos ||
-                    error.find("utf") != std::string::npos) {
-                    continue;  // Try next encoding
-                }
-                // Other error
-                load_error = error;
-                break;
-            }
-        }
-
-        // Second pass: if all failed, retry same encodings with ignore_errors=true
-        if (!success) {
-            // Clear the table before retrying (it may have partial data from failed attempts)
-            conn.Query("DELETE FROM \"" + table_name + "\"");
-
-            for (const auto& encoding : encodings_to_try) {
-                std::string insert_sql = build_insert_sql(table_name, columns, file_path, filename, year, encoding, true);
+        results.push_back(import_extf_file(conn, norm_folder, filename, headers));
+    }
+    record_extf_headers(conn, header_folder(folder_path, mount, norm_folder), headers);
 
-                try {
-                    auto query_result = conn.Query(insert_sql);
-                    if (!query_result->HasError()) {
-                        success = true;
-                        break;
-                    }
-                } catch (const std::exception& e) {
-                    // Try next encoding
-                    continue;
-                }
-            }
+    return results;
+}
 
-            if (!success && load_error.empty()) {
-                load_error = "Could not read file with any encoding";
-            }
-        }
+std::vector<BuchungsstapelImportResult> import_datev_extf(
+    Connection& conn,
+    const std::string& folder_path,
+    bool recursive) {
 
-        if (success) {
-            try {
-                // Get row count
-                auto count_result = conn.Query("SELECT COUNT(*) FROM \"" + table_name + "\"");
-                if (!count_result->HasError() && count_result->RowCount() > 0) {
-                    result.row_count = count_result->GetValue(0, 0).GetValue<int64_t>();
-                }
-                result.status = "OK";
-            } catch (const std::exception& e) {
-                result.row_count = 0;
-                result.status = std::string("Load failed: ") + e.what();
-            }
-        } else {
-            result.row_count = 0;
-            result.status = "Load failed: " + load_error;
-        }
+    std::vector<BuchungsstapelImportResult> results;
+    SourceMount mount(folder_path, recursive);
+    if (!mount.ok()) {
+        BuchungsstapelImportResult r;
+        r.table_name = "(source)";
+        r.status = mount.error();
+        results.push_back(r);
+        return results;
+    }
+    std::string norm_folder = normalize_path(mount.local_path());
+    std::vector<std::string> files = get_matching_extf_files(norm_folder, recursive, is_extf_file);
 
-        results.push_back(result);
+    if (files.empty()) {
+        BuchungsstapelImportResult r;
+        r.table_name = "(no files)";
+        r.status = "No DATEV files found (expected EXTF_*.csv)";
+        results.push_back(r);
+        return results;
     }
 
+    std::vector<ExtfHeaderRecord> headers;
+    for (const auto& filename : files) {
+        results.push_back(import_extf_file(conn, norm_folder, filename, headers));
+    }
+    record_extf_headers(conn, header_folder(folder_path, mount, norm_folder), headers);
     return results;
 }
 
@@ -0,0 +1,517 @@
+#include "data_source.hpp"
+#include "directory_walker.hpp"
+#include "webdav_client.hpp"
+#include "zip_extractor.hpp"
+#include "miniz.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <sys/types.h>
+#include <sys/utime.h>
+#define MKDIR(path) _mkdir(path)
+#define utime _utime
+#define utimbuf _utimbuf
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <utime.h>
+#define MKDIR(path) mkdir(path, 0755)
+#endif
+
+namespace duckdb {
+
+// Parallel downloads when a WebDAV folder is mirrored
+static const size_t MIRROR_CONNECTIONS = 4;
+
+// Sidecar file of a WebDAV mirror with the ETag of every mirrored file ("<etag>\t<path>" lines);
+// hidden, so walk_directory() and the importers don't see it
+static const char* MIRROR_ETAGS_FILE = ".gdpdu_etags";
+
+// Path helper: normalize Windows/Unix paths
+static std::string normalize_path(const std::string& path) {
+    std::string result = path;
+    std::replace(result.begin(), result.end(), '\\', '/');
+    return result;
+}
+
+// Path helper: join directory and filename
+static std::string join_path(const std::string& dir, const std::string& file) {
+    if (dir.empty()) return file;
+    if (dir.back() == '/' || dir.back() == '\\') return dir + file;
+    return dir + "/" + file;
+}
+
+// Relative paths passed to a source must stay below its root
+static bool is_safe_relative_path(const std::string& path) {
+    std::string norm = "/" + normalize_path(path) + "/";
+    return !path.empty() && path[0] != '/' && norm.find("/../") == std::string::npos;
+}
+
+// Create a directory and all missing parents
+static void create_directories(const std::string& dir_path) {
+    std::string path = normalize_path(dir_path);
+    size_t pos = 0;
+    while ((pos = path.find('/', pos + 1)) != std::string::npos) {
+        MKDIR(path.substr(0, pos).c_str());  // Ignore errors - directory may already exist
+    }
+    MKDIR(path.c_str());
+}
+
+// Folder part of a relative path ("2024/01/a.csv" -> "2024/01", "a.csv" -> "")
+static std::string parent_path(const std::string& path) {
+    size_t slash = path.rfind('/');
+    return slash == std::string::npos ? "" : path.substr(0, slash);
+}
+
+// URL percent-decode (user name and password in a URI)
+static std::string percent_decode(const std::string& encoded) {
+    std::string result;
+    for (size_t i = 0; i < encoded.size(); ++i) {
+        if (encoded[i] == '%' && i + 2 < encoded.size() && isxdigit(static_cast<unsigned char>(encoded[i + 1])) &&
+            isxdigit(static_cast<unsigned char>(encoded[i + 2]))) {
+            result += static_cast<char>(std::stoi(encoded.substr(i + 1, 2), nullptr, 16));
+            i += 2;
+        } else {
+            result += encoded[i];
+        }
+    }
+    return result;
+}
+
+// Lowercase scheme of a source URI ("zip" for "zip:///a.zip"), empty for a plain path
+static std::string uri_scheme(const std::string& uri) {
+    size_t colon = uri.find("://");
+    if (colon == std::string::npos || colon == 0) {
+        return "";
+    }
+    std::string scheme = uri.substr(0, colon);
+    for (auto& c : scheme) {
+        if (!isalpha(static_cast<unsigned char>(c))) {
+            return "";
+        }
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    if (scheme == "file" || scheme == "zip" || scheme == "webdav" || scheme == "webdavs" || scheme == "http" ||
+        scheme == "https") {
+        return scheme;
+    }
+    return "";
+}
+
+bool is_source_uri(const std::string& path) {
+    return !uri_scheme(path).empty();
+}
+
+// ============================================================================
+// Local folder
+// ============================================================================
+
+class LocalDataSource : public DataSource {
+public:
+    LocalDataSource(const std::string& uri, const std::string& root) : uri_(uri), root_(normalize_path(root)) {}
+
+    std::string uri() const override { return uri_; }
+
+    bool materialize(bool, std::string& local_dir, bool& temporary, std::string&) override {
+        local_dir = root_;
+        temporary = false;
+        return true;
+    }
+
+private:
+    std::string uri_;
+    std::string root_;
+};
+
+// ============================================================================
+// Zip archive
+// ============================================================================
+
+// An opened zip archive with its own file handle; entries are decompressed straight from the file
+class ZipReader {
+public:
+    // Receives an entry's data chunk by chunk; return false to stop
+    typedef std::function<bool(const char* data, size_t size)> ChunkCallback;
+
+    explicit ZipReader(const std::string& zip_path) : file_(zip_path, std::ios::binary) {
+        open_ = init_zip_file_reader(zip_, file_);
+    }
+
+    ~ZipReader() {
+        if (open_) {
+            duckdb_miniz::mz_zip_reader_end(&zip_);
+        }
+    }
+
+    bool is_open() const { return open_; }
+    duckdb_miniz::mz_zip_archive* archive() { return &zip_; }
+
+    // Index of a file entry, -1 if there is none
+    int locate(const std::string& name) {
+        return duckdb_miniz::mz_zip_reader_locate_file(&zip_, name.c_str(), nullptr, 0);
+    }
+
+    // Decompress an entry chunk by chunk
+    bool extract(int index, const ChunkCallback& on_data) {
+        return duckdb_miniz::mz_zip_reader_extract_to_callback(&zip_, static_cast<duckdb_miniz::mz_uint>(index),
+                                                               write_chunk, const_cast<ChunkCallback*>(&on_data),
+                                                               0) != 0;
+    }
+
+private:
+    static size_t write_chunk(void* opaque, duckdb_miniz::mz_uint64, const void* data, size_t n) {
+        const ChunkCallback& on_data = *static_cast<const ChunkCallback*>(opaque);
+        // A short count makes miniz stop extracting
+        return on_data(static_cast<const char*>(data), n) ? n : 0;
+    }
+
+    ZipReader(const ZipReader&);
+    ZipReader& operator=(const ZipReader&);
+
+    std::ifstream file_;
+    duckdb_miniz::mz_zip_archive zip_;
+    bool open_;
+};
+
+class ZipDataSource : public DataSource {
+public:
+    // folder: path inside the archive the source is rooted at, empty or ending with '/'
+    ZipDataSource(const std::string& uri, const std::string& zip_path, const std::string& folder)
+        : uri_(uri), zip_path_(zip_path), folder_(folder), zip_mtime_(-1) {}
+
+    // Read the central directory once; all entries share the archive's modification time
+    bool open(std::string& error) {
+        DirectoryEntry archive;
+        if (!stat_file(zip_path_, archive)) {
+            error = "Zip archive not found: " + zip_path_;
+            return false;
+        }
+        zip_mtime_ = archive.mtime;
+        ZipReader reader(zip_path_);
+        if (!reader.is_open()) {
+            error = "Not a valid zip archive: " + zip_path_;
+            return false;
+        }
+        duckdb_miniz::mz_uint count = duckdb_miniz::mz_zip_reader_get_num_files(reader.archive());
+        for (duckdb_miniz::mz_uint i = 0; i < count; ++i) {
+            duckdb_miniz::mz_zip_archive_file_stat file_stat;
+            if (duckdb_miniz::mz_zip_reader_is_file_a_directory(reader.archive(), i) ||
+                !duckdb_miniz::mz_zip_reader_file_stat(reader.archive(), i, &file_stat)) {
+                continue;
+            }
+            // Entries outside the folder, or that would escape it when extracted, are left out
+            std::string name = normalize_path(file_stat.m_filename);
+            if (name.compare(0, folder_.size(), folder_) != 0 || !is_safe_relative_path(name.substr(folder_.size()))) {
+                continue;
+            }
+            entries_[name.substr(folder_.size())] = file_stat.m_filename;
+        }
+        return true;
+    }
+
+    std::string uri() const override { return uri_; }
+
+    // Extract into a new folder of its own (mounts of the same URI running at the same time never
+    // share one), with the archive's modification time on every file
+    bool materialize(bool, std::string& local_dir, bool& temporary, std::string& error) override {
+        local_dir = create_temp_download_dir();
+        if (local_dir.empty()) {
+            error = "Failed to create extraction directory for " + zip_path_;
+            return false;
+        }
+        temporary = true;
+
+        ZipReader reader(zip_path_);
+        if (!reader.is_open()) {
+            error = "Not a valid zip archive: " + zip_path_;
+            return false;
+        }
+        for (const auto& entry : entries_) {
+            std::string output_path = join_path(local_dir, entry.first);
+            create_directories(join_path(local_dir, parent_path(entry.first)));
+            std::ofstream out(output_path, std::ios::binary);
+            bool extracted = out && reader.extract(reader.locate(entry.second), [&](const char* data, size_t size) {
+                return !!out.write(data, static_cast<std::streamsize>(size));
+            });
+            out.close();
+            if (!extracted || !out) {
+                error = "Failed to extract " + entry.first + " from " + zip_path_;
+                return false;
+            }
+            if (zip_mtime_ >= 0) {
+                struct utimbuf times;
+                times.actime = static_cast<time_t>(zip_mtime_);
+                times.modtime = static_cast<time_t>(zip_mtime_);
+                utime(output_path.c_str(), &times);
+            }
+        }
+        return true;
+    }
+
+private:
+    std::string uri_;
+    std::string zip_path_;
+    std::string folder_;
+    int64_t zip_mtime_;
+    std::map<std::string, std::string> entries_;  // path below folder_ -> entry name in the archive
+};
+
+// ============================================================================
+// WebDAV folder
+// ============================================================================
+
+// One mutex per mirror folder (url_directory_name): mounts of the same URL in this process take
+// turns, so they never download into the same .part files or rewrite the ETag file together
+static std::mutex& mirror_mutex(const std::string& url) {
+    static std::mutex registry_lock;
+    static std::map<std::string, std::unique_ptr<std::mutex>> mutexes;
+    std::lock_guard<std::mutex> guard(registry_lock);
+    std::unique_ptr<std::mutex>& mutex = mutexes[url_directory_name(url)];
+    if (!mutex) {
+        mutex.reset(new std::mutex());
+    }
+    return *mutex;
+}
+
+class WebDavDataSource : public DataSource {
+public:
+    WebDavDataSource(const std::string& uri, const std::string& url, const std::string& username,
+                     const std::string& password)
+        : uri_(uri), url_(url), client_(url, username, password, MIRROR_CONNECTIONS) {}
+
+    std::string uri() const override { return uri_; }
+
+    // Mirror into the download folder of the URL; only new or changed files are fetched. The mirror
+    // stays locked until this source is destroyed, so no other mount changes it while it is read.
+    bool materialize(bool recursive, std::string& local_dir, bool& temporary, std::string& error) override {
+        mirror_lock_ = std::unique_lock<std::mutex>(mirror_mutex(url_));
+        temporary = false;
+        std::string download_dir = get_download_dir(url_);
+        if (download_dir.empty()) {
+            error = "Failed to create download directory for " + uri_;
+            return false;
+        }
+        local_dir = download_dir + "/mirror";
+        create_directories(local_dir);
+
+        std::vector<WebDavFile> files;
+        if (!list_files(recursive, files, error)) {
+            return false;
+        }
+
+        // ETags of the previous mirror
+        std::map<std::string, std::string> mirrored;
+        std::string etags_path = join_path(local_dir, MIRROR_ETAGS_FILE);
+        std::ifstream etags_in(etags_path);
+        std::string line;
+        while (std::getline(etags_in, line)) {
+            size_t tab = line.find('\t');
+            if (tab != std::string::npos) {
+                mirrored[line.substr(tab + 1)] = line.substr(0, tab);
+            }
+        }
+        etags_in.close();
+
+        std::vector<size_t> fetch;
+        std::set<std::string> listed;
+        for (size_t i = 0; i < files.size(); ++i) {
+            const WebDavFile& file = files[i];
+            if (!is_safe_relative_path(file.path)) {
+                continue;
+            }
+            listed.insert(file.path);
+            DirectoryEntry local;
+            auto known = mirrored.find(file.path);
+            bool current = stat_file(join_path(local_dir, file.path), local) && known != mirrored.end() &&
+                           !file.etag.empty() && known->second == file.etag && (file.size < 0 || local.size == file.size);
+            if (!current) {
+                fetch.push_back(i);
+            }
+        }
+
+        // Parallel downloads; each resumes a part file an interrupted mount left behind
+        std::atomic<size_t> next(0);
+        std::mutex error_lock;
+        std::string first_error;
+        std::vector<std::thread> workers;
+        size_t worker_count = std::min(MIRROR_CONNECTIONS, fetch.size());
+        for (size_t w = 0; w < worker_count; ++w) {
+            workers.push_back(std::thread([&]() {
+                for (size_t i = next++; i < fetch.size(); i = next++) {
+                    const WebDavFile& file = files[fetch[i]];
+                    std::string dir = join_path(local_dir, parent_path(file.path));
+                    create_directories(dir);
+                    auto dl = client_.download_file(file.href, dir, file.size, file.etag);
+                    if (!dl.success) {
+                        std::lock_guard<std::mutex> guard(error_lock);
+                        if (first_error.empty()) {
+                            first_error = dl.error_message;
+                        }
+                    }
+                }
+            }));
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        if (!first_error.empty()) {
+            error = first_error;
+            return false;
+        }
+
+        // Files deleted on the server leave the mirror too (only those in the listed scope)
+        DirectoryWalkOptions options;
+        options.recursive = recursive;
+        for (const auto& local : walk_directory(local_dir, options)) {
+            if (!listed.count(local.relative_path)) {
+                remove(join_path(local_dir, local.relative_path).c_str());
+            }
+        }
+
+        std::ofstream etags_out(etags_path, std::ios::trunc);
+        for (const auto& file : files) {
+            if (listed.count(file.path) && !file.etag.empty()) {
+                etags_out << file.etag << '\t' << file.path << '\n';
+            }
+        }
+        if (!recursive) {
+            // Keep the ETags of subfolder files mirrored by an earlier recursive mount
+            for (const auto& known : mirrored) {
+                if (known.first.find('/') != std::string::npos) {
+                    etags_out << known.second << '\t' << known.first << '\n';
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    // Files (not folders) of the listing
+    bool list_files(bool recursive, std::vector<WebDavFile>& files, std::string& error) {
+        WebDavResult listing = client_.list_files(false, recursive);
+        if (!listing.success) {
+            error = listing.error_message;
+            return false;
+        }
+        files.clear();
+        for (const auto& file : listing.files) {
+            if (!file.is_collection) {
+                files.push_back(file);
+            }
+        }
+        return true;
+    }
+
+    std::string uri_;
+    std::string url_;  // http(s) URL without credentials
+    WebDavClient client_;
+    std::unique_lock<std::mutex> mirror_lock_;  // held from materialize() on
+};
+
+// ============================================================================
+// URIs
+// ============================================================================
+
+std::unique_ptr<DataSource> open_data_source(const std::string& uri, std::string& error) {
+    std::string scheme = uri_scheme(uri);
+    std::string rest = scheme.empty() ? uri : uri.substr(scheme.size() + 3);
+
+    if (scheme.empty() || scheme == "file") {
+        if (rest.empty()) {
+            error = "Empty path in " + uri;
+            return nullptr;
+        }
+        return std::unique_ptr<DataSource>(new LocalDataSource(uri, rest));
+    }
+
+    if (scheme == "zip") {
+        // zip://<archive>[!<folder inside>]
+        size_t bang = rest.find('!');
+        std::string zip_path = rest.substr(0, bang);
+        std::string folder = bang == std::string::npos ? "" : normalize_path(rest.substr(bang + 1));
+        while (!folder.empty() && folder[0] == '/') {
+            folder.erase(0, 1);
+        }
+        if (!folder.empty() && folder.back() != '/') {
+            folder += '/';
+        }
+        if (zip_path.empty() || (!folder.empty() && !is_safe_relative_path(folder))) {
+            error = "Invalid zip URI (expected zip://<archive>[!<folder>]): " + uri;
+            return nullptr;
+        }
+        std::unique_ptr<ZipDataSource> source(new ZipDataSource(uri, zip_path, folder));
+        if (!source->open(error)) {
+            return nullptr;
+        }
+        return std::unique_ptr<DataSource>(source.release());
+    }
+
+    // webdav[s]://[user[:password]@]host[:port]/path, http(s):// alike
+    std::string protocol = (scheme == "webdavs" || scheme == "https") ? "https" : "http";
+    size_t path_start = rest.find('/');
+    std::string authority = rest.substr(0, path_start);
+    std::string path = path_start == std::string::npos ? "/" : rest.substr(path_start);
+    std::string username;
+    std::string password;
+    size_t at = authority.rfind('@');
+    if (at != std::string::npos) {
+        std::string userinfo = authority.substr(0, at);
+        authority = authority.substr(at + 1);
+        size_t colon = userinfo.find(':');
+        username = percent_decode(userinfo.substr(0, colon));
+        if (colon != std::string::npos) {
+            password = percent_decode(userinfo.substr(colon + 1));
+        }
+    }
+    if (authority.empty()) {
+        error = "Invalid WebDAV URI (expected " + scheme + "://user:password@host/path): host missing";
+        return nullptr;
+    }
+    std::string url = protocol + "://" + authority + path;
+    std::string redacted = scheme + "://" + (username.empty() ? "" : username + "@") + authority + path;
+    return std::unique_ptr<DataSource>(new WebDavDataSource(redacted, url, username, password));
+}
+
+SourceMount::SourceMount(const std::string& uri, bool recursive) : temporary_(false) {
+    if (!is_source_uri(uri)) {
+        local_path_ = uri;
+        uri_ = uri;
+        return;
+    }
+    std::string error;
+    source_ = open_data_source(uri, error);
+    if (source_) {
+        uri_ = source_->uri();
+    }
+    if (!source_ || !source_->materialize(recursive, local_path_, temporary_, error)) {
+        error_ = "Failed to open " + (source_ ? source_->uri() : std::string("source")) + ": " + error;
+        if (temporary_ && !local_path_.empty()) {
+            cleanup_temp_dir(local_path_);
+        }
+        local_path_.clear();
+        temporary_ = false;
+        source_.reset();
+    }
+}
+
+SourceMount::~SourceMount() {
+    if (temporary_ && !local_path_.empty()) {
+        cleanup_temp_dir(local_path_);
+    }
+}
+
+} // namespace duckdb
@@ -0,0 +1,456 @@
+#include "directory_walker.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <fileapi.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace duckdb {
+
+// ============================================================================
+// Glob matching
+// ============================================================================
+
+static bool chars_equal_ignore_case(char a, char b) {
+    return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+}
+
+// Match a [...] class starting at pattern[p] (pointing at '['). On success sets
+// class_end to the index after ']' and matched to whether c is in the class.
+static bool match_char_class(const std::string& pattern, size_t p, char c, size_t& class_end, bool& matched) {
+    size_t i = p + 1;
+    bool negate = false;
+    if (i < pattern.size() && (pattern[i] == '!' || pattern[i] == '^')) {
+        negate = true;
+        i++;
+    }
+    bool found = false;
+    bool first = true;
+    unsigned char lc = static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)));
+    while (i < pattern.size() && (first || pattern[i] != ']')) {
+        first = false;
+        unsigned char lo = static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(pattern[i])));
+        unsigned char hi = lo;
+        if (i + 2 < pattern.size() && pattern[i + 1] == '-' && pattern[i + 2] != ']') {
+            hi = static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(pattern[i + 2])));
+            i += 2;
+        }
+        if (lc >= lo && lc <= hi) {
+            found = true;
+        }
+        i++;
+    }
+    if (i >= pattern.size()) {
+        return false;  // unterminated class: treat '[' literally
+    }
+    class_end = i + 1;
+    matched = (found != negate);
+    return true;
+}
+
+static bool glob_match_at(const std::string& pattern, size_t p, const std::string& text, size_t t) {
+    while (p < pattern.size()) {
+        char pc = pattern[p];
+        if (pc == '*') {
+            bool any_depth = (p + 1 < pattern.size() && pattern[p + 1] == '*');
+            size_t next = p + (any_depth ? 2 : 1);
+            // "**/" also matches zero directories
+            if (any_depth && next < pattern.size() && pattern[next] == '/' &&
+                glob_match_at(pattern, next + 1, text, t)) {
+                return true;
+            }
+            for (size_t k = t; k <= text.size(); ++k) {
+                if (glob_match_at(pattern, next, text, k)) {
+                    return true;
+                }
+                if (k < text.size() && text[k] == '/' && !any_depth) {
+                    break;
+                }
+            }
+            return false;
+        }
+        if (t >= text.size()) {
+            return false;
+        }
+        if (pc == '?') {
+            if (text[t] == '/') return false;
+            p++;
+            t++;
+            continue;
+        }
+        if (pc == '[') {
+            size_t class_end = 0;
+            bool matched = false;
+            if (match_char_class(pattern, p, text[t], class_end, matched)) {
+                if (!matched || text[t] == '/') return false;
+                p = class_end;
+                t++;
+                continue;
+            }
+        }
+        if (!chars_equal_ignore_case(pc, text[t])) {
+            return false;
+        }
+        p++;
+        t++;
+    }
+    return t == text.size();
+}
+
+bool glob_match(const std::string& pattern, const std::string& relative_path) {
+    if (pattern.find('/') == std::string::npos) {
+        size_t last_slash = relative_path.find_last_of('/');
+        std::string name = (last_slash != std::string::npos) ? relative_path.substr(last_slash + 1) : relative_path;
+        return glob_match_at(pattern, 0, name, 0);
+    }
+    return glob_match_at(pattern, 0, relative_path, 0);
+}
+
+std::vector<std::string> split_glob_list(const std::string& list) {
+    std::vector<std::string> patterns;
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) {
+            comma = list.size();
+        }
+        std::string item = list.substr(start, comma - start);
+        size_t b = item.find_first_not_of(" \t");
+        size_t e = item.find_last_not_of(" \t");
+        if (b != std::string::npos) {
+            patterns.push_back(item.substr(b, e - b + 1));
+        }
+        start = comma + 1;
+    }
+    return patterns;
+}
+
+// ============================================================================
+// Directory scanning
+// ============================================================================
+
+static bool matches_any(const std::vector<std::string>& globs, const std::string& relative_path) {
+    for (const auto& g : globs) {
+        if (glob_match(g, relative_path)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static std::string join_relative(const std::string& dir, const std::string& name) {
+    return dir.empty() ? name : dir + "/" + name;
+}
+
+// Filters that depend only on the path (checked before any stat)
+static bool passes_name_filters(const DirectoryWalkOptions& options, const std::string& name, const std::string& rel) {
+    if (options.name_filter && !options.name_filter(name)) {
+        return false;
+    }
+    if (!options.include_globs.empty() && !matches_any(options.include_globs, rel)) {
+        return false;
+    }
+    if (matches_any(options.exclude_globs, rel)) {
+        return false;
+    }
+    return true;
+}
+
+static bool needs_stat(const DirectoryWalkOptions& options) {
+    return options.need_stat || options.min_size >= 0 || options.max_size >= 0 ||
+           options.min_mtime >= 0 || options.max_mtime >= 0;
+}
+
+static bool passes_stat_filters(const DirectoryWalkOptions& options, const DirectoryEntry& entry) {
+    if (options.min_size >= 0 && entry.size < options.min_size) return false;
+    if (options.max_size >= 0 && entry.size > options.max_size) return false;
+    if (options.min_mtime >= 0 && entry.mtime < options.min_mtime) return false;
+    if (options.max_mtime >= 0 && entry.mtime > options.max_mtime) return false;
+    return true;
+}
+
+#ifdef _WIN32
+static std::wstring utf8_to_wide(const std::string& utf8) {
+    if (utf8.empty()) return std::wstring();
+    int size_needed = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), (int)utf8.size(), NULL, 0);
+    if (size_needed <= 0) return std::wstring();
+    std::wstring result(size_needed, 0);
+    MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), (int)utf8.size(), &result[0], size_needed);
+    return result;
+}
+
+static std::string wide_to_utf8(const std::wstring& wide) {
+    if (wide.empty()) return std::string();
+    int size_needed = WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), (int)wide.size(), NULL, 0, NULL, NULL);
+    if (size_needed <= 0) return std::string();
+    std::string result(size_needed, 0);
+    WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), (int)wide.size(), &result[0], size_needed, NULL, NULL);
+    return result;
+}
+#endif
+
+// Scan one directory (relative to root). Appends matching files to files and
+// subdirectories to descend into to subdirs.
+static void scan_one_directory(const std::string& root, const std::string& rel_dir, const DirectoryWalkOptions& options,
+                               std::vector<DirectoryEntry>& files, std::vector<std::string>& subdirs) {
+    std::string full_dir = rel_dir.empty() ? root : root + "/" + rel_dir;
+    bool want_stat = needs_stat(options);
+
+#ifdef _WIN32
+    // FindFirstFileW already returns attributes, size and mtime: no stat needed
+    std::wstring wide_search = utf8_to_wide(full_dir + "/*");
+    WIN32_FIND_DATAW find_data;
+    HANDLE find_handle = FindFirstFileW(wide_search.c_str(), &find_data);
+    if (find_handle == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    do {
+        std::string name = wide_to_utf8(find_data.cFileName);
+        if (name.empty() || name[0] == '.') {
+            continue;
+        }
+        std::string rel = join_relative(rel_dir, name);
+
+        if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            if (options.recursive && !matches_any(options.exclude_globs, rel)) {
+                subdirs.push_back(rel);
+            }
+            continue;
+        }
+        if (!passes_name_filters(options, name, rel)) {
+            continue;
+        }
+
+        DirectoryEntry entry;
+        entry.relative_path = rel;
+        entry.name = name;
+        entry.size = (static_cast<int64_t>(find_data.nFileSizeHigh) << 32) | find_data.nFileSizeLow;
+        ULARGE_INTEGER ft;
+        ft.LowPart = find_data.ftLastWriteTime.dwLowDateTime;
+        ft.HighPart = find_data.ftLastWriteTime.dwHighDateTime;
+        // FILETIME counts 100ns intervals since 1601-01-01
+        entry.mtime = static_cast<int64_t>((ft.QuadPart - 116444736000000000ULL) / 10000000ULL);
+        if (passes_stat_filters(options, entry)) {
+            files.push_back(entry);
+        }
+    } while (FindNextFileW(find_handle, &find_data) != 0);
+
+    FindClose(find_handle);
+#else
+    DIR* dir = opendir(full_dir.c_str());
+    if (!dir) {
+        return;
+    }
+
+    struct dirent* dent;
+    while ((dent = readdir(dir)) != nullptr) {
+        std::string name = dent->d_name;
+        if (name.empty() || name[0] == '.') {
+            continue;
+        }
+        std::string rel = join_relative(rel_dir, name);
+
+        bool is_dir = false;
+        bool is_reg = false;
+        bool classified = false;
+#ifdef DT_UNKNOWN
+        // d_type is reliable for DT_DIR/DT_REG; symlinks and DT_UNKNOWN (some NFS/XFS mounts) need stat
+        if (dent->d_type == DT_DIR) {
+            is_dir = true;
+            classified = true;
+        } else if (dent->d_type == DT_REG) {
+            is_reg = true;
+            classified = true;
+        } else if (dent->d_type != DT_UNKNOWN && dent->d_type != DT_LNK) {
+            continue;  // fifo, socket, device
+        }
+#endif
+
+        DirectoryEntry entry;
+        bool have_stat = false;
+        if (!classified) {
+            std::string full_path = full_dir + "/" + name;
+            struct stat st;
+            if (lstat(full_path.c_str(), &st) != 0) {
+                continue;
+            }
+            bool is_link = S_ISLNK(st.st_mode);
+            if (is_link && stat(full_path.c_str(), &st) != 0) {
+                continue;
+            }
+            if (is_link && S_ISDIR(st.st_mode)) {
+                continue;  // don't follow directory symlinks (cycles)
+            }
+            is_dir = S_ISDIR(st.st_mode);
+            is_reg = S_ISREG(st.st_mode);
+            entry.size = static_cast<int64_t>(st.st_size);
+            entry.mtime = static_cast<int64_t>(st.st_mtime);
+            have_stat = true;
+        }
+
+        if (is_dir) {
+            if (options.recursive && !matches_any(options.exclude_globs, rel)) {
+                subdirs.push_back(rel);
+            }
+            continue;
+        }
+        if (!is_reg || !passes_name_filters(options, name, rel)) {
+            continue;
+        }
+
+        if (want_stat && !have_stat) {
+            struct stat st;
+            if (stat((full_dir + "/" + name).c_str(), &st) != 0) {
+                continue;
+            }
+            entry.size = static_cast<int64_t>(st.st_size);
+            entry.mtime = static_cast<int64_t>(st.st_mtime);
+        }
+        entry.relative_path = rel;
+        entry.name = name;
+        if (!want_stat || passes_stat_filters(options, entry)) {
+            files.push_back(entry);
+        }
+    }
+
+    closedir(dir);
+#endif
+}
+
+// Shared work queue for parallel recursive scans
+struct WalkQueue {
+    std::mutex lock;
+    std::condition_variable cv;
+    std::deque<std::string> pending;
+    int active;
+    std::vector<DirectoryEntry> files;
+
+    WalkQueue() : active(0) {}
+};
+
+static void walk_worker(const std::string& root, const DirectoryWalkOptions& options, WalkQueue& queue) {
+    std::unique_lock<std::mutex> guard(queue.lock);
+    while (true) {
+        queue.cv.wait(guard, [&queue]() { return !queue.pending.empty() || queue.active == 0; });
+        if (queue.pending.empty()) {
+            // No work queued and nobody scanning: the walk is complete
+            queue.cv.notify_all();
+            return;
+        }
+        std::string rel_dir = queue.pending.front();
+        queue.pending.pop_front();
+        queue.active++;
+        guard.unlock();
+
+        std::vector<DirectoryEntry> files;
+        std::vector<std::string> subdirs;
+        scan_one_directory(root, rel_dir, options, files, subdirs);
+
+        guard.lock();
+        queue.files.insert(queue.files.end(), files.begin(), files.end());
+        queue.pending.insert(queue.pending.end(), subdirs.begin(), subdirs.end());
+        queue.active--;
+        queue.cv.notify_all();
+    }
+}
+
+std::vector<DirectoryEntry> walk_directory(const std::string& root_path, const DirectoryWalkOptions& options) {
+    std::string root = root_path;
+    std::replace(root.begin(), root.end(), '\\', '/');
+    while (root.size() > 1 && root.back() == '/') {
+        root.pop_back();
+    }
+
+    std::vector<DirectoryEntry> files;
+
+    if (!options.recursive || options.max_threads <= 1) {
+        std::vector<std::string> pending(1, std::string());
+        while (!pending.empty()) {
+            std::string rel_dir = pending.back();
+            pending.pop_back();
+            std::vector<std::string> subdirs;
+            scan_one_directory(root, rel_dir, options, files, subdirs);
+            pending.insert(pending.end(), subdirs.begin(), subdirs.end());
+        }
+    } else {
+        WalkQueue queue;
+        queue.pending.push_back(std::string());
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < options.max_threads; ++i) {
+            workers.push_back(std::thread(walk_worker, std::cref(root), std::cref(options), std::ref(queue)));
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        files.swap(queue.files);
+    }
+
+    std::sort(files.begin(), files.end(), [](const DirectoryEntry& a, const DirectoryEntry& b) {
+        return a.relative_path < b.relative_path;
+    });
+    return files;
+}
+
+std::vector<std::string> list_subdirectories(const std::string& root_path, const std::vector<std::string>& exclude_globs) {
+    std::string root = root_path;
+    std::replace(root.begin(), root.end(), '\\', '/');
+    while (root.size() > 1 && root.back() == '/') {
+        root.pop_back();
+    }
+
+    DirectoryWalkOptions options;
+    options.recursive = true;
+    options.exclude_globs = exclude_globs;
+    options.name_filter = [](const std::string&) { return false; };
+
+    std::vector<std::string> directories;
+    std::vector<std::string> pending(1, std::string());
+    while (!pending.empty()) {
+        std::string rel_dir = pending.back();
+        pending.pop_back();
+        std::vector<DirectoryEntry> files;
+        std::vector<std::string> subdirs;
+        scan_one_directory(root, rel_dir, options, files, subdirs);
+        directories.insert(directories.end(), subdirs.begin(), subdirs.end());
+        pending.insert(pending.end(), subdirs.begin(), subdirs.end());
+    }
+    std::sort(directories.begin(), directories.end());
+    return directories;
+}
+
+bool stat_file(const std::string& path, DirectoryEntry& entry) {
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(utf8_to_wide(path).c_str(), GetFileExInfoStandard, &data) ||
+        (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        return false;
+    }
+    entry.size = (static_cast<int64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+    ULARGE_INTEGER ft;
+    ft.LowPart = data.ftLastWriteTime.dwLowDateTime;
+    ft.HighPart = data.ftLastWriteTime.dwHighDateTime;
+    entry.mtime = static_cast<int64_t>((ft.QuadPart - 116444736000000000ULL) / 10000000ULL);
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    entry.size = static_cast<int64_t>(st.st_size);
+    entry.mtime = static_cast<int64_t>(st.st_mtime);
+#endif
+    return true;
+}
+
+} // namespace duckdb
@@ -0,0 +1,348 @@
+#include "encoding_detector.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+
+namespace duckdb {
+
+// ============================================================================
+// Byte statistics
+// ============================================================================
+
+namespace {
+
+struct ByteStats {
+    size_t bytes;
+    size_t high_bytes;       // >= 0x80
+    size_t nul_bytes;
+    size_t utf8_sequences;   // valid multi-byte UTF-8 sequences
+    size_t utf8_errors;      // bytes that can't be UTF-8
+    size_t cp1252_c1;        // 0x80-0x9F bytes that are printable in Windows-1252 (EUR, quotes, dashes)
+    size_t latin_letters;    // high bytes that are letters in ISO-8859-1 and sit next to an ASCII letter
+    size_t cp850_letters;    // high bytes that are letters in CP850 and sit next to an ASCII letter
+
+    ByteStats()
+        : bytes(0), high_bytes(0), nul_bytes(0), utf8_sequences(0), utf8_errors(0),
+          cp1252_c1(0), latin_letters(0), cp850_letters(0) {}
+};
+
+} // namespace
+
+static bool is_ascii_letter(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+// ISO-8859-1 / Windows-1252: A0-FF block, letters are C0-FF except the x and / signs
+static bool is_latin1_letter(unsigned char c) {
+    return c >= 0xC0 && c != 0xD7 && c != 0xF7;
+}
+
+// CP850: accented letters live in 80-A5 (umlauts at 81, 84, 8E, 94, 99, 9A), sharp s at E1
+static bool is_cp850_letter(unsigned char c) {
+    return (c >= 0x80 && c <= 0x9D && c != 0x9C) || (c >= 0xA0 && c <= 0xA5) || c == 0xE1;
+}
+
+// Bytes 0x80-0x9F that Windows-1252 maps to printable characters (81, 8D, 8F, 90, 9D are unused)
+static bool is_cp1252_c1(unsigned char c) {
+    return c >= 0x80 && c <= 0x9F && c != 0x81 && c != 0x8D && c != 0x8F && c != 0x90 && c != 0x9D;
+}
+
+// Length of the valid UTF-8 sequence starting at data[i], 0 if invalid, -1 if cut off at the end
+static int utf8_sequence_length(const unsigned char* data, size_t size, size_t i) {
+    unsigned char c = data[i];
+    int len;
+    unsigned char lo = 0x80, hi = 0xBF;
+    if (c >= 0xC2 && c <= 0xDF) {
+        len = 2;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        len = 3;
+        if (c == 0xE0) lo = 0xA0;       // overlong
+        if (c == 0xED) hi = 0x9F;       // surrogates
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        len = 4;
+        if (c == 0xF0) lo = 0x90;       // overlong
+        if (c == 0xF4) hi = 0x8F;       // > U+10FFFF
+    } else {
+        return 0;
+    }
+    for (int k = 1; k < len; ++k) {
+        if (i + k >= size) {
+            return -1;
+        }
+        unsigned char cc = data[i + k];
+        if (k == 1 ? (cc < lo || cc > hi) : (cc < 0x80 || cc > 0xBF)) {
+            return 0;
+        }
+    }
+    return len;
+}
+
+// Add one window of the file to the statistics.
+// at_start: window begins at offset 0; at_end: window ends at EOF.
+// Windows cut from the middle of the file may start or end inside a UTF-8 sequence.
+static void accumulate(ByteStats& stats, const char* raw, size_t size, bool at_start, bool at_end) {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(raw);
+    size_t i = 0;
+    if (!at_start) {
+        while (i < size && i < 3 && data[i] >= 0x80 && data[i] <= 0xBF) {
+            ++i;
+        }
+    }
+    stats.bytes += size - i;
+
+    for (; i < size; ++i) {
+        unsigned char c = data[i];
+        if (c == 0) {
+            stats.nul_bytes++;
+            continue;
+        }
+        if (c < 0x80) {
+            continue;
+        }
+        stats.high_bytes++;
+
+        bool letter_context = (i > 0 && is_ascii_letter(data[i - 1])) ||
+                              (i + 1 < size && is_ascii_letter(data[i + 1]));
+        if (letter_context && is_latin1_letter(c)) stats.latin_letters++;
+        if (letter_context && is_cp850_letter(c)) stats.cp850_letters++;
+        if (is_cp1252_c1(c)) stats.cp1252_c1++;
+
+        int len = utf8_sequence_length(data, size, i);
+        if (len > 0) {
+            stats.utf8_sequences++;
+            // Continuation bytes are not scored on their own
+            i += static_cast<size_t>(len - 1);
+        } else if (len < 0 && !at_end) {
+            break;  // sequence continues in the part of the file we did not read
+        } else {
+            stats.utf8_errors++;
+        }
+    }
+}
+
+static EncodingGuess guess_from_stats(const ByteStats& stats, bool complete) {
+    EncodingGuess guess;
+
+    // UTF-16 without BOM: text with every other byte NUL
+    if (stats.bytes > 0 && stats.nul_bytes * 4 > stats.bytes) {
+        guess.encoding = "UTF-16";
+        guess.confidence = 0.8;
+        guess.reader_names.push_back("utf-16");
+        return guess;
+    }
+
+    if (stats.high_bytes == 0) {
+        // Plain ASCII is valid UTF-8; bytes we did not sample may still disagree
+        guess.encoding = "UTF-8";
+        guess.confidence = complete ? 1.0 : 0.9;
+        guess.reader_names.push_back("utf-8");
+        guess.reader_names.push_back("latin-1");
+        return guess;
+    }
+
+    if (stats.utf8_errors == 0) {
+        // Random single-byte text almost never forms valid multi-byte sequences
+        guess.encoding = "UTF-8";
+        guess.confidence = stats.utf8_sequences >= 3 ? 0.99 : 0.9;
+        guess.reader_names.push_back("utf-8");
+        guess.reader_names.push_back("latin-1");
+        return guess;
+    }
+
+    // Single-byte encoding: score umlaut/accent positions of each code page
+    double latin = static_cast<double>(stats.latin_letters);
+    double cp850 = static_cast<double>(stats.cp850_letters);
+    double total = latin + cp850;
+
+    if (cp850 > latin) {
+        guess.encoding = "CP850";
+        guess.confidence = 0.5 + 0.5 * (cp850 - latin) / total;
+        guess.utf8_copy = true;
+        guess.reader_names.push_back("utf-8");
+        return guess;
+    }
+
+    guess.confidence = total > 0 ? 0.5 + 0.5 * (latin - cp850) / total : 0.5;
+    if (stats.cp1252_c1 > 0) {
+        // EUR sign, typographic quotes and dashes only exist in Windows-1252
+        guess.encoding = "Windows-1252";
+        guess.utf8_copy = true;
+        guess.reader_names.push_back("utf-8");
+    } else {
+        guess.encoding = "ISO-8859-1";
+        guess.reader_names.push_back("latin-1");
+    }
+    return guess;
+}
+
+// Byte order marks
+static bool detect_bom(const char* raw, size_t size, EncodingGuess& guess) {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(raw);
+    if (size >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+        guess.encoding = "UTF-8";
+        guess.reader_names.push_back("utf-8");
+    } else if (size >= 2 && ((data[0] == 0xFF && data[1] == 0xFE) || (data[0] == 0xFE && data[1] == 0xFF))) {
+        guess.encoding = "UTF-16";
+        guess.reader_names.push_back("utf-16");
+    } else {
+        return false;
+    }
+    guess.confidence = 1.0;
+    return true;
+}
+
+// ============================================================================
+// Public API
+// ============================================================================
+
+EncodingGuess detect_encoding(const char* data, size_t size, bool complete) {
+    EncodingGuess guess;
+    if (detect_bom(data, size, guess)) {
+        return guess;
+    }
+    ByteStats stats;
+    accumulate(stats, data, size, true, complete);
+    return guess_from_stats(stats, complete);
+}
+
+EncodingGuess detect_file_encoding(const std::string& path) {
+    const size_t head_size = 64 * 1024;
+    const size_t window_size = 16 * 1024;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return detect_encoding("", 0, true);
+    }
+    file.seekg(0, std::ios::end);
+    std::streamoff end = file.tellg();
+    size_t file_size = end > 0 ? static_cast<size_t>(end) : 0;
+    file.seekg(0, std::ios::beg);
+
+    std::string buffer(std::min(file_size, head_size), '\0');
+    file.read(&buffer[0], static_cast<std::streamsize>(buffer.size()));
+    buffer.resize(static_cast<size_t>(file.gcount()));
+
+    bool complete = file_size <= head_size;
+    EncodingGuess guess;
+    if (detect_bom(buffer.data(), buffer.size(), guess)) {
+        return guess;
+    }
+
+    ByteStats stats;
+    accumulate(stats, buffer.data(), buffer.size(), true, complete);
+
+    if (!complete) {
+        // Quarter points and the tail: umlauts often only show up in later rows
+        std::vector<size_t> offsets;
+        offsets.push_back(file_size / 4);
+        offsets.push_back(file_size / 2);
+        offsets.push_back(file_size / 4 * 3);
+        offsets.push_back(file_size - window_size);
+        for (size_t offset : offsets) {
+            if (offset < head_size) {
+                continue;
+            }
+            file.clear();
+            file.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+            buffer.assign(window_size, '\0');
+            file.read(&buffer[0], static_cast<std::streamsize>(window_size));
+            buffer.resize(static_cast<size_t>(file.gcount()));
+            accumulate(stats, buffer.data(), buffer.size(), false, offset + buffer.size() >= file_size);
+        }
+    }
+
+    return guess_from_stats(stats, complete);
+}
+
+std::string canonical_encoding_name(const std::string& reader_name) {
+    std::string lower = reader_name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    if (lower == "utf-8" || lower == "utf8") return "UTF-8";
+    if (lower == "utf-16" || lower == "utf16") return "UTF-16";
+    if (lower == "latin-1" || lower == "iso-8859-1") return "ISO-8859-1";
+    if (lower == "windows-1252" || lower == "cp1252" || lower == "windows-1252-2000") return "Windows-1252";
+    if (lower == "cp850" || lower == "ibm_850") return "CP850";
+    return reader_name;
+}
+
+// ============================================================================
+// Transcoding
+// ============================================================================
+
+// Windows-1252 0x80-0x9F (undefined bytes keep their ISO-8859-1 code point); 0xA0-0xFF equal ISO-8859-1
+static const uint16_t WINDOWS_1252_HIGH[32] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+};
+
+// CP850 0x80-0xFF
+static const uint16_t CP850_HIGH[128] = {
+    0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0, 0x00E5, 0x00E7,
+    0x00EA, 0x00EB, 0x00E8, 0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5,
+    0x00C9, 0x00E6, 0x00C6, 0x00F4, 0x00F6, 0x00F2, 0x00FB, 0x00F9,
+    0x00FF, 0x00D6, 0x00DC, 0x00F8, 0x00A3, 0x00D8, 0x00D7, 0x0192,
+    0x00E1, 0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA,
+    0x00BF, 0x00AE, 0x00AC, 0x00BD, 0x00BC, 0x00A1, 0x00AB, 0x00BB,
+    0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x00C1, 0x00C2, 0x00C0,
+    0x00A9, 0x2563, 0x2551, 0x2557, 0x255D, 0x00A2, 0x00A5, 0x2510,
+    0x2514, 0x2534, 0x252C, 0x251C, 0x2500, 0x253C, 0x00E3, 0x00C3,
+    0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256C, 0x00A4,
+    0x00F0, 0x00D0, 0x00CA, 0x00CB, 0x00C8, 0x0131, 0x00CD, 0x00CE,
+    0x00CF, 0x2518, 0x250C, 0x2588, 0x2584, 0x00A6, 0x00CC, 0x2580,
+    0x00D3, 0x00DF, 0x00D4, 0x00D2, 0x00F5, 0x00D5, 0x00B5, 0x00FE,
+    0x00DE, 0x00DA, 0x00DB, 0x00D9, 0x00FD, 0x00DD, 0x00AF, 0x00B4,
+    0x00AD, 0x00B1, 0x2017, 0x00BE, 0x00B6, 0x00A7, 0x00F7, 0x00B8,
+    0x00B0, 0x00A8, 0x00B7, 0x00B9, 0x00B3, 0x00B2, 0x25A0, 0x00A0,
+};
+
+static void append_code_point(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+bool is_valid_utf8(const char* raw, size_t size) {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(raw);
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] < 0x80) {
+            continue;
+        }
+        int len = utf8_sequence_length(data, size, i);
+        if (len <= 0) {
+            return false;
+        }
+        i += static_cast<size_t>(len - 1);
+    }
+    return true;
+}
+
+void append_as_utf8(std::string& out, const char* raw, size_t size, const std::string& encoding) {
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(raw);
+    bool cp850 = encoding == "CP850";
+    bool windows_1252 = encoding == "Windows-1252";
+    out.reserve(out.size() + size + size / 8);
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char c = data[i];
+        if (c < 0x80) {
+            out += static_cast<char>(c);
+        } else if (cp850) {
+            append_code_point(out, CP850_HIGH[c - 0x80]);
+        } else if (windows_1252 && c < 0xA0) {
+            append_code_point(out, WINDOWS_1252_HIGH[c - 0x80]);
+        } else {
+            append_code_point(out, c);
+        }
+    }
+}
+
+} // namespace duckdb
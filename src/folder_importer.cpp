@@ -1,15 +1,22 @@
 #include "folder_importer.hpp"
+#include "data_source.hpp"
+#include "directory_walker.hpp"
+#include "encoding_detector.hpp"
+#include "gdpdu_table_creator.hpp"
+#include "webdav_client.hpp"
+#include "zip_extractor.hpp"
 #include <sstream>
 #include <algorithm>
 #include <cctype>
-#include <sys/stat.h>
-
-#ifdef _WIN32
-#include <windows.h>
-#include <fileapi.h>
-#else
-#include <dirent.h>
-#endif
+#include <cstring>
+#include <map>
+#include <set>
+#include <fstream>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include "duckdb/common/crypto/md5.hpp"
+#include "duckdb/main/client_context.hpp"
 
 namespace duckdb {
 
@@ -103,8 +110,12 @@ static std::string to_snake_case(const std::string& input) {
 
 // Normalize filename to table name (remove extension, convert to snake_case)
 static std::string normalize_filename_to_table_name(const std::string& filename) {
-    // Remove extension
+    // Remove extension (only from the last path component)
     size_t last_dot = filename.find_last_of('.');
+    size_t last_slash = filename.find_last_of('/');
+    if (last_slash != std::string::npos && last_dot != std::string::npos && last_dot < last_slash) {
+        last_dot = std::string::npos;
+    }
     std::string name_without_ext = (last_dot != std::string::npos) 
         ? filename.substr(0, last_dot) 
         : filename;
@@ -158,7 +169,7 @@ static std::string get_file_extension(const std::string& filename) {
 }
 
 // Check if file matches the requested type
-static bool matches_file_type(const std::string& filename, const std::string& file_type) {
+bool matches_file_type(const std::string& filename, const std::string& file_type) {
     std::string ext = get_file_extension(filename);
     std::string type_lower = file_type;
     std::transform(type_lower.begin(), type_lower.end(), type_lower.begin(), ::tolower);
@@ -226,91 +237,24 @@ static std::string get_read_options(const std::string& file_type) {
     return opts.str();
 }
 
-// Convert UTF-8 string to wide string (Windows)
-#ifdef _WIN32
-static std::wstring utf8_to_wide(const std::string& utf8) {
-    if (utf8.empty()) return std::wstring();
-    int size_needed = MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), (int)utf8.size(), NULL, 0);
-    if (size_needed <= 0) return std::wstring();
-    std::wstring result(size_needed, 0);
-    MultiByteToWideChar(CP_UTF8, 0, utf8.c_str(), (int)utf8.size(), &result[0], size_needed);
-    return result;
-}
-
-// Convert wide string to UTF-8 string (Windows)
-static std::string wide_to_utf8(const std::wstring& wide) {
-    if (wide.empty()) return std::string();
-    int size_needed = WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), (int)wide.size(), NULL, 0, NULL, NULL);
-    if (size_needed <= 0) return std::string();
-    std::string result(size_needed, 0);
-    WideCharToMultiByte(CP_UTF8, 0, wide.c_str(), (int)wide.size(), &result[0], size_needed, NULL, NULL);
-    return result;
-}
-#endif
-
-// Get list of files in directory matching the file type
-static std::vector<std::string> get_matching_files(const std::string& folder_path, const std::string& file_type) {
-    std::vector<std::string> files;
-
-    #ifdef _WIN32
-        // Windows implementation using wide-char FindFirstFileW/FindNextFileW
-        // to properly handle UTF-8 paths with non-ASCII characters (e.g. umlauts)
-        std::string search_path = join_path(folder_path, "*");
-        std::wstring wide_search = utf8_to_wide(search_path);
-        WIN32_FIND_DATAW find_data;
-        HANDLE find_handle = FindFirstFileW(wide_search.c_str(), &find_data);
-
-        if (find_handle == INVALID_HANDLE_VALUE) {
-            return files;
-        }
-
-        do {
-            std::string filename = wide_to_utf8(find_data.cFileName);
-
-            // Skip hidden files and directories
-            if (filename.empty() || filename[0] == '.' || filename == ".." || filename == ".") {
-                continue;
-            }
-
-            // Check if it's a regular file (not a directory)
-            if (!(find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) {
-                if (matches_file_type(filename, file_type)) {
-                    files.push_back(filename);
-                }
-            }
-        } while (FindNextFileW(find_handle, &find_data) != 0);
-
-        FindClose(find_handle);
-    #else
-        // Unix/Linux/macOS implementation using opendir/readdir
-        DIR* dir = opendir(folder_path.c_str());
-        if (!dir) {
-            return files;
-        }
-        
-        struct dirent* entry;
-        while ((entry = readdir(dir)) != nullptr) {
-            std::string filename = entry->d_name;
-            
-            // Skip hidden files and directories
-            if (filename[0] == '.' || filename == ".." || filename == ".") {
-                continue;
-            }
-            
-            // Check if it's a regular file
-            std::string full_path = join_path(folder_path, filename);
-            struct stat st;
-            if (stat(full_path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
-                if (matches_file_type(filename, file_type)) {
-                    files.push_back(filename);
-                }
-            }
-        }
-        
-        closedir(dir);
-    #endif
-    
-    return files;
+// Get list of files below folder_path matching the file type and discovery filters
+// Returns entries with paths relative to folder_path ('/'-separated, sorted);
+// need_stat fills size/mtime for the import manifest
+static std::vector<DirectoryEntry> get_matching_files(const std::string& folder_path, const std::string& file_type,
+                                                     const FolderImportConfig& config, bool need_stat) {
+    DirectoryWalkOptions walk;
+    walk.recursive = config.recursive;
+    walk.include_globs = split_glob_list(config.include);
+    walk.exclude_globs = split_glob_list(config.exclude);
+    walk.min_size = config.min_size;
+    walk.max_size = config.max_size;
+    walk.min_mtime = config.modified_after;
+    walk.max_mtime = config.modified_before;
+    walk.need_stat = need_stat;
+    walk.name_filter = [file_type](const std::string& filename) {
+        return matches_file_type(filename, file_type);
+    };
+    return walk_directory(folder_path, walk);
 }
 
 // Get column names from a read function result
@@ -329,8 +273,160 @@ static std::vector<std::string> get_column_names(Connection& conn, const std::st
     return columns;
 }
 
-// Clean and trim all VARCHAR columns in a table
-static void clean_and_trim_columns(Connection& conn, const std::string& table_name) {
+// Errors worth retrying with another encoding: unsupported encoding name or undecodable bytes
+static bool is_encoding_error(const std::string& error) {
+    return error.find("unicode") != std::string::npos ||
+           error.find("Unicode") != std::string::npos ||
+           error.find("encoding") != std::string::npos ||
+           error.find("utf-8") != std::string::npos;
+}
+
+static std::string lower_copy(const std::string& value) {
+    std::string result = value;
+    std::transform(result.begin(), result.end(), result.begin(), ::tolower);
+    return result;
+}
+
+// Rename all columns of a table to unique snake_case names ("Betrag EUR" -> "betrag_eur",
+// a second "betrag_eur" becomes "betrag_eur_2"). Returns the original column names.
+static std::vector<std::string> rename_columns_to_snake_case(Connection& conn, const std::string& table_name) {
+    std::vector<std::string> orig_cols = get_column_names(conn, "SELECT * FROM \"" + table_name + "\"");
+
+    std::vector<std::string> new_cols;
+    std::set<std::string> used;
+    for (size_t i = 0; i < orig_cols.size(); ++i) {
+        std::string base = to_snake_case(orig_cols[i]);
+        if (base.empty()) {
+            base = "column" + std::to_string(i);
+        }
+        std::string name = base;
+        for (int n = 2; used.count(lower_copy(name)) > 0; ++n) {
+            name = base + "_" + std::to_string(n);
+        }
+        used.insert(lower_copy(name));
+        new_cols.push_back(name);
+    }
+
+    // A target name may still belong to another column ("A B" -> "a_b" while "a_b" exists):
+    // then move the renamed columns out of the way first
+    bool collision = false;
+    for (size_t i = 0; i < orig_cols.size() && !collision; ++i) {
+        if (new_cols[i] == orig_cols[i]) continue;
+        for (size_t j = 0; j < orig_cols.size(); ++j) {
+            if (j != i && lower_copy(orig_cols[j]) == lower_copy(new_cols[i])) {
+                collision = true;
+                break;
+            }
+        }
+    }
+
+    std::string alter = "ALTER TABLE \"" + table_name + "\" RENAME COLUMN \"";
+    std::vector<std::string> current = orig_cols;
+    if (collision) {
+        for (size_t i = 0; i < current.size(); ++i) {
+            if (new_cols[i] == orig_cols[i]) continue;
+            std::string tmp = "__gdpdu_rename_" + std::to_string(i);
+            conn.Query(alter + escape_sql(current[i]) + "\" TO \"" + tmp + "\"");
+            current[i] = tmp;
+        }
+    }
+    for (size_t i = 0; i < current.size(); ++i) {
+        if (new_cols[i] == current[i]) continue;
+        conn.Query(alter + escape_sql(current[i]) + "\" TO \"" + escape_sql(new_cols[i]) + "\"");
+    }
+    return orig_cols;
+}
+
+// SQL expression casting a VARCHAR cell from read_xlsx(all_varchar=true) back to its sniffed type.
+// Date/time cells may come through as Excel serial numbers (days since 1899-12-30).
+static std::string xlsx_cast_expr(const std::string& column, const LogicalType& type) {
+    std::string col = "\"" + escape_sql(column) + "\"";
+    std::string serial_micros = "to_microseconds(CAST(round(TRY_CAST(" + col + " AS DOUBLE) * 86400000000) AS BIGINT))";
+    std::string type_name = type.ToString();
+    if (type_name == "DATE") {
+        return "COALESCE(TRY_CAST(" + col + " AS DATE), CAST(DATE '1899-12-30' + CAST(floor(TRY_CAST(" + col +
+               " AS DOUBLE)) AS INTEGER) AS DATE))";
+    }
+    if (type_name == "TIMESTAMP") {
+        return "COALESCE(TRY_CAST(" + col + " AS TIMESTAMP), TIMESTAMP '1899-12-30' + " + serial_micros + ")";
+    }
+    if (type_name == "TIME") {
+        return "COALESCE(TRY_CAST(" + col + " AS TIME), CAST(TIMESTAMP '1899-12-30' + " + serial_micros + " AS TIME))";
+    }
+    return "TRY_CAST(" + col + " AS " + type_name + ")";
+}
+
+// Load an Excel sheet with a single full parse.
+// The sheet is read once with all_varchar=true; the types read_xlsx sniffs at bind time (which only
+// samples the first rows) are checked per column in one aggregate scan. Columns where every value
+// casts are returned in native_columns (column position -> type) and cast by the single rewrite in
+// infer_and_convert_types(); a stray "Summen" row under numbers leaves just that column to its
+// inference instead of re-reading the whole workbook.
+static bool load_xlsx_single_pass(Connection& conn, const std::string& file_path, const std::string& table_name,
+                                  const std::string& options, std::map<size_t, LogicalType>& native_columns,
+                                  std::string& error) {
+    std::string path_sql = "'" + escape_sql(file_path) + "'";
+    std::string extra_opts = options.empty() ? "" : ", " + options;
+    bool user_all_varchar = lower_copy(options).find("all_varchar") != std::string::npos;
+
+    std::vector<LogicalType> native_types;
+    if (!user_all_varchar) {
+        auto sniff = conn.Query("SELECT * FROM read_xlsx(" + path_sql + extra_opts + ") LIMIT 0");
+        if (!sniff->HasError()) {
+            native_types = sniff->types;
+        }
+    }
+
+    std::ostringstream load;
+    load << "CREATE TABLE \"" << table_name << "\" AS SELECT * FROM read_xlsx(" << path_sql;
+    if (!user_all_varchar) {
+        load << ", all_varchar=true";
+    }
+    load << extra_opts << ")";
+    auto load_result = conn.Query(load.str());
+    if (load_result->HasError()) {
+        error = load_result->GetError();
+        return false;
+    }
+
+    std::vector<std::string> columns = get_column_names(conn, "SELECT * FROM \"" + table_name + "\"");
+    if (native_types.size() != columns.size()) {
+        return true;
+    }
+
+    // One aggregate pass: per typed column, count values that don't cast
+    std::vector<size_t> typed;
+    std::ostringstream check;
+    check << "SELECT ";
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (native_types[i].ToString() == "VARCHAR") continue;
+        std::string col = "\"" + escape_sql(columns[i]) + "\"";
+        if (!typed.empty()) check << ", ";
+        check << "COUNT(*) FILTER (WHERE " << col << " IS NOT NULL AND " << col << " <> '' AND "
+              << xlsx_cast_expr(columns[i], native_types[i]) << " IS NULL)";
+        typed.push_back(i);
+    }
+    if (typed.empty()) {
+        return true;
+    }
+    check << " FROM \"" << table_name << "\"";
+    auto check_result = conn.Query(check.str());
+    if (check_result->HasError() || check_result->RowCount() == 0) {
+        return true;
+    }
+
+    for (size_t k = 0; k < typed.size(); ++k) {
+        if (check_result->GetValue(k, 0).GetValue<int64_t>() == 0) {
+            native_columns[typed[k]] = native_types[typed[k]];
+        }
+    }
+    return true;
+}
+
+// Clean and trim all VARCHAR columns in a table, except the Excel columns about to be cast
+// to their native type (see load_xlsx_single_pass)
+static void clean_and_trim_columns(Connection& conn, const std::string& table_name,
+                                   const std::map<size_t, LogicalType>& native_columns) {
     // Get column information
     auto desc_result = conn.Query("DESCRIBE \"" + table_name + "\"");
     if (desc_result->HasError()) {
@@ -342,6 +438,10 @@ static void clean_and_trim_columns(Connection& conn, const std::string& table_na
         std::string col_name = desc_result->GetValue(0, i).GetValue<std::string>();
         std::string col_type = desc_result->GetValue(1, i).GetValue<std::string>();
         
+        if (native_columns.count(i)) {
+            continue;
+        }
+
         // Check if it's a VARCHAR type
         if (col_type.find("VARCHAR") != std::string::npos || 
             col_type.find("TEXT") != std::string::npos ||
@@ -372,415 +472,891 @@ static void clean_and_trim_columns(Connection& conn, const std::string& table_na
     }
 }
 
+// Split "name TYPE, name TYPE" at top-level commas (DECIMAL(18,2) stays in one piece)
+static std::vector<std::string> split_column_type_list(const std::string& list) {
+    std::vector<std::string> parts;
+    std::string current;
+    int depth = 0;
+    for (char c : list) {
+        if (c == '(') depth++;
+        if (c == ')') depth--;
+        if (c == ',' && depth == 0) {
+            parts.push_back(current);
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    parts.push_back(current);
+    return parts;
+}
+
+// Parse column type overrides "betrag DECIMAL(18,2), konto VARCHAR" into lower-case name -> type.
+// Column names may be double-quoted; the format matches FileImportResult::column_types.
+static std::map<std::string, std::string> parse_column_types(const std::string& column_types) {
+    std::map<std::string, std::string> overrides;
+    for (const auto& part : split_column_type_list(column_types)) {
+        size_t start = part.find_first_not_of(" \t");
+        if (start == std::string::npos) continue;
+        std::string name;
+        size_t type_start;
+        if (part[start] == '"') {
+            size_t end = part.find('"', start + 1);
+            if (end == std::string::npos) continue;
+            name = part.substr(start + 1, end - start - 1);
+            type_start = end + 1;
+        } else {
+            size_t end = part.find_first_of(" \t", start);
+            if (end == std::string::npos) continue;
+            name = part.substr(start, end - start);
+            type_start = end;
+        }
+        size_t first = part.find_first_not_of(" \t", type_start);
+        size_t last = part.find_last_not_of(" \t");
+        if (first == std::string::npos || name.empty()) continue;
+        overrides[lower_copy(name)] = part.substr(first, last - first + 1);
+    }
+    return overrides;
+}
+
+// "name TYPE, name TYPE" of all columns of a table, as reported in FileImportResult::column_types
+static std::string describe_column_types(Connection& conn, const std::string& table_name) {
+    auto desc_result = conn.Query("DESCRIBE \"" + table_name + "\"");
+    if (desc_result->HasError()) {
+        return "";
+    }
+    std::ostringstream ss;
+    for (idx_t i = 0; i < desc_result->RowCount(); ++i) {
+        if (i > 0) ss << ", ";
+        ss << desc_result->GetValue(0, i).ToString() << " " << desc_result->GetValue(1, i).ToString();
+    }
+    return ss.str();
+}
+
+// German number text: optional sign, digits with optional '.' thousands groups, optional ',' decimals.
+// "1.234,50", "-7,5" and "0815" match; "1.5" and "1e3" don't.
+static const char* GERMAN_NUMBER_PATTERN = "[+-]?([0-9]{1,3}(\\.[0-9]{3})+|[0-9]+)(,[0-9]+)?";
+
+// German number text as a plain decimal literal ("1.234,50" -> "1234.50")
+static std::string german_number_expr(const std::string& col) {
+    return "replace(replace(trim(" + col + "), '.', ''), ',', '.')";
+}
+
+// Value expression for casting a text column to type: numbers are read in German notation,
+// dates as ISO or DD.MM.YYYY
+static std::string text_cast_expr(const std::string& col, const std::string& type) {
+    std::string upper = type;
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    if (upper == "DATE") {
+        return "COALESCE(TRY_CAST(" + col + " AS DATE), CAST(try_strptime(" + col + ", '%d.%m.%Y') AS DATE))";
+    }
+    static const char* numeric_prefixes[] = {"TINYINT", "SMALLINT", "INT", "BIGINT", "HUGEINT", "UBIGINT",
+                                             "UINTEGER", "USMALLINT", "UTINYINT", "DECIMAL", "NUMERIC",
+                                             "DOUBLE", "FLOAT", "REAL"};
+    for (const char* prefix : numeric_prefixes) {
+        if (upper.compare(0, strlen(prefix), prefix) == 0) {
+            return "COALESCE(TRY_CAST(CASE WHEN regexp_full_match(trim(" + col + "), '" + GERMAN_NUMBER_PATTERN +
+                   "') THEN " + german_number_expr(col) + " END AS " + type + "), TRY_CAST(trim(" + col +
+                   ") AS " + type + "))";
+        }
+    }
+    return "TRY_CAST(" + col + " AS " + type + ")";
+}
+
+// Narrowest type for a column of German numbers with at most int_digits digits before and
+// scale digits after the decimal comma. DECIMAL precision is rounded up to the storage width
+// (4/9/18/38 digits = 16/32/64/128-bit) since a narrower precision wouldn't save space.
+static std::string exact_numeric_type(int64_t int_digits, int64_t scale) {
+    if (int_digits < 1) int_digits = 1;
+    if (scale == 0) {
+        if (int_digits <= 9) return "INTEGER";
+        if (int_digits <= 18) return "BIGINT";
+        if (int_digits <= 38) return "HUGEINT";
+        return "DOUBLE";
+    }
+    int64_t precision = int_digits + scale;
+    if (precision > 38) return "DOUBLE";
+    int64_t width = precision <= 4 ? 4 : precision <= 9 ? 9 : precision <= 18 ? 18 : 38;
+    return "DECIMAL(" + std::to_string(width) + "," + std::to_string(scale) + ")";
+}
+
 // Infer and convert column types based on data
-static void infer_and_convert_types(Connection& conn, const std::string& table_name) {
+// All VARCHAR columns are profiled in one aggregate query and converted in one table rewrite:
+// German numbers become INTEGER/BIGINT/HUGEINT or an exact DECIMAL(p,s) (DOUBLE only for
+// exponent notation or more than 38 digits), DD.MM.YYYY and ISO dates become DATE.
+// native_columns (column position -> type) are Excel columns that take their sniffed type
+// (see load_xlsx_single_pass); overrides (lower-case column name -> type) replace the inferred
+// or native type of any column. False with error if the rewrite fails; the table then keeps
+// its VARCHAR columns.
+static bool infer_and_convert_types(Connection& conn, const std::string& table_name,
+                                    const std::map<std::string, std::string>& overrides,
+                                    const std::map<size_t, LogicalType>& native_columns, std::string& error) {
     // Get column information
     auto desc_result = conn.Query("DESCRIBE \"" + table_name + "\"");
     if (desc_result->HasError()) {
-        return;
+        return true;
     }
-    
-    std::vector<std::pair<std::string, std::string>> varchar_columns;
+
+    std::vector<std::string> varchar_columns;
+    std::vector<std::pair<std::string, std::string>> conversions;  // column -> value expression
     for (idx_t i = 0; i < desc_result->RowCount(); ++i) {
         std::string col_name = desc_result->GetValue(0, i).GetValue<std::string>();
         std::string col_type = desc_result->GetValue(1, i).GetValue<std::string>();
-        
-        // Only process VARCHAR columns
-        if (col_type.find("VARCHAR") != std::string::npos || 
-            col_type.find("TEXT") != std::string::npos ||
-            col_type.find("CHAR") != std::string::npos) {
-            varchar_columns.push_back({col_name, col_type});
+        bool is_text = col_type.find("VARCHAR") != std::string::npos ||
+                       col_type.find("TEXT") != std::string::npos ||
+                       col_type.find("CHAR") != std::string::npos;
+
+        auto override_it = overrides.find(lower_copy(col_name));
+        if (override_it != overrides.end()) {
+            std::string col = "\"" + escape_sql(col_name) + "\"";
+            std::string expr = is_text ? text_cast_expr(col, override_it->second)
+                                       : "TRY_CAST(" + col + " AS " + override_it->second + ")";
+            conversions.push_back(std::make_pair(col_name, expr));
+        } else if (native_columns.count(i)) {
+            conversions.push_back(std::make_pair(col_name, xlsx_cast_expr(col_name, native_columns.at(i))));
+        } else if (is_text) {
+            varchar_columns.push_back(col_name);
         }
     }
-    
-    if (varchar_columns.empty()) {
-        return;
-    }
-    
-    // For each VARCHAR column, try to infer type
-    for (const auto& col_pair : varchar_columns) {
-        std::string col_name = escape_sql(col_pair.first);
-        
-        // Check if column can be converted to different types
-        // Try INTEGER first (most restrictive)
-        std::ostringstream check_int;
-        check_int << "SELECT COUNT(*) FROM \"" << table_name << "\" WHERE \"";
-        check_int << col_name << "\" IS NOT NULL AND \"";
-        check_int << col_name << "\" != '' AND TRY_CAST(\"" << col_name << "\" AS BIGINT) IS NULL";
-        
-        auto int_check = conn.Query(check_int.str());
-        bool can_be_int = false;
-        if (!int_check->HasError() && int_check->RowCount() > 0) {
-            int64_t non_int_count = int_check->GetValue(0, 0).GetValue<int64_t>();
-            // If all non-null values can be cast to integer, it's an integer
-            std::ostringstream count_non_null;
-            count_non_null << "SELECT COUNT(*) FROM \"" << table_name << "\" WHERE \"";
-            count_non_null << col_name << "\" IS NOT NULL AND \"" << col_name << "\" != ''";
-            auto non_null_result = conn.Query(count_non_null.str());
-            if (!non_null_result->HasError() && non_null_result->RowCount() > 0) {
-                int64_t non_null_count = non_null_result->GetValue(0, 0).GetValue<int64_t>();
-                if (non_null_count > 0 && non_int_count == 0) {
-                    can_be_int = true;
-                }
-            }
-        }
-        
-        if (can_be_int) {
-            // Convert to BIGINT
-            std::ostringstream alter_sql;
-            alter_sql << "ALTER TABLE \"" << table_name << "\" ALTER COLUMN \"";
-            alter_sql << col_name << "\" TYPE BIGINT USING TRY_CAST(\"" << col_name << "\" AS BIGINT)";
-            try {
-                conn.Query(alter_sql.str());
-                continue; // Move to next column
-            } catch (const std::exception& e) {
-                // If conversion fails, try other types
-            }
+
+    if (!varchar_columns.empty()) {
+        // Per column: non-empty values, German numbers, DOUBLE-castable values, max digits
+        // before/after the comma, DD.MM.YYYY dates and ISO dates
+        const int stats_per_column = 7;
+        std::ostringstream stats_sql;
+        stats_sql << "SELECT ";
+        for (size_t i = 0; i < varchar_columns.size(); ++i) {
+            std::string col = "\"" + escape_sql(varchar_columns[i]) + "\"";
+            std::string is_number = "regexp_full_match(trim(" + col + "), '" + GERMAN_NUMBER_PATTERN + "')";
+            std::string number = german_number_expr(col);
+            if (i > 0) stats_sql << ", ";
+            stats_sql << "COUNT(*) FILTER (WHERE " << col << " != ''), "
+                      << "COUNT(*) FILTER (WHERE " << is_number << "), "
+                      << "COUNT(*) FILTER (WHERE TRY_CAST(trim(" << col << ") AS DOUBLE) IS NOT NULL), "
+                      << "MAX(length(ltrim(regexp_extract(" << number << ", '^[+-]?([0-9]*)', 1), '0'))) "
+                      << "FILTER (WHERE " << is_number << "), "
+                      << "MAX(length(regexp_extract(" << number << ", '\\.([0-9]+)$', 1))) "
+                      << "FILTER (WHERE " << is_number << "), "
+                      << "COUNT(*) FILTER (WHERE try_strptime(" << col << ", '%d.%m.%Y') IS NOT NULL), "
+                      << "COUNT(*) FILTER (WHERE TRY_CAST(" << col << " AS DATE) IS NOT NULL)";
         }
-        
-        // Try DECIMAL (handle German format with comma)
-        std::ostringstream check_decimal;
-        check_decimal << "SELECT COUNT(*) FROM \"" << table_name << "\" WHERE \"";
-        check_decimal << col_name << "\" IS NOT NULL AND \"";
-        check_decimal << col_name << "\" != '' AND TRY_CAST(REPLACE(REPLACE(\"";
-        check_decimal << col_name << "\", '.', ''), ',', '.') AS DOUBLE) IS NULL";
-        
-        auto decimal_check = conn.Query(check_decimal.str());
-        bool can_be_decimal = false;
-        if (!decimal_check->HasError() && decimal_check->RowCount() > 0) {
-            int64_t non_decimal_count = decimal_check->GetValue(0, 0).GetValue<int64_t>();
-            std::ostringstream count_non_null;
-            count_non_null << "SELECT COUNT(*) FROM \"" << table_name << "\" WHERE \"";
-            count_non_null << col_name << "\" IS NOT NULL AND \"" << col_name << "\" != ''";
-            auto non_null_result = conn.Query(count_non_null.str());
-            if (!non_null_result->HasError() && non_null_result->RowCount() > 0) {
-                int64_t non_null_count = non_null_result->GetValue(0, 0).GetValue<int64_t>();
-                if (non_null_count > 0 && non_decimal_count == 0) {
-                    can_be_decimal = true;
+        stats_sql << " FROM \"" << table_name << "\"";
+
+        auto stats = conn.Query(stats_sql.str());
+        if (!stats->HasError() && stats->RowCount() > 0) {
+            auto stat = [&](size_t column, int k) -> int64_t {
+                Value v = stats->GetValue(column * stats_per_column + k, 0);
+                return v.IsNull() ? 0 : v.GetValue<int64_t>();
+            };
+            for (size_t i = 0; i < varchar_columns.size(); ++i) {
+                int64_t non_empty = stat(i, 0);
+                if (non_empty == 0) {
+                    continue;  // no values to judge by, keep as VARCHAR
                 }
+                std::string col = "\"" + escape_sql(varchar_columns[i]) + "\"";
+                std::string type;
+                if (stat(i, 1) == non_empty) {
+                    type = exact_numeric_type(stat(i, 3), stat(i, 4));
+                } else if (stat(i, 2) == non_empty) {
+                    type = "DOUBLE";
+                } else if (stat(i, 5) == non_empty || stat(i, 6) == non_empty) {
+                    type = "DATE";
+                } else {
+                    continue;  // keep as VARCHAR
+                }
+                conversions.push_back(std::make_pair(varchar_columns[i], text_cast_expr(col, type)));
             }
         }
-        
-        if (can_be_decimal) {
-            // Convert to DOUBLE (we'll use DOUBLE for flexibility)
-            std::ostringstream alter_sql;
-            alter_sql << "ALTER TABLE \"" << table_name << "\" ALTER COLUMN \"";
-            alter_sql << col_name << "\" TYPE DOUBLE USING TRY_CAST(REPLACE(REPLACE(\"";
-            alter_sql << col_name << "\", '.', ''), ',', '.') AS DOUBLE)";
-            try {
-                conn.Query(alter_sql.str());
-                continue;
-            } catch (const std::exception& e) {
-                // If conversion fails, keep as VARCHAR
-            }
+    }
+
+    if (conversions.empty()) {
+        return true;
+    }
+
+    std::ostringstream convert_sql;
+    convert_sql << "CREATE OR REPLACE TABLE \"" << table_name << "\" AS SELECT * REPLACE (";
+    for (size_t i = 0; i < conversions.size(); ++i) {
+        if (i > 0) convert_sql << ", ";
+        convert_sql << conversions[i].second << " AS \"" << escape_sql(conversions[i].first) << "\"";
+    }
+    convert_sql << ") FROM \"" << table_name << "\"";
+    // Fails e.g. for an invalid override type
+    auto convert_result = conn.Query(convert_sql.str());
+    if (convert_result->HasError()) {
+        error = convert_result->GetError();
+        return false;
+    }
+    return true;
+}
+
+// Status prefix of an import whose table was created but kept its VARCHAR columns because
+// the type rewrite failed
+static const char* const TYPES_NOT_CONVERTED = "Types not converted: ";
+
+// Build a SQL list literal of file paths: ['/a/x.csv', '/a/y.csv']
+static std::string build_path_list(const std::string& folder, const std::vector<std::string>& files) {
+    std::ostringstream ss;
+    ss << "[";
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (i > 0) ss << ", ";
+        ss << "'" << escape_sql(join_path(folder, files[i])) << "'";
+    }
+    ss << "]";
+    return ss.str();
+}
+
+// UTF-8 copies of text files whose code page read_csv can't decode (EncodingGuess::utf8_copy),
+// kept in one temporary folder that is removed with the object. Without the copy the file
+// would be read as latin-1, which mis-decodes CP850 umlauts and the Windows-1252 EUR sign.
+class Utf8Copies {
+public:
+    ~Utf8Copies() {
+        if (!dir_.empty()) {
+            cleanup_temp_dir(dir_);
         }
-        
-        // Try DATE (German format DD.MM.YYYY)
-        std::ostringstream check_date;
-        check_date << "SELECT COUNT(*) FROM \"" << table_name << "\" WHERE \"";
-        check_date << col_name << "\" IS NOT NULL AND \"";
-        check_date << col_name << "\" != '' AND TRY_CAST(strptime(\"";
-        check_date << col_name << "\", '%d.%m.%Y') AS DATE) IS NULL";
-        
-        auto date_check = conn.Query(check_date.str());
-        bool can_be_date = false;
-        if (!date_check->HasError() && date_check->RowCount() > 0) {
-            int64_t non_date_count = date_check->GetValue(0, 0).GetValue<int64_t>();
-            std::ostringstream count_non_null;
-            count_non_null << "SELECT COUNT(*) FROM \"" << table_name << "\" WHERE \"";
-            count_non_null << col_name << "\" IS NOT NULL AND \"" << col_name << "\" != ''";
-            auto non_null_result = conn.Query(count_non_null.str());
-            if (!non_null_result->HasError() && non_null_result->RowCount() > 0) {
-                int64_t non_null_count = non_null_result->GetValue(0, 0).GetValue<int64_t>();
-                if (non_null_count > 0 && non_date_count == 0) {
-                    can_be_date = true;
-                }
+    }
+
+    const std::string& dir() const { return dir_; }
+
+    // Name of the copy in dir(): relative_path with '%' and '/' escaped, so copies of files
+    // from subfolders sit side by side (undone by source_name_sql)
+    static std::string copy_name(const std::string& relative_path) {
+        std::string name;
+        for (char c : relative_path) {
+            if (c == '%') {
+                name += "%25";
+            } else if (c == '/') {
+                name += "%2F";
+            } else {
+                name += c;
             }
         }
-        
-        if (can_be_date) {
-            // Convert to DATE
-            std::ostringstream alter_sql;
-            alter_sql << "ALTER TABLE \"" << table_name << "\" ALTER COLUMN \"";
-            alter_sql << col_name << "\" TYPE DATE USING TRY_CAST(strptime(\"";
-            alter_sql << col_name << "\", '%d.%m.%Y') AS DATE)";
-            try {
-                conn.Query(alter_sql.str());
-                continue;
-            } catch (const std::exception& e) {
-                // If conversion fails, keep as VARCHAR
+        return name;
+    }
+
+    // SQL expression turning the path of a copy (column path_column) back into relative_path
+    std::string source_name_sql(const std::string& path_column) const {
+        return "replace(replace(substr(\"" + path_column + "\", length('" + escape_sql(dir_) +
+               "/') + 1), '%2F', '/'), '%25', '%')";
+    }
+
+    // Convert the file at source_path from encoding to UTF-8 in dir(). False with error on failure.
+    bool Add(const std::string& source_path, const std::string& relative_path, const std::string& encoding,
+             std::string& error) {
+        if (dir_.empty()) {
+            dir_ = create_temp_download_dir();
+            if (dir_.empty()) {
+                error = "Cannot create a temporary folder for the UTF-8 copy of " + relative_path;
+                return false;
             }
         }
-        
-        // Try DATE (ISO format YYYY-MM-DD)
-        std::ostringstream check_date_iso;
-        check_date_iso << "SELECT COUNT(*) FROM \"" << table_name << "\" WHERE \"";
-        check_date_iso << col_name << "\" IS NOT NULL AND \"";
-        check_date_iso << col_name << "\" != '' AND TRY_CAST(\"";
-        check_date_iso << col_name << "\" AS DATE) IS NULL";
-        
-        auto date_iso_check = conn.Query(check_date_iso.str());
-        bool can_be_date_iso = false;
-        if (!date_iso_check->HasError() && date_iso_check->RowCount() > 0) {
-            int64_t non_date_count = date_iso_check->GetValue(0, 0).GetValue<int64_t>();
-            std::ostringstream count_non_null;
-            count_non_null << "SELECT COUNT(*) FROM \"" << table_name << "\" WHERE \"";
-            count_non_null << col_name << "\" IS NOT NULL AND \"" << col_name << "\" != ''";
-            auto non_null_result = conn.Query(count_non_null.str());
-            if (!non_null_result->HasError() && non_null_result->RowCount() > 0) {
-                int64_t non_null_count = non_null_result->GetValue(0, 0).GetValue<int64_t>();
-                if (non_null_count > 0 && non_date_count == 0) {
-                    can_be_date_iso = true;
-                }
-            }
+        std::ifstream in(source_path, std::ios::binary);
+        std::ofstream out(join_path(dir_, copy_name(relative_path)), std::ios::binary | std::ios::trunc);
+        if (!in || !out) {
+            error = "Cannot convert " + relative_path + " from " + encoding + " to UTF-8";
+            return false;
         }
-        
-        if (can_be_date_iso) {
-            // Convert to DATE
-            std::ostringstream alter_sql;
-            alter_sql << "ALTER TABLE \"" << table_name << "\" ALTER COLUMN \"";
-            alter_sql << col_name << "\" TYPE DATE USING TRY_CAST(\"" << col_name << "\" AS DATE)";
-            try {
-                conn.Query(alter_sql.str());
-                continue;
-            } catch (const std::exception& e) {
-                // If conversion fails, keep as VARCHAR
-            }
+        // Single-byte code pages: any chunk boundary is a character boundary
+        std::vector<char> buffer(1 << 20);
+        std::string utf8;
+        while (in) {
+            in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            utf8.clear();
+            append_as_utf8(utf8, buffer.data(), static_cast<size_t>(in.gcount()), encoding);
+            out.write(utf8.data(), static_cast<std::streamsize>(utf8.size()));
         }
-        
-        // If none of the above, keep as VARCHAR
+        if (!out) {
+            error = "Cannot write the UTF-8 copy of " + relative_path;
+            return false;
+        }
+        return true;
     }
+
+private:
+    std::string dir_;
+};
+
+// Derive the default union table name from the last folder component
+static std::string default_union_table_name(const std::string& folder) {
+    size_t last_slash = folder.find_last_of('/');
+    std::string base = (last_slash != std::string::npos) ? folder.substr(last_slash + 1) : folder;
+    std::string name = to_snake_case(base);
+    return name.empty() ? "folder_union" : name;
 }
 
-std::vector<FileImportResult> import_folder(
+// Import all matching files into a single table (mode := 'union')
+// Uses one multi-file scan with union_by_name so DuckDB reads the files in parallel.
+// Columns whose names normalize to the same snake_case name are merged; if their
+// types differ they are unified to VARCHAR and typed afterwards by infer_and_convert_types().
+static std::vector<FileImportResult> import_folder_union(
     Connection& conn,
-    const std::string& folder_path,
+    const std::string& folder,
+    const std::vector<std::string>& files,
     const std::string& file_type,
-    const std::string& options) {
-    
+    const std::string& options,
+    const FolderImportConfig& config) {
+
     std::vector<FileImportResult> results;
 
-    // Path traversal protection
-    std::string check_path = normalize_path(folder_path);
-    if (check_path.find("/../") != std::string::npos ||
-        check_path.find("../") == 0 ||
-        (check_path.size() >= 3 && check_path.substr(check_path.size() - 3) == "/..") ||
-        check_path == "..") {
-        FileImportResult r;
-        r.table_name = "(security)";
-        r.file_name = "";
-        r.row_count = 0;
-        r.column_count = 0;
-        r.status = "Path traversal detected: path contains '..' components";
-        results.push_back(r);
-        return results;
-    }
+    std::string table_name = config.table_name.empty() ? default_union_table_name(folder) : config.table_name;
+    std::string type_lower = file_type;
+    std::transform(type_lower.begin(), type_lower.end(), type_lower.begin(), ::tolower);
 
-    // Normalize folder path
-    std::string norm_folder = check_path;
-    
-    // Get list of matching files
-    std::vector<std::string> files = get_matching_files(norm_folder, file_type);
-    
-    if (files.empty()) {
-        FileImportResult r;
-        r.table_name = "(no files)";
-        r.file_name = "";
-        r.row_count = 0;
-        r.column_count = 0;
-        r.status = "No matching files found for type: " + file_type;
-        results.push_back(r);
-        return results;
+    std::string extra_opts;
+    if (!options.empty()) {
+        extra_opts = ", " + options;
     }
-    
-    std::string read_func = get_read_function(file_type);
-    
-    // Import each file
-    for (const auto& filename : files) {
-        FileImportResult result;
-        result.file_name = filename;
-        result.table_name = normalize_filename_to_table_name(filename);
-        
-        std::string file_path = join_path(norm_folder, filename);
-        std::string read_opts = get_read_options(file_type);
-        
-        try {
-            // Drop existing table if it exists
-            std::string drop_sql = "DROP TABLE IF EXISTS \"" + result.table_name + "\"";
-            conn.Query(drop_sql);
-            
-            // For Excel/Parquet/JSON files, read directly without encoding detection
-            // For CSV/TXT/TSV files, try different encodings
-            bool success = false;
-            std::string final_read_query;
-            std::vector<std::string> orig_cols;
-            
-            std::string type_lower = file_type;
-            std::transform(type_lower.begin(), type_lower.end(), type_lower.begin(), ::tolower);
-            
-            if (type_lower == "xlsx" || type_lower == "excel" ||
-                type_lower == "parquet" || type_lower == "json" || type_lower == "jsonl") {
-                // Build read query with optional user-provided options
-                std::ostringstream read_query;
-                read_query << read_func << "('" << escape_sql(file_path) << "'";
-                if (!options.empty()) {
-                    read_query << ", " << options;
-                }
-                read_query << ")";
 
-                // Try to get column names
-                std::string test_query = "SELECT * FROM " + read_query.str() + " LIMIT 0";
-                auto test_result = conn.Query(test_query);
+    FileImportResult failure;
+    failure.table_name = table_name;
+    failure.file_name = "";
 
-                if (!test_result->HasError()) {
-                    // Success! Get column names
-                    for (idx_t i = 0; i < test_result->ColumnCount(); ++i) {
-                        orig_cols.push_back(test_result->ColumnName(i));
-                    }
-                    final_read_query = read_query.str();
-                    success = true;
-                } else if (type_lower == "xlsx" || type_lower == "excel") {
-                    // For Excel: retry with all_varchar=true if type detection failed
-                    // This handles mixed-type columns (e.g. numbers + "Summen" summary rows)
-                    std::string first_error = test_result->GetError();
-
-                    std::ostringstream retry_query;
-                    retry_query << read_func << "('" << escape_sql(file_path) << "', all_varchar=true";
-                    if (!options.empty()) {
-                        // Append user options but skip if they already set all_varchar
-                        std::string opts_lower = options;
-                        std::transform(opts_lower.begin(), opts_lower.end(), opts_lower.begin(), ::tolower);
-                        if (opts_lower.find("all_varchar") == std::string::npos) {
-                            retry_query << ", " << options;
-                        }
-                    }
-                    retry_query << ")";
+    // Build the source relation and probe its schema
+    std::string source;
+    std::vector<std::string> orig_cols;
+    std::vector<LogicalType> orig_types;
+    std::map<std::string, EncodingGuess> file_guesses;  // CSV/TSV only
+    std::map<std::string, std::string> file_readers;    // encoding name the file was read with
+    Utf8Copies copies;                                   // read by source until the table is created
 
-                    std::string retry_test = "SELECT * FROM " + retry_query.str() + " LIMIT 0";
-                    auto retry_result = conn.Query(retry_test);
+    if (type_lower == "xlsx" || type_lower == "excel") {
+        // read_xlsx has no multi-file support: combine per-file scans with UNION ALL BY NAME.
+        // Read as VARCHAR so a mixed-type column in one workbook can't fail the whole union.
+        std::string opts_lower = options;
+        std::transform(opts_lower.begin(), opts_lower.end(), opts_lower.begin(), ::tolower);
+        std::ostringstream ss;
+        ss << "(";
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (i > 0) ss << " UNION ALL BY NAME ";
+            std::string file_path = join_path(folder, files[i]);
+            ss << "SELECT *, '" << escape_sql(file_path) << "' AS \"__source_file\" FROM read_xlsx('"
+               << escape_sql(file_path) << "'";
+            if (opts_lower.find("all_varchar") == std::string::npos) {
+                ss << ", all_varchar=true";
+            }
+            ss << extra_opts << ")";
+        }
+        ss << ")";
+        source = ss.str();
 
-                    if (!retry_result->HasError()) {
-                        for (idx_t i = 0; i < retry_result->ColumnCount(); ++i) {
-                            orig_cols.push_back(retry_result->ColumnName(i));
-                        }
-                        final_read_query = retry_query.str();
-                        success = true;
-                    } else {
-                        result.row_count = 0;
-                        result.column_count = 0;
-                        result.status = "Load failed: " + first_error;
-                        results.push_back(result);
-                        continue;
-                    }
-                } else {
-                    result.row_count = 0;
-                    result.column_count = 0;
-                    result.status = "Load failed: " + test_result->GetError();
-                    results.push_back(result);
-                    continue;
-                }
-            } else {
-                // For CSV/TXT/TSV, try different encodings
-                std::vector<std::string> encodings_to_try = {
-                    "UTF-8",                    // Most common modern encoding
-                    "ISO-8859-1",              // Latin-1, common for German
-                    "Windows-1252",            // Windows Western European
-                    "CP1252",                   // Windows-1252 alias
-                    "ISO_8859_1",              // ISO-8859-1 alias
-                    "8859_1",                  // ISO-8859-1 alias
-                    "latin-1",                 // ISO-8859-1 alias
-                    "ISO8859_1",               // ISO-8859-1 alias
-                    "windows-1252-2000",       // Windows-1252 variant
-                    "CP1250",                  // Windows Central European
-                    "ISO-8859-15",             // Latin-9
-                    "ISO_8859_15",             // ISO-8859-15 alias
-                    "8859_15",                 // ISO-8859-15 alias
-                    "ISO8859_15",              // ISO-8859-15 alias
-                    "Windows-1250",            // Windows Central European
-                    "windows-1250-2000",       // Windows-1250 variant
-                    "CP850",                   // DOS Western European
-                    "IBM_850",                 // CP850 alias
-                    "cp850",                   // CP850 lowercase
-                    "CP437",                   // DOS US
-                    "cp437",                   // CP437 lowercase
-                    "UTF-16",                  // UTF-16 (less common for CSV)
-                    "utf-16"                   // UTF-16 lowercase
-                };
-                
-                // Build extra user options string for CSV
-                std::string extra_opts;
-                if (!options.empty()) {
-                    extra_opts = ", " + options;
-                }
+        auto probe = conn.Query("SELECT * FROM " + source + " LIMIT 0");
+        if (probe->HasError()) {
+            failure.status = "Load failed: " + probe->GetError();
+            results.push_back(failure);
+            return results;
+        }
+        for (idx_t i = 0; i < probe->ColumnCount(); ++i) {
+            orig_cols.push_back(probe->ColumnName(i));
+            orig_types.push_back(probe->types[i]);
+        }
+    } else {
+        std::string read_func = get_read_function(file_type);
+        std::string read_opts = get_read_options(file_type);
+        std::string multi_opts = "union_by_name=true, filename='__source_file'";
 
-                for (const auto& enc : encodings_to_try) {
-                    std::ostringstream read_query;
-                    read_query << read_func << "('" << escape_sql(file_path) << "', " << read_opts;
-                    read_query << ", encoding='" << enc << "'" << extra_opts << ")";
+        bool is_text = !(type_lower == "parquet" || type_lower == "json" || type_lower == "jsonl");
 
-                    // Try to get column names with this encoding
-                    std::string test_query = "SELECT * FROM " + read_query.str() + " LIMIT 0";
-                    auto test_result = conn.Query(test_query);
+        // CSV/TSV: sniff each file's encoding from its bytes and scan each encoding group
+        // with one multi-file read_csv (a single read can only decode one encoding)
+        std::vector<std::string> group_encodings;
+        std::vector<std::vector<std::string>> group_files;
+        std::vector<std::vector<std::string>> group_candidates;
+        std::vector<bool> group_copied;
+        for (const auto& filename : files) {
+            std::string key;
+            std::vector<std::string> candidates(1, "");
+            if (is_text) {
+                EncodingGuess guess = detect_file_encoding(join_path(folder, filename));
+                file_guesses[filename] = guess;
+                key = guess.encoding;
+                candidates = guess.reader_names;
+            }
+            auto it = std::find(group_encodings.begin(), group_encodings.end(), key);
+            if (it == group_encodings.end()) {
+                group_encodings.push_back(key);
+                group_files.push_back(std::vector<std::string>(1, filename));
+                group_candidates.push_back(candidates);
+                group_copied.push_back(is_text && file_guesses[filename].utf8_copy);
+            } else {
+                group_files[it - group_encodings.begin()].push_back(filename);
+            }
+        }
 
-                    if (!test_result->HasError()) {
-                        // Success! Get column names
-                        for (idx_t i = 0; i < test_result->ColumnCount(); ++i) {
-                            orig_cols.push_back(test_result->ColumnName(i));
-                        }
-                        final_read_query = read_query.str();
-                        success = true;
-                        break;
+        std::vector<std::string> scans;
+        std::string last_error;
+        for (size_t g = 0; g < group_encodings.size(); ++g) {
+            std::string path_list = build_path_list(folder, group_files[g]);
+            if (group_copied[g]) {
+                std::vector<std::string> copy_names;
+                for (const auto& filename : group_files[g]) {
+                    std::string error;
+                    if (!copies.Add(join_path(folder, filename), filename, group_encodings[g], error)) {
+                        failure.status = "Load failed: " + error;
+                        results.push_back(failure);
+                        return results;
                     }
+                    copy_names.push_back(Utf8Copies::copy_name(filename));
+                }
+                path_list = build_path_list(copies.dir(), copy_names);
+            }
 
-                    // Check if it's an encoding error
-                    std::string error = test_result->GetError();
-                    if (error.find("unicode") == std::string::npos &&
-                        error.find("encoding") == std::string::npos &&
-                        error.find("utf-8") == std::string::npos) {
-                        // Not an encoding error, break and report
-                        break;
-                    }
+            std::string scan;
+            for (const auto& enc : group_candidates[g]) {
+                std::ostringstream read_query;
+                read_query << read_func << "(" << path_list;
+                if (!read_opts.empty()) {
+                    read_query << ", " << read_opts;
+                }
+                read_query << ", " << multi_opts;
+                if (!enc.empty()) {
+                    read_query << ", encoding='" << enc << "'";
                 }
+                read_query << extra_opts << ")";
 
-                // If all encodings failed, try with ignore_errors as last resort
-                if (!success) {
-                    std::vector<std::string> fallback_encodings = {
-                        "ISO-8859-1", "Windows-1252", "CP1252", "UTF-8", "CP850"
-                    };
-
-                    for (const auto& enc : fallback_encodings) {
-                        std::ostringstream read_query;
-                        read_query << read_func << "('" << escape_sql(file_path) << "', " << read_opts;
-                        read_query << ", encoding='" << enc << "', ignore_errors=true" << extra_opts << ")";
-
-                        // Try to get columns even with errors
-                        std::string test_query = "SELECT * FROM " + read_query.str() + " LIMIT 0";
-                        auto test_result = conn.Query(test_query);
-                        if (!test_result->HasError()) {
-                            for (idx_t i = 0; i < test_result->ColumnCount(); ++i) {
-                                orig_cols.push_back(test_result->ColumnName(i));
-                            }
-                            final_read_query = read_query.str();
-                            success = true;
-                            break;
-                        }
+                // Binding only checks that the reader accepts the encoding name; no data is scanned
+                auto probe = conn.Query("SELECT * FROM " + read_query.str() + " LIMIT 0");
+                if (!probe->HasError()) {
+                    scan = read_query.str();
+                    if (group_copied[g]) {
+                        // Report the file's own path in source_file, not the copy's
+                        scan = "(SELECT * REPLACE ('" + escape_sql(folder) + "/' || " +
+                               copies.source_name_sql("__source_file") + " AS \"__source_file\") FROM " +
+                               scan + ")";
+                    }
+                    for (const auto& filename : group_files[g]) {
+                        file_readers[filename] = group_copied[g] ? group_encodings[g] : enc;
                     }
+                    break;
                 }
-                
-                if (!success) {
-                    result.row_count = 0;
-                    result.column_count = 0;
-                    result.status = "Load failed: Could not read file with any encoding";
-                    results.push_back(result);
-                    continue;
+
+                // Only keep trying encodings for encoding errors
+                last_error = probe->GetError();
+                if (!is_encoding_error(last_error)) {
+                    break;
                 }
             }
-            
+            if (scan.empty()) {
+                failure.status = "Load failed: " + last_error;
+                results.push_back(failure);
+                return results;
+            }
+            scans.push_back(scan);
+        }
+
+        if (scans.size() == 1) {
+            source = scans[0];
+        } else {
+            std::ostringstream ss;
+            ss << "(";
+            for (size_t g = 0; g < scans.size(); ++g) {
+                if (g > 0) ss << " UNION ALL BY NAME ";
+                ss << "SELECT * FROM " << scans[g];
+            }
+            ss << ")";
+            source = ss.str();
+        }
+
+        auto probe = conn.Query("SELECT * FROM " + source + " LIMIT 0");
+        if (probe->HasError()) {
+            failure.status = "Load failed: " + probe->GetError();
+            results.push_back(failure);
+            return results;
+        }
+        for (idx_t i = 0; i < probe->ColumnCount(); ++i) {
+            orig_cols.push_back(probe->ColumnName(i));
+            orig_types.push_back(probe->types[i]);
+        }
+    }
+
+    // Group source columns by normalized name (schema drift: "Konto Nr" vs "KontoNr")
+    std::vector<std::string> norm_order;
+    std::vector<std::vector<size_t>> norm_members;
+    for (size_t i = 0; i < orig_cols.size(); ++i) {
+        if (orig_cols[i] == "__source_file") {
+            continue;
+        }
+        std::string norm = to_snake_case(orig_cols[i]);
+        if (norm.empty()) {
+            norm = "column" + std::to_string(i);
+        }
+        auto it = std::find(norm_order.begin(), norm_order.end(), norm);
+        if (it == norm_order.end()) {
+            norm_order.push_back(norm);
+            norm_members.push_back(std::vector<size_t>(1, i));
+        } else {
+            norm_members[it - norm_order.begin()].push_back(i);
+        }
+    }
+
+    std::ostringstream sql;
+    sql << "CREATE OR REPLACE TABLE \"" << table_name << "\" AS SELECT ";
+    for (size_t n = 0; n < norm_order.size(); ++n) {
+        const auto& members = norm_members[n];
+        if (n > 0) sql << ", ";
+
+        if (members.size() == 1) {
+            sql << "\"" << escape_sql(orig_cols[members[0]]) << "\"";
+        } else {
+            // Same type everywhere: keep it; otherwise unify to VARCHAR
+            bool same_type = true;
+            for (size_t m = 1; m < members.size(); ++m) {
+                if (orig_types[members[m]] != orig_types[members[0]]) {
+                    same_type = false;
+                    break;
+                }
+            }
+            std::string target_type = same_type ? orig_types[members[0]].ToString() : "VARCHAR";
+            sql << "COALESCE(";
+            for (size_t m = 0; m < members.size(); ++m) {
+                if (m > 0) sql << ", ";
+                sql << "CAST(\"" << escape_sql(orig_cols[members[m]]) << "\" AS " << target_type << ")";
+            }
+            sql << ")";
+        }
+        sql << " AS \"" << escape_sql(norm_order[n]) << "\"";
+    }
+    // Store the path relative to the import folder
+    sql << (norm_order.empty() ? "" : ", ");
+    sql << "substr(\"__source_file\", length('" << escape_sql(folder) << "/') + 1) AS \"source_file\"";
+    sql << " FROM " << source;
+
+    auto create_result = conn.Query(sql.str());
+    if (create_result->HasError()) {
+        failure.status = "Load failed: " + create_result->GetError();
+        results.push_back(failure);
+        return results;
+    }
+    bump_table_generation(conn, table_name);
+
+    std::map<size_t, LogicalType> no_native_columns;
+    clean_and_trim_columns(conn, table_name, no_native_columns);
+    std::string convert_error;
+    std::string status = "OK";
+    if (!infer_and_convert_types(conn, table_name, parse_column_types(config.column_types), no_native_columns,
+                                 convert_error)) {
+        status = TYPES_NOT_CONVERTED + convert_error;
+    }
+
+    int column_count = static_cast<int>(norm_order.size()) + 1;
+    auto desc_result = conn.Query("DESCRIBE \"" + table_name + "\"");
+    if (!desc_result->HasError()) {
+        column_count = static_cast<int>(desc_result->RowCount());
+    }
+    std::string column_types = describe_column_types(conn, table_name);
+
+    // One result row per source file with its share of the rows
+    std::map<std::string, int64_t> rows_per_file;
+    auto count_result = conn.Query("SELECT \"source_file\", COUNT(*) FROM \"" + table_name + "\" GROUP BY \"source_file\"");
+    if (!count_result->HasError()) {
+        for (idx_t i = 0; i < count_result->RowCount(); ++i) {
+            Value file_val = count_result->GetValue(0, i);
+            if (file_val.IsNull()) continue;
+            rows_per_file[file_val.GetValue<std::string>()] = count_result->GetValue(1, i).GetValue<int64_t>();
+        }
+    }
+
+    for (const auto& filename : files) {
+        FileImportResult r;
+        r.table_name = table_name;
+        r.file_name = filename;
+        auto it = rows_per_file.find(filename);
+        r.row_count = (it != rows_per_file.end()) ? it->second : 0;
+        r.column_count = column_count;
+        r.column_types = column_types;
+        r.status = status;
+        auto guess = file_guesses.find(filename);
+        if (guess != file_guesses.end()) {
+            r.encoding = canonical_encoding_name(file_readers[filename]);
+            r.encoding_confidence = (r.encoding == guess->second.encoding) ? guess->second.confidence : 0.0;
+        }
+        results.push_back(r);
+    }
+
+    return results;
+}
+
+// ============================================================================
+// Import manifest (incremental sync)
+// ============================================================================
+
+static const char* const MANIFEST_TABLE = "gdpdu_import_manifest";
+
+// Manifest row for one imported file
+struct ManifestEntry {
+    std::string table_name;
+    int64_t file_size;
+    int64_t file_mtime;
+    std::string content_hash;
+    int64_t row_count;
+    int column_count;
+
+    ManifestEntry() : file_size(-1), file_mtime(-1), row_count(0), column_count(0) {}
+};
+
+static bool ensure_manifest_table(Connection& conn, std::string& error) {
+    std::ostringstream sql;
+    sql << "CREATE TABLE IF NOT EXISTS " << MANIFEST_TABLE << " ("
+        << "folder VARCHAR, file_path VARCHAR, table_name VARCHAR, "
+        << "file_size BIGINT, file_mtime BIGINT, content_hash VARCHAR, "
+        << "row_count BIGINT, column_count INTEGER, imported_at TIMESTAMP, "
+        << "PRIMARY KEY (folder, file_path))";
+    auto result = conn.Query(sql.str());
+    if (result->HasError()) {
+        error = result->GetError();
+        return false;
+    }
+    return true;
+}
+
+// Manifest rows of one folder, keyed by relative file path
+static std::map<std::string, ManifestEntry> load_manifest(Connection& conn, const std::string& folder) {
+    std::map<std::string, ManifestEntry> manifest;
+    std::string sql = std::string("SELECT file_path, table_name, file_size, file_mtime, content_hash, row_count, column_count FROM ") +
+                      MANIFEST_TABLE + " WHERE folder = '" + escape_sql(folder) + "'";
+    auto result = conn.Query(sql);
+    if (result->HasError()) {
+        return manifest;
+    }
+    for (idx_t row = 0; row < result->RowCount(); ++row) {
+        ManifestEntry entry;
+        entry.table_name = result->GetValue(1, row).ToString();
+        entry.file_size = result->GetValue(2, row).IsNull() ? -1 : result->GetValue(2, row).GetValue<int64_t>();
+        entry.file_mtime = result->GetValue(3, row).IsNull() ? -1 : result->GetValue(3, row).GetValue<int64_t>();
+        entry.content_hash = result->GetValue(4, row).IsNull() ? "" : result->GetValue(4, row).ToString();
+        entry.row_count = result->GetValue(5, row).IsNull() ? 0 : result->GetValue(5, row).GetValue<int64_t>();
+        entry.column_count = result->GetValue(6, row).IsNull() ? 0 : result->GetValue(6, row).GetValue<int32_t>();
+        manifest[result->GetValue(0, row).ToString()] = entry;
+    }
+    return manifest;
+}
+
+static void record_manifest(Connection& conn, const std::string& folder, const DirectoryEntry& file,
+                            const std::string& table_name, const std::string& content_hash,
+                            int64_t row_count, int column_count) {
+    std::ostringstream sql;
+    sql << "INSERT OR REPLACE INTO " << MANIFEST_TABLE << " VALUES ("
+        << "'" << escape_sql(folder) << "', "
+        << "'" << escape_sql(file.relative_path) << "', "
+        << "'" << escape_sql(table_name) << "', "
+        << file.size << ", " << file.mtime << ", "
+        << "'" << content_hash << "', "
+        << row_count << ", " << column_count << ", "
+        << "now()::TIMESTAMP)";
+    conn.Query(sql.str());
+}
+
+static void remove_manifest(Connection& conn, const std::string& folder, const std::string& file_path) {
+    conn.Query(std::string("DELETE FROM ") + MANIFEST_TABLE + " WHERE folder = '" + escape_sql(folder) +
+               "' AND file_path = '" + escape_sql(file_path) + "'");
+}
+
+// MD5 of the file contents (hex), read in 1 MB chunks; empty string if the file cannot be read
+static std::string hash_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return "";
+    }
+    MD5Context md5;
+    std::vector<char> buffer(1 << 20);
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize got = in.gcount();
+        if (got > 0) {
+            md5.Add(reinterpret_cast<const_data_ptr_t>(buffer.data()), static_cast<idx_t>(got));
+        }
+    }
+    if (in.bad()) {
+        return "";
+    }
+    return md5.FinishHex();
+}
+
+// Tables of the current schema (used to notice tables dropped behind the manifest's back)
+static std::set<std::string> list_existing_tables(Connection& conn) {
+    std::set<std::string> tables;
+    auto result = conn.Query("SELECT table_name FROM duckdb_tables() "
+                             "WHERE database_name = current_database() AND schema_name = current_schema()");
+    if (!result->HasError()) {
+        for (idx_t row = 0; row < result->RowCount(); ++row) {
+            tables.insert(result->GetValue(0, row).ToString());
+        }
+    }
+    return tables;
+}
+
+// Clean, trim and type the columns of a freshly loaded table, then fill in row/column counts
+// and the chosen column types. native_columns: see load_xlsx_single_pass
+static void finalize_imported_table(Connection& conn, FileImportResult& result, size_t source_column_count,
+                                    const std::map<std::string, std::string>& type_overrides,
+                                    const std::map<size_t, LogicalType>& native_columns) {
+    clean_and_trim_columns(conn, result.table_name, native_columns);
+    std::string convert_error;
+    bool converted = infer_and_convert_types(conn, result.table_name, type_overrides, native_columns, convert_error);
+    
+    // Get row and column counts
+    auto count_result = conn.Query("SELECT COUNT(*) FROM \"" + result.table_name + "\"");
+    if (!count_result->HasError() && count_result->RowCount() > 0) {
+        result.row_count = count_result->GetValue(0, 0).GetValue<int64_t>();
+    }
+    
+    auto desc_result = conn.Query("DESCRIBE \"" + result.table_name + "\"");
+    if (!desc_result->HasError()) {
+        result.column_count = static_cast<int>(desc_result->RowCount());
+    } else {
+        result.column_count = static_cast<int>(source_column_count);
+    }
+    result.column_types = describe_column_types(conn, result.table_name);
+    
+    result.status = converted ? std::string("OK") : TYPES_NOT_CONVERTED + convert_error;
+}
+
+// Import a single file (path relative to folder) into its own table
+static FileImportResult import_single_file(
+    Connection& conn,
+    const std::string& norm_folder,
+    const std::string& filename,
+    const std::string& file_type,
+    const std::string& options,
+    const std::map<std::string, std::string>& type_overrides) {
+
+    std::string read_func = get_read_function(file_type);
+
+    FileImportResult result;
+    result.file_name = filename;
+    result.table_name = normalize_filename_to_table_name(filename);
+    
+    std::string file_path = join_path(norm_folder, filename);
+    std::string read_opts = get_read_options(file_type);
+    
+    try {
+        // Drop existing table if it exists
+        std::string drop_sql = "DROP TABLE IF EXISTS \"" + result.table_name + "\"";
+        conn.Query(drop_sql);
+        
+        // Parquet/JSON files are read directly without encoding detection
+        // Excel and CSV/TXT/TSV files are loaded by their own paths that create the table themselves
+        bool success = false;
+        bool loaded_directly = false;
+        std::string final_read_query;
+        std::vector<std::string> orig_cols;
+        std::map<size_t, LogicalType> native_columns;  // xlsx only
+        
+        std::string type_lower = file_type;
+        std::transform(type_lower.begin(), type_lower.end(), type_lower.begin(), ::tolower);
+        
+        if (type_lower == "xlsx" || type_lower == "excel") {
+            // Excel: a single parse of the sheet, native types kept per column
+            std::string error;
+            if (!load_xlsx_single_pass(conn, file_path, result.table_name, options, native_columns, error)) {
+                result.row_count = 0;
+                result.column_count = 0;
+                result.status = "Load failed: " + error;
+                return result;
+            }
+            loaded_directly = true;
+            success = true;
+        } else if (type_lower == "parquet" || type_lower == "json" || type_lower == "jsonl") {
+            // Build read query with optional user-provided options
+            std::ostringstream read_query;
+            read_query << read_func << "('" << escape_sql(file_path) << "'";
+            if (!options.empty()) {
+                read_query << ", " << options;
+            }
+            read_query << ")";
+
+            // Try to get column names
+            std::string test_query = "SELECT * FROM " + read_query.str() + " LIMIT 0";
+            auto test_result = conn.Query(test_query);
+
+            if (!test_result->HasError()) {
+                // Success! Get column names
+                for (idx_t i = 0; i < test_result->ColumnCount(); ++i) {
+                    orig_cols.push_back(test_result->ColumnName(i));
+                }
+                final_read_query = read_query.str();
+                success = true;
+            } else {
+                result.row_count = 0;
+                result.column_count = 0;
+                result.status = "Load failed: " + test_result->GetError();
+                return result;
+            }
+        } else {
+            // For CSV/TXT/TSV, choose the encoding from a byte sample and load with a single read_csv
+            EncodingGuess guess = detect_file_encoding(file_path);
+            result.encoding_confidence = guess.confidence;
+
+            // Build extra user options string for CSV
+            std::string extra_opts;
+            if (!options.empty()) {
+                extra_opts = ", " + options;
+            }
+
+            // CP850/Windows-1252 files are read from a UTF-8 copy (removed once the table exists)
+            Utf8Copies copies;
+            std::string read_path = file_path;
+            if (guess.utf8_copy) {
+                std::string error;
+                if (!copies.Add(file_path, filename, guess.encoding, error)) {
+                    result.row_count = 0;
+                    result.column_count = 0;
+                    result.status = "Load failed: " + error;
+                    return result;
+                }
+                read_path = join_path(copies.dir(), Utf8Copies::copy_name(filename));
+            }
+
+            // The first candidate is the detected encoding, then latin-1 (decodes any byte) if
+            // bytes past the sample turn out not to be UTF-8.
+            // Second pass: ignore_errors as last resort for rows that don't parse.
+            std::string last_error;
+            for (int pass = 0; pass < 2 && !success; ++pass) {
+                for (const auto& enc : guess.reader_names) {
+                    std::ostringstream read_query;
+                    read_query << read_func << "('" << escape_sql(read_path) << "', " << read_opts;
+                    read_query << ", encoding='" << enc << "'";
+                    if (pass == 1) {
+                        read_query << ", ignore_errors=true";
+                    }
+                    read_query << extra_opts << ")";
+
+                    auto create_result = conn.Query("CREATE TABLE \"" + result.table_name + "\" AS SELECT * FROM " + read_query.str());
+                    if (!create_result->HasError()) {
+                        result.encoding = guess.utf8_copy ? guess.encoding : canonical_encoding_name(enc);
+                        if (result.encoding != guess.encoding) {
+                            // Detection was overruled by the reader
+                            result.encoding_confidence = 0.0;
+                        }
+                        loaded_directly = true;
+                        success = true;
+                        break;
+                    }
+
+                    // Only move on to the next candidate for encoding errors
+                    last_error = create_result->GetError();
+                    if (!is_encoding_error(last_error)) {
+                        break;
+                    }
+                }
+            }
+
+            if (!success) {
+                result.row_count = 0;
+                result.column_count = 0;
+                result.status = "Load failed: " + last_error;
+                return result;
+            }
+        }
+        
+        if (loaded_directly) {
+            // Column names are normalized in place (catalog-only renames, no second scan)
+            orig_cols = rename_columns_to_snake_case(conn, result.table_name);
+        } else {
             // Build CREATE TABLE AS SELECT with normalized column names
             std::ostringstream sql;
             sql << "CREATE TABLE \"" << result.table_name << "\" AS ";
             sql << "SELECT ";
-            
+        
             if (!orig_cols.empty()) {
                 // Use column aliases to normalize names
                 for (size_t i = 0; i < orig_cols.size(); ++i) {
@@ -791,96 +1367,479 @@ std::vector<FileImportResult> import_folder(
             } else {
                 sql << "*";
             }
-            
+        
             sql << " FROM " << final_read_query;
-            
+        
             auto query_result = conn.Query(sql.str());
 
-            // If xlsx import failed (e.g. type mismatch like 'Summen' in DOUBLE column),
-            // retry with all_varchar=true and let infer_and_convert_types() handle typing
-            if (query_result->HasError() && (type_lower == "xlsx" || type_lower == "excel")) {
-                std::string data_error = query_result->GetError();
-
-                // Rebuild read query with all_varchar=true
-                std::ostringstream retry_read;
-                retry_read << read_func << "('" << escape_sql(file_path) << "', all_varchar=true";
-                if (!options.empty()) {
-                    std::string opts_lower = options;
-                    std::transform(opts_lower.begin(), opts_lower.end(), opts_lower.begin(), ::tolower);
-                    if (opts_lower.find("all_varchar") == std::string::npos) {
-                        retry_read << ", " << options;
-                    }
-                }
-                retry_read << ")";
+            if (query_result->HasError()) {
+                result.row_count = 0;
+                result.column_count = 0;
+                result.status = "Load failed: " + query_result->GetError();
+                return result;
+            }
+        }
 
-                // Re-detect columns with all_varchar
-                std::string retry_test = "SELECT * FROM " + retry_read.str() + " LIMIT 0";
-                auto retry_cols_result = conn.Query(retry_test);
+        finalize_imported_table(conn, result, orig_cols.size(), type_overrides, native_columns);
+    } catch (const std::exception& e) {
+        result.row_count = 0;
+        result.column_count = 0;
+        result.status = std::string("Load failed: ") + e.what();
+    }
+    
+    return result;
+}
 
-                if (!retry_cols_result->HasError()) {
-                    orig_cols.clear();
-                    for (idx_t i = 0; i < retry_cols_result->ColumnCount(); ++i) {
-                        orig_cols.push_back(retry_cols_result->ColumnName(i));
-                    }
+// Import one worksheet into its own table
+static FileImportResult import_sheet(
+    Connection& conn,
+    const std::string& file_path,
+    const std::string& sheet,
+    FileImportResult result,
+    const std::string& options,
+    const std::map<std::string, std::string>& type_overrides) {
 
-                    // Rebuild CREATE TABLE with new read query
-                    std::ostringstream retry_sql;
-                    retry_sql << "CREATE OR REPLACE TABLE \"" << result.table_name << "\" AS SELECT ";
-                    for (size_t i = 0; i < orig_cols.size(); ++i) {
-                        if (i > 0) retry_sql << ", ";
-                        std::string normalized_name = to_snake_case(orig_cols[i]);
-                        retry_sql << "\"" << escape_sql(orig_cols[i]) << "\" AS \"" << escape_sql(normalized_name) << "\"";
-                    }
-                    retry_sql << " FROM " << retry_read.str();
+    try {
+        conn.Query("DROP TABLE IF EXISTS \"" + result.table_name + "\"");
 
-                    query_result = conn.Query(retry_sql.str());
-                }
+        std::string sheet_opts = "sheet='" + escape_sql(sheet) + "'";
+        if (!options.empty()) {
+            sheet_opts += ", " + options;
+        }
+        std::string error;
+        std::map<size_t, LogicalType> native_columns;
+        if (!load_xlsx_single_pass(conn, file_path, result.table_name, sheet_opts, native_columns, error)) {
+            result.status = "Load failed: " + error;
+            return result;
+        }
+        std::vector<std::string> orig_cols = rename_columns_to_snake_case(conn, result.table_name);
+        finalize_imported_table(conn, result, orig_cols.size(), type_overrides, native_columns);
+    } catch (const std::exception& e) {
+        result.row_count = 0;
+        result.column_count = 0;
+        result.status = std::string("Load failed: ") + e.what();
+    }
+    return result;
+}
 
-                // If retry also failed, report the original error
-                if (query_result->HasError()) {
-                    result.row_count = 0;
-                    result.column_count = 0;
-                    result.status = "Load failed: " + data_error;
-                    results.push_back(result);
-                    continue;
+// Import the worksheets of a workbook matching sheet_filter (comma-separated globs, '*' = all)
+// into one table per sheet named "<file>__<sheet>". Sheets are parsed concurrently, each
+// worker on its own connection to the same database.
+static std::vector<FileImportResult> import_workbook_sheets(
+    Connection& conn,
+    const std::string& norm_folder,
+    const std::string& filename,
+    const std::string& options,
+    const std::string& sheet_filter,
+    const std::map<std::string, std::string>& type_overrides) {
+
+    std::vector<FileImportResult> results;
+    std::string file_path = join_path(norm_folder, filename);
+    std::string base_name = normalize_filename_to_table_name(filename);
+
+    std::string error;
+    std::vector<std::string> all_sheets = list_xlsx_sheets(file_path, error);
+    if (!error.empty()) {
+        FileImportResult r;
+        r.table_name = base_name;
+        r.file_name = filename;
+        r.status = "Load failed: " + error;
+        results.push_back(r);
+        return results;
+    }
+
+    std::vector<std::string> patterns = split_glob_list(sheet_filter);
+    std::vector<std::string> sheets;
+    for (const auto& sheet : all_sheets) {
+        for (const auto& pattern : patterns) {
+            if (glob_match(pattern, sheet)) {
+                sheets.push_back(sheet);
+                break;
+            }
+        }
+    }
+    if (sheets.empty()) {
+        FileImportResult r;
+        r.table_name = base_name;
+        r.file_name = filename;
+        r.status = "No sheets matching: " + sheet_filter;
+        results.push_back(r);
+        return results;
+    }
+
+    results.resize(sheets.size());
+    for (size_t i = 0; i < sheets.size(); ++i) {
+        std::string sheet_name = to_snake_case(sheets[i]);
+        if (sheet_name.empty()) {
+            sheet_name = "sheet" + std::to_string(i + 1);
+        }
+        results[i].table_name = base_name + "__" + sheet_name;
+        results[i].file_name = filename + "#" + sheets[i];
+    }
+
+    size_t thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+    thread_count = std::min<size_t>(std::min<size_t>(thread_count, 8), sheets.size());
+    std::atomic<size_t> next_sheet(0);
+    std::mutex worker_error_lock;
+    std::string worker_error;
+    auto worker = [&]() {
+        try {
+            Connection sheet_conn(*conn.context->db);
+            for (size_t i = next_sheet++; i < sheets.size(); i = next_sheet++) {
+                results[i] = import_sheet(sheet_conn, file_path, sheets[i], results[i], options, type_overrides);
+            }
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(worker_error_lock);
+            worker_error = e.what();
+        }
+    };
+
+    if (thread_count <= 1) {
+        for (size_t i = 0; i < sheets.size(); ++i) {
+            results[i] = import_sheet(conn, file_path, sheets[i], results[i], options, type_overrides);
+        }
+    } else {
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < thread_count; ++t) {
+            threads.push_back(std::thread(worker));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        // Sheets no worker got to (a worker could not open its connection)
+        for (auto& r : results) {
+            if (r.status.empty()) {
+                r.status = "Load failed: " + worker_error;
+            }
+        }
+    }
+    return results;
+}
+
+// Import one file: a single table, or one table per worksheet when a sheet filter is set for xlsx
+static std::vector<FileImportResult> import_file(
+    Connection& conn,
+    const std::string& norm_folder,
+    const std::string& filename,
+    const std::string& file_type,
+    const std::string& options,
+    const FolderImportConfig& config) {
+
+    std::string type_lower = lower_copy(file_type);
+    std::map<std::string, std::string> type_overrides = parse_column_types(config.column_types);
+    std::vector<FileImportResult> results;
+    if (!config.sheets.empty() && (type_lower == "xlsx" || type_lower == "excel")) {
+        results = import_workbook_sheets(conn, norm_folder, filename, options, config.sheets, type_overrides);
+    } else {
+        results.push_back(import_single_file(conn, norm_folder, filename, file_type, options, type_overrides));
+    }
+    for (const auto& r : results) {
+        // A table that kept its VARCHAR columns was replaced all the same
+        if (r.status == "OK" || r.status.compare(0, strlen(TYPES_NOT_CONVERTED), TYPES_NOT_CONVERTED) == 0) {
+            bump_table_generation(conn, r.table_name);
+        }
+    }
+    return results;
+}
+
+// A workbook imported sheet by sheet has several tables; the manifest keeps them comma-separated
+static std::vector<std::string> split_table_list(const std::string& tables) {
+    std::vector<std::string> result;
+    size_t start = 0;
+    while (start <= tables.size()) {
+        size_t comma = tables.find(',', start);
+        if (comma == std::string::npos) {
+            comma = tables.size();
+        }
+        if (comma > start) {
+            result.push_back(tables.substr(start, comma - start));
+        }
+        start = comma + 1;
+    }
+    return result;
+}
+
+static bool all_tables_exist(const std::string& tables, const std::set<std::string>& existing_tables) {
+    std::vector<std::string> names = split_table_list(tables);
+    for (const auto& name : names) {
+        if (existing_tables.count(name) == 0) {
+            return false;
+        }
+    }
+    return !names.empty();
+}
+
+// Record a file in the manifest once all of its tables imported cleanly
+// (a partial import is retried on the next sync)
+static void record_imported_file(Connection& conn, const std::string& folder, const DirectoryEntry& file,
+                                 const std::string& content_hash, const std::vector<FileImportResult>& imported) {
+    std::string tables;
+    int64_t row_count = 0;
+    int column_count = 0;
+    for (const auto& r : imported) {
+        if (r.status != "OK") {
+            return;
+        }
+        tables += (tables.empty() ? "" : ",") + r.table_name;
+        row_count += r.row_count;
+        column_count = std::max(column_count, r.column_count);
+    }
+    if (!tables.empty()) {
+        record_manifest(conn, folder, file, tables, content_hash, row_count, column_count);
+    }
+}
+
+// Sync mode: import only new or changed files, drop tables whose source file is gone.
+// A file counts as unchanged when size and mtime match the manifest; if only the mtime differs and
+// the content hash is the same (e.g. the file was touched or copied), only the manifest is updated.
+// Entries recorded without a hash (by watch_folder) are imported again in that case.
+// Files are read from norm_folder; the manifest is keyed by manifest_folder (the source URI for
+// zip:// and webdav:// sources, whose local copy changes from mount to mount).
+static std::vector<FileImportResult> import_folder_sync(
+    Connection& conn,
+    const std::string& norm_folder,
+    const std::string& manifest_folder,
+    const std::vector<DirectoryEntry>& entries,
+    const std::string& file_type,
+    const std::string& options,
+    const FolderImportConfig& config) {
+
+    std::vector<FileImportResult> results;
+
+    std::string error;
+    if (!ensure_manifest_table(conn, error)) {
+        FileImportResult r;
+        r.table_name = "(manifest)";
+        r.status = "Could not create " + std::string(MANIFEST_TABLE) + ": " + error;
+        results.push_back(r);
+        return results;
+    }
+
+    std::map<std::string, ManifestEntry> manifest = load_manifest(conn, manifest_folder);
+    std::set<std::string> existing_tables = list_existing_tables(conn);
+
+    for (const auto& entry : entries) {
+        auto known = manifest.find(entry.relative_path);
+        std::string file_path = join_path(norm_folder, entry.relative_path);
+        std::string content_hash;
+
+        if (known != manifest.end() && all_tables_exist(known->second.table_name, existing_tables)) {
+            const ManifestEntry& prev = known->second;
+            bool unchanged = (prev.file_size == entry.size && prev.file_mtime == entry.mtime);
+            if (!unchanged && prev.file_size == entry.size) {
+                // Same size, new mtime: compare contents before re-importing
+                content_hash = hash_file(file_path);
+                unchanged = !content_hash.empty() && content_hash == prev.content_hash;
+                if (unchanged) {
+                    record_manifest(conn, manifest_folder, entry, prev.table_name, content_hash,
+                                    prev.row_count, prev.column_count);
                 }
-            } else if (query_result->HasError()) {
-                result.row_count = 0;
-                result.column_count = 0;
-                result.status = "Load failed: " + query_result->GetError();
-                results.push_back(result);
+            }
+            if (unchanged) {
+                FileImportResult r;
+                r.table_name = prev.table_name;
+                r.file_name = entry.relative_path;
+                r.row_count = prev.row_count;
+                r.column_count = prev.column_count;
+                r.status = "Unchanged";
+                results.push_back(r);
                 continue;
             }
+        }
 
-            {
-                // Clean, trim, and infer types for all columns
-                clean_and_trim_columns(conn, result.table_name);
-                infer_and_convert_types(conn, result.table_name);
-                
-                // Get row and column counts
-                auto count_result = conn.Query("SELECT COUNT(*) FROM \"" + result.table_name + "\"");
-                if (!count_result->HasError() && count_result->RowCount() > 0) {
-                    result.row_count = count_result->GetValue(0, 0).GetValue<int64_t>();
+        // Hash before importing so a write during the import shows up as a change next run
+        if (content_hash.empty()) {
+            content_hash = hash_file(file_path);
+        }
+        std::vector<FileImportResult> imported = import_file(conn, norm_folder, entry.relative_path, file_type, options, config);
+        if (known != manifest.end()) {
+            // Drop tables of worksheets that no longer exist in the workbook
+            std::vector<std::string> old_tables = split_table_list(known->second.table_name);
+            for (const auto& old_table : old_tables) {
+                bool still_used = false;
+                for (const auto& r : imported) {
+                    still_used = still_used || r.table_name == old_table;
                 }
-                
-                auto desc_result = conn.Query("DESCRIBE \"" + result.table_name + "\"");
-                if (!desc_result->HasError()) {
-                    result.column_count = static_cast<int>(desc_result->RowCount());
-                } else {
-                    result.column_count = static_cast<int>(orig_cols.size());
+                if (!still_used) {
+                    conn.Query("DROP TABLE IF EXISTS \"" + old_table + "\"");
                 }
-                
-                result.status = "OK";
             }
-        } catch (const std::exception& e) {
-            result.row_count = 0;
-            result.column_count = 0;
-            result.status = std::string("Load failed: ") + e.what();
         }
-        
-        results.push_back(result);
+        record_imported_file(conn, manifest_folder, entry, content_hash, imported);
+        results.insert(results.end(), imported.begin(), imported.end());
+    }
+
+    // Files that disappeared: only manifest entries inside this walk's scope (same file type,
+    // top level unless recursive) count, and include/exclude/size/mtime filters only narrow
+    // what is imported, not what is considered deleted
+    std::set<std::string> present;
+    bool filtered = !config.include.empty() || !config.exclude.empty() ||
+                    config.min_size >= 0 || config.max_size >= 0 ||
+                    config.modified_after >= 0 || config.modified_before >= 0;
+    if (filtered) {
+        FolderImportConfig unfiltered;
+        unfiltered.recursive = config.recursive;
+        for (const auto& e : get_matching_files(norm_folder, file_type, unfiltered, false)) {
+            present.insert(e.relative_path);
+        }
+    } else {
+        for (const auto& e : entries) {
+            present.insert(e.relative_path);
+        }
     }
+
+    for (const auto& kv : manifest) {
+        const std::string& rel = kv.first;
+        if (present.count(rel) > 0 || !matches_file_type(rel, file_type)) {
+            continue;
+        }
+        if (!config.recursive && rel.find('/') != std::string::npos) {
+            continue;
+        }
+        for (const auto& table : split_table_list(kv.second.table_name)) {
+            conn.Query("DROP TABLE IF EXISTS \"" + table + "\"");
+        }
+        remove_manifest(conn, manifest_folder, rel);
+
+        FileImportResult r;
+        r.table_name = kv.second.table_name;
+        r.file_name = rel;
+        r.status = "Removed (source file deleted)";
+        results.push_back(r);
+    }
+
+    return results;
+}
+
+std::vector<FileImportResult> import_folder(
+    Connection& conn,
+    const std::string& folder_path,
+    const std::string& file_type,
+    const std::string& options,
+    const FolderImportConfig& config) {
     
+    std::vector<FileImportResult> results;
+
+    // Path traversal protection
+    std::string check_path = normalize_path(folder_path);
+    if (check_path.find("/../") != std::string::npos ||
+        check_path.find("../") == 0 ||
+        (check_path.size() >= 3 && check_path.substr(check_path.size() - 3) == "/..") ||
+        check_path == "..") {
+        FileImportResult r;
+        r.table_name = "(security)";
+        r.file_name = "";
+        r.row_count = 0;
+        r.column_count = 0;
+        r.status = "Path traversal detected: path contains '..' components";
+        results.push_back(r);
+        return results;
+    }
+
+    // zip:// and webdav:// sources are read from a local copy
+    SourceMount mount(folder_path, config.recursive);
+    if (!mount.ok()) {
+        FileImportResult r;
+        r.table_name = "(source)";
+        r.status = mount.error();
+        results.push_back(r);
+        return results;
+    }
+
+    // Normalize folder path
+    std::string norm_folder = normalize_path(mount.local_path());
+    
+    std::string mode_lower = config.mode;
+    std::transform(mode_lower.begin(), mode_lower.end(), mode_lower.begin(), ::tolower);
+    if (mode_lower.empty()) {
+        mode_lower = "tables";
+    }
+    if (mode_lower != "tables" && mode_lower != "union" && mode_lower != "sync") {
+        FileImportResult r;
+        r.table_name = "(mode)";
+        r.status = "Unknown mode: " + config.mode + " (expected 'tables', 'union' or 'sync')";
+        results.push_back(r);
+        return results;
+    }
+
+    // Get list of matching files (size/mtime are needed for the import manifest)
+    std::vector<DirectoryEntry> entries = get_matching_files(norm_folder, file_type, config, mode_lower == "sync");
+
+    // Sync runs even without files so that tables of deleted files are dropped
+    if (mode_lower == "sync") {
+        std::string manifest_folder = is_source_uri(folder_path) ? mount.uri() : norm_folder;
+        return import_folder_sync(conn, norm_folder, manifest_folder, entries, file_type, options, config);
+    }
+
+    if (entries.empty()) {
+        FileImportResult r;
+        r.table_name = "(no files)";
+        r.file_name = "";
+        r.row_count = 0;
+        r.column_count = 0;
+        r.status = "No matching files found for type: " + file_type;
+        results.push_back(r);
+        return results;
+    }
+
+    if (mode_lower == "union") {
+        std::vector<std::string> files;
+        for (const auto& entry : entries) {
+            files.push_back(entry.relative_path);
+        }
+        // Name the table after the URI, not after the local copy of the source
+        FolderImportConfig union_config = config;
+        if (union_config.table_name.empty() && is_source_uri(folder_path)) {
+            std::string uri = normalize_path(folder_path);
+            while (!uri.empty() && uri.back() == '/') {
+                uri.pop_back();
+            }
+            union_config.table_name = default_union_table_name(uri);
+        }
+        return import_folder_union(conn, norm_folder, files, file_type, options, union_config);
+    }
+
+    // Plain tables mode leaves the manifest alone: the first sync of the folder fills it
+    for (const auto& entry : entries) {
+        std::vector<FileImportResult> imported = import_file(conn, norm_folder, entry.relative_path, file_type, options, config);
+        results.insert(results.end(), imported.begin(), imported.end());
+    }
+    
+    return results;
+}
+
+std::vector<FileImportResult> import_files(
+    Connection& conn,
+    const std::string& folder_path,
+    const std::vector<std::string>& files,
+    const std::string& file_type,
+    const std::string& options,
+    const FolderImportConfig& config) {
+
+    std::vector<FileImportResult> results;
+    std::string norm_folder = normalize_path(folder_path);
+
+    std::string manifest_error;
+    bool have_manifest = ensure_manifest_table(conn, manifest_error);
+    for (const auto& filename : files) {
+        std::string file_path = join_path(norm_folder, filename);
+        DirectoryEntry entry;
+        entry.relative_path = filename;
+        if (!stat_file(file_path, entry)) {
+            FileImportResult r;
+            r.table_name = normalize_filename_to_table_name(filename);
+            r.file_name = filename;
+            r.status = "Load failed: file not found";
+            results.push_back(r);
+            continue;
+        }
+        // Recorded by size and mtime only; a later sync hashes the file if just the mtime changed
+        std::vector<FileImportResult> imported = import_file(conn, norm_folder, filename, file_type, options, config);
+        if (have_manifest) {
+            record_imported_file(conn, norm_folder, entry, "", imported);
+        }
+        results.insert(results.end(), imported.begin(), imported.end());
+    }
     return results;
 }
 
@@ -0,0 +1,464 @@
+#include "folder_watcher.hpp"
+#include "directory_walker.hpp"
+#include "duckdb/main/database.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace duckdb {
+
+// ============================================================================
+// Path helpers
+// ============================================================================
+
+static std::string normalize_watch_path(const std::string& path) {
+    std::string result = path;
+    std::replace(result.begin(), result.end(), '\\', '/');
+    while (result.size() > 1 && result.back() == '/') {
+        result.pop_back();
+    }
+    return result;
+}
+
+static bool has_hidden_component(const std::string& relative_path) {
+    size_t start = 0;
+    while (start < relative_path.size()) {
+        if (relative_path[start] == '.') {
+            return true;
+        }
+        size_t slash = relative_path.find('/', start);
+        if (slash == std::string::npos) {
+            break;
+        }
+        start = slash + 1;
+    }
+    return false;
+}
+
+static int64_t epoch_seconds_now() {
+    return static_cast<int64_t>(std::time(nullptr));
+}
+
+// ============================================================================
+// FolderWatch: one watcher thread
+// ============================================================================
+
+class FolderWatch {
+public:
+    FolderWatch(int64_t id, const shared_ptr<DatabaseInstance>& db, const FolderWatchConfig& config)
+        : id_(id), db_(db), db_ptr_(db.get()), config_(config), stop_(false) {
+        config_.folder = normalize_watch_path(config_.folder);
+        include_globs_ = split_glob_list(config_.import_config.include);
+        exclude_globs_ = split_glob_list(config_.import_config.exclude);
+        status_.watch_id = id;
+        status_.folder = config_.folder;
+        status_.file_type = config_.file_type;
+        status_.backend = "polling";
+        status_.active = true;
+    }
+
+    ~FolderWatch() {
+        Stop();
+    }
+
+    void Start() {
+        thread_ = std::thread(&FolderWatch::Run, this);
+    }
+
+    void Stop() {
+        stop_ = true;
+        wake_.notify_all();
+        if (thread_.joinable() && thread_.get_id() != std::this_thread::get_id()) {
+            thread_.join();
+        }
+    }
+
+    int64_t Id() const { return id_; }
+    const std::string& Folder() const { return config_.folder; }
+    bool BelongsTo(const DatabaseInstance* db) const { return db_ptr_ == db && !db_.expired(); }
+    bool Expired() const { return db_.expired(); }
+
+    FolderWatchStatus GetStatus() {
+        std::lock_guard<std::mutex> guard(lock_);
+        FolderWatchStatus status = status_;
+        status.queue_length = static_cast<int64_t>(pending_.size());
+        return status;
+    }
+
+private:
+    // A changed file waiting to settle
+    struct PendingFile {
+        int64_t size;
+        int64_t mtime;
+        std::chrono::steady_clock::time_point last_change;
+    };
+
+    // Is a changed path (relative to the folder) something this watcher imports?
+    bool Accept(const std::string& relative_path) const {
+        if (relative_path.empty() || has_hidden_component(relative_path)) {
+            return false;
+        }
+        if (!config_.import_config.recursive && relative_path.find('/') != std::string::npos) {
+            return false;
+        }
+        size_t slash = relative_path.find_last_of('/');
+        std::string name = (slash == std::string::npos) ? relative_path : relative_path.substr(slash + 1);
+        if (!matches_file_type(name, config_.file_type)) {
+            return false;
+        }
+        for (const auto& glob : exclude_globs_) {
+            if (glob_match(glob, relative_path)) {
+                return false;
+            }
+        }
+        if (include_globs_.empty()) {
+            return true;
+        }
+        for (const auto& glob : include_globs_) {
+            if (glob_match(glob, relative_path)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Enqueue(const std::string& relative_path) {
+        if (!Accept(relative_path)) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(lock_);
+        PendingFile& file = pending_[relative_path];
+        file.size = -1;
+        file.mtime = -1;
+        file.last_change = std::chrono::steady_clock::now();
+    }
+
+    void RecordResults(const std::vector<FileImportResult>& results) {
+        std::lock_guard<std::mutex> guard(lock_);
+        for (const auto& r : results) {
+            if (r.status == "Unchanged") {
+                continue;
+            }
+            status_.last_import = epoch_seconds_now();
+            status_.last_file = r.file_name;
+            status_.last_status = r.status;
+            if (r.status == "OK" || r.status.compare(0, 7, "Removed") == 0) {
+                if (r.status == "OK") {
+                    status_.imported_files++;
+                }
+            } else {
+                status_.failed_files++;
+                status_.last_error = r.file_name + ": " + r.status;
+            }
+        }
+    }
+
+    void RecordError(const std::string& error) {
+        std::lock_guard<std::mutex> guard(lock_);
+        status_.last_error = error;
+    }
+
+    // Full sync: imports new/changed files that settled, drops tables of deleted files
+    bool FullSync() {
+        auto db = db_.lock();
+        if (!db) {
+            return false;
+        }
+        FolderImportConfig sync_config = config_.import_config;
+        sync_config.mode = "sync";
+        if (config_.stable_seconds > 0) {
+            int64_t settled_before = epoch_seconds_now() - config_.stable_seconds;
+            if (sync_config.modified_before < 0 || settled_before < sync_config.modified_before) {
+                sync_config.modified_before = settled_before;
+            }
+        }
+        try {
+            Connection conn(*db);
+            RecordResults(import_folder(conn, config_.folder, config_.file_type, config_.options, sync_config));
+        } catch (const std::exception& e) {
+            RecordError(std::string("Sync failed: ") + e.what());
+        }
+        return true;
+    }
+
+    // Import pending files whose size and mtime haven't changed for stable_seconds
+    bool ImportSettledFiles() {
+        std::vector<std::string> settled;
+        {
+            std::lock_guard<std::mutex> guard(lock_);
+            auto now = std::chrono::steady_clock::now();
+            for (auto it = pending_.begin(); it != pending_.end();) {
+                DirectoryEntry entry;
+                if (!stat_file(config_.folder + "/" + it->first, entry)) {
+                    it = pending_.erase(it);  // deleted or renamed again
+                    continue;
+                }
+                if (entry.size != it->second.size || entry.mtime != it->second.mtime) {
+                    it->second.size = entry.size;
+                    it->second.mtime = entry.mtime;
+                    it->second.last_change = now;
+                } else if (now - it->second.last_change >= std::chrono::seconds(config_.stable_seconds)) {
+                    settled.push_back(it->first);
+                    it = pending_.erase(it);
+                    continue;
+                }
+                ++it;
+            }
+        }
+        if (settled.empty()) {
+            return true;
+        }
+
+        auto db = db_.lock();
+        if (!db) {
+            return false;
+        }
+        try {
+            Connection conn(*db);
+            RecordResults(import_files(conn, config_.folder, settled, config_.file_type, config_.options,
+                                       config_.import_config));
+        } catch (const std::exception& e) {
+            RecordError(std::string("Import failed: ") + e.what());
+        }
+        return true;
+    }
+
+    void Run() {
+#ifdef __linux__
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        std::map<int, std::string> watch_dirs;  // watch descriptor -> directory relative to the folder
+        const uint32_t file_mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_MODIFY;
+        auto add_watch = [&](const std::string& rel_dir) {
+            std::string path = rel_dir.empty() ? config_.folder : config_.folder + "/" + rel_dir;
+            int wd = inotify_add_watch(fd, path.c_str(), file_mask | IN_ONLYDIR);
+            if (wd >= 0) {
+                watch_dirs[wd] = rel_dir;
+            }
+            return wd >= 0;
+        };
+        if (fd >= 0 && !add_watch("")) {
+            close(fd);
+            fd = -1;
+        }
+        if (fd >= 0 && config_.import_config.recursive) {
+            for (const auto& dir : list_subdirectories(config_.folder, exclude_globs_)) {
+                add_watch(dir);
+            }
+        }
+        if (fd >= 0) {
+            std::lock_guard<std::mutex> guard(lock_);
+            status_.backend = "inotify";
+        }
+#endif
+
+        bool alive = FullSync();
+        auto last_sync = std::chrono::steady_clock::now();
+
+        // A closed database ends the watcher within a second, not only at its next import or sync
+        while (alive && !stop_ && !db_.expired()) {
+#ifdef __linux__
+            if (fd >= 0) {
+                struct pollfd pfd;
+                pfd.fd = fd;
+                pfd.events = POLLIN;
+                pfd.revents = 0;
+                if (poll(&pfd, 1, 1000) > 0 && (pfd.revents & POLLIN)) {
+                    alignas(struct inotify_event) char buffer[16384];
+                    ssize_t len;
+                    while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+                        for (char* p = buffer; p < buffer + len;) {
+                            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(p);
+                            p += sizeof(struct inotify_event) + event->len;
+
+                            if (event->mask & IN_Q_OVERFLOW) {
+                                // Events were dropped: let the next loop run a full sync
+                                last_sync = std::chrono::steady_clock::time_point();
+                                continue;
+                            }
+                            if (event->mask & IN_IGNORED) {
+                                watch_dirs.erase(event->wd);
+                                continue;
+                            }
+                            auto dir = watch_dirs.find(event->wd);
+                            if (dir == watch_dirs.end() || event->len == 0) {
+                                continue;
+                            }
+                            std::string name = event->name;
+                            std::string rel = dir->second.empty() ? name : dir->second + "/" + name;
+                            if (event->mask & IN_ISDIR) {
+                                // New subdirectory: watch it and pick up what was moved in with it
+                                if (config_.import_config.recursive && !has_hidden_component(rel) &&
+                                    (event->mask & (IN_CREATE | IN_MOVED_TO)) && add_watch(rel)) {
+                                    DirectoryWalkOptions walk;
+                                    walk.recursive = true;
+                                    for (const auto& entry : walk_directory(config_.folder + "/" + rel, walk)) {
+                                        Enqueue(rel + "/" + entry.relative_path);
+                                    }
+                                    for (const auto& sub : list_subdirectories(config_.folder + "/" + rel, exclude_globs_)) {
+                                        add_watch(rel + "/" + sub);
+                                    }
+                                }
+                                continue;
+                            }
+                            Enqueue(rel);
+                        }
+                    }
+                }
+            } else
+#endif
+            {
+                std::unique_lock<std::mutex> guard(lock_);
+                wake_.wait_for(guard, std::chrono::seconds(1), [this]() { return stop_.load(); });
+            }
+            if (stop_ || db_.expired()) {
+                break;
+            }
+
+            alive = ImportSettledFiles();
+            if (alive && std::chrono::steady_clock::now() - last_sync >= std::chrono::seconds(config_.poll_seconds)) {
+                alive = FullSync();
+                last_sync = std::chrono::steady_clock::now();
+            }
+        }
+
+#ifdef __linux__
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+        std::lock_guard<std::mutex> guard(lock_);
+        status_.active = false;
+    }
+
+    int64_t id_;
+    weak_ptr<DatabaseInstance> db_;
+    const DatabaseInstance* db_ptr_;  // identity only, never dereferenced
+    FolderWatchConfig config_;
+    std::vector<std::string> include_globs_;
+    std::vector<std::string> exclude_globs_;
+
+    std::mutex lock_;
+    std::condition_variable wake_;
+    std::atomic<bool> stop_;
+    std::thread thread_;
+    std::map<std::string, PendingFile> pending_;
+    FolderWatchStatus status_;
+};
+
+// ============================================================================
+// Registry of running watchers
+// ============================================================================
+
+namespace {
+
+struct WatchRegistry {
+    std::mutex lock;
+    std::vector<std::shared_ptr<FolderWatch>> watches;
+    int64_t next_id;
+
+    WatchRegistry() : next_id(1) {}
+
+    // Forget watchers whose database is gone. They are moved to expired rather than joined here:
+    // the caller declares expired before taking the registry lock, so the FolderWatch destructors
+    // (which join the threads) run after the lock is released, as in stop_folder_watch.
+    void Purge(std::vector<std::shared_ptr<FolderWatch>>& expired) {
+        for (auto it = watches.begin(); it != watches.end();) {
+            if ((*it)->Expired()) {
+                expired.push_back(*it);
+                it = watches.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+};
+
+} // namespace
+
+static WatchRegistry& watch_registry() {
+    static WatchRegistry registry;
+    return registry;
+}
+
+int64_t start_folder_watch(const shared_ptr<DatabaseInstance>& db, const FolderWatchConfig& config, std::string& error) {
+    std::string folder = normalize_watch_path(config.folder);
+    if (folder.empty()) {
+        error = "Folder path is empty";
+        return -1;
+    }
+    if (config.stable_seconds < 0 || config.poll_seconds <= 0) {
+        error = "stable_seconds must be >= 0 and poll_seconds > 0";
+        return -1;
+    }
+
+    std::vector<std::shared_ptr<FolderWatch>> expired;
+    WatchRegistry& registry = watch_registry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    registry.Purge(expired);
+    for (const auto& watch : registry.watches) {
+        if (watch->BelongsTo(db.get()) && watch->Folder() == folder) {
+            error = "Folder is already watched (watch_id " + std::to_string(watch->Id()) + ")";
+            return -1;
+        }
+    }
+
+    std::shared_ptr<FolderWatch> watch = std::make_shared<FolderWatch>(registry.next_id++, db, config);
+    watch->Start();
+    registry.watches.push_back(watch);
+    return watch->Id();
+}
+
+std::vector<int64_t> stop_folder_watch(DatabaseInstance& db, const std::string& folder) {
+    std::string norm_folder = normalize_watch_path(folder);
+    std::vector<std::shared_ptr<FolderWatch>> stopped;
+    std::vector<std::shared_ptr<FolderWatch>> expired;
+    {
+        WatchRegistry& registry = watch_registry();
+        std::lock_guard<std::mutex> guard(registry.lock);
+        registry.Purge(expired);
+        for (auto it = registry.watches.begin(); it != registry.watches.end();) {
+            if ((*it)->BelongsTo(&db) && (norm_folder.empty() || (*it)->Folder() == norm_folder)) {
+                stopped.push_back(*it);
+                it = registry.watches.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Join outside the registry lock: a watcher may be in the middle of an import
+    std::vector<int64_t> ids;
+    for (auto& watch : stopped) {
+        watch->Stop();
+        ids.push_back(watch->Id());
+    }
+    return ids;
+}
+
+std::vector<FolderWatchStatus> get_folder_watch_status(DatabaseInstance& db) {
+    std::vector<FolderWatchStatus> result;
+    std::vector<std::shared_ptr<FolderWatch>> expired;
+    WatchRegistry& registry = watch_registry();
+    std::lock_guard<std::mutex> guard(registry.lock);
+    registry.Purge(expired);
+    for (const auto& watch : registry.watches) {
+        if (watch->BelongsTo(&db)) {
+            result.push_back(watch->GetStatus());
+        }
+    }
+    return result;
+}
+
+} // namespace duckdb
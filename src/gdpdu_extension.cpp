@@ -3,14 +3,18 @@
 #include "gdpdu_exporter.hpp"
 #include "generic_xml_importer.hpp"
 #include "folder_importer.hpp"
+#include "folder_watcher.hpp"
 #include "xml_parser_config.hpp"
 #include "xml_parser_registration.hpp"
 #include "nextcloud_importer.hpp"
 #include "buchungsstapel_importer.hpp"
+#include "saldenliste.hpp"
 #include "duckdb.hpp"
 #include "duckdb/main/extension.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/timestamp.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/function/function_set.hpp"
 #include "duckdb/main/database.hpp"
@@ -38,6 +42,7 @@ struct NextcloudImportBindData : public TableFunctionData {
     std::string nextcloud_url;
     std::string username;
     std::string password;
+    NextcloudImportConfig config;
 };
 
 // Global state for Nextcloud import
@@ -149,6 +154,51 @@ static unique_ptr<FunctionData> NextcloudImportBind(
     bind_data->username = input.inputs[1].GetValue<string>();
     bind_data->password = input.inputs[2].GetValue<string>();
 
+    // Named parameters: recursive listing, change filter, zip cache, workers per pipeline stage and the queue size between stages
+    for (auto &kv : input.named_parameters) {
+        if (kv.second.IsNull()) continue;
+        auto param = StringUtil::Lower(kv.first);
+        if (param == "recursive") {
+            bind_data->config.recursive = kv.second.GetValue<bool>();
+            continue;
+        } else if (param == "since") {
+            // 'last' or a timestamp (UTC)
+            auto since = kv.second.GetValue<string>();
+            if (StringUtil::Lower(since) == "last") {
+                bind_data->config.since_last = true;
+            } else {
+                timestamp_t since_ts;
+                try {
+                    since_ts = Value(since).DefaultCastAs(LogicalType::TIMESTAMP).GetValue<timestamp_t>();
+                } catch (std::exception &) {
+                    throw InvalidInputException("import_gdpdu_nextcloud: since must be 'last' or a timestamp, got '" +
+                                                since + "'");
+                }
+                bind_data->config.since = Timestamp::GetEpochSeconds(since_ts);
+            }
+            continue;
+        } else if (param == "cache") {
+            bind_data->config.use_cache = kv.second.GetValue<bool>();
+            continue;
+        } else if (param == "cache_dir") {
+            bind_data->config.cache_dir = kv.second.GetValue<string>();
+            continue;
+        }
+        int64_t value = kv.second.GetValue<int64_t>();
+        if (value < 1) {
+            throw InvalidInputException("import_gdpdu_nextcloud: " + param + " must be at least 1");
+        }
+        if (param == "download_concurrency") {
+            bind_data->config.download_concurrency = static_cast<size_t>(value);
+        } else if (param == "extract_concurrency") {
+            bind_data->config.extract_concurrency = static_cast<size_t>(value);
+        } else if (param == "import_concurrency") {
+            bind_data->config.import_concurrency = static_cast<size_t>(value);
+        } else if (param == "queue_size") {
+            bind_data->config.queue_size = static_cast<size_t>(value);
+        }
+    }
+
     // Define return columns
     return_types.push_back(LogicalType::VARCHAR);  // table_name
     names.push_back("table_name");
@@ -179,7 +229,8 @@ static unique_ptr<GlobalTableFunctionState> NextcloudImportInit(
     auto &db = DatabaseInstance::GetDatabase(context);
     Connection conn(db);
 
-    state->results = import_from_nextcloud(conn, bind_data.nextcloud_url, bind_data.username, bind_data.password);
+    state->results = import_from_nextcloud(conn, bind_data.nextcloud_url, bind_data.username, bind_data.password,
+                                           bind_data.config);
     state->current_row = 0;
     state->done = state->results.empty();
 
@@ -461,6 +512,7 @@ static void LoadInternal(ExtensionLoader &loader) {
         std::string folder_path;
         std::string file_type;
         std::string options;
+        FolderImportConfig config;
     };
     
     // Global state for folder import
@@ -495,6 +547,35 @@ static void LoadInternal(ExtensionLoader &loader) {
         } else {
             bind_data->options = "";
         }
+
+        // Named parameters: mode := 'union', table_name := '...', file discovery filters
+        for (auto &kv : input.named_parameters) {
+            if (kv.second.IsNull()) continue;
+            auto param = StringUtil::Lower(kv.first);
+            if (param == "mode") {
+                bind_data->config.mode = kv.second.GetValue<string>();
+            } else if (param == "table_name") {
+                bind_data->config.table_name = kv.second.GetValue<string>();
+            } else if (param == "recursive") {
+                bind_data->config.recursive = kv.second.GetValue<bool>();
+            } else if (param == "include") {
+                bind_data->config.include = kv.second.GetValue<string>();
+            } else if (param == "exclude") {
+                bind_data->config.exclude = kv.second.GetValue<string>();
+            } else if (param == "min_size") {
+                bind_data->config.min_size = kv.second.GetValue<int64_t>();
+            } else if (param == "max_size") {
+                bind_data->config.max_size = kv.second.GetValue<int64_t>();
+            } else if (param == "modified_after") {
+                bind_data->config.modified_after = Timestamp::GetEpochSeconds(kv.second.GetValue<timestamp_t>());
+            } else if (param == "sheets") {
+                bind_data->config.sheets = kv.second.GetValue<string>();
+            } else if (param == "column_types") {
+                bind_data->config.column_types = kv.second.GetValue<string>();
+            } else if (param == "modified_before") {
+                bind_data->config.modified_before = Timestamp::GetEpochSeconds(kv.second.GetValue<timestamp_t>());
+            }
+        }
         
         // Define return columns
         return_types.push_back(LogicalType::VARCHAR);  // table_name
@@ -511,6 +592,15 @@ static void LoadInternal(ExtensionLoader &loader) {
         
         return_types.push_back(LogicalType::VARCHAR);  // status
         names.push_back("status");
+
+        return_types.push_back(LogicalType::VARCHAR);  // encoding
+        names.push_back("encoding");
+
+        return_types.push_back(LogicalType::DOUBLE);   // encoding_confidence
+        names.push_back("encoding_confidence");
+
+        return_types.push_back(LogicalType::VARCHAR);  // column_types
+        names.push_back("column_types");
         
         return std::move(bind_data);
     };
@@ -527,7 +617,7 @@ static void LoadInternal(ExtensionLoader &loader) {
         auto &db = DatabaseInstance::GetDatabase(context);
         Connection conn(db);
         
-        state->results = import_folder(conn, bind_data.folder_path, bind_data.file_type, bind_data.options);
+        state->results = import_folder(conn, bind_data.folder_path, bind_data.file_type, bind_data.options, bind_data.config);
         state->current_row = 0;
         state->done = state->results.empty();
         
@@ -555,6 +645,15 @@ static void LoadInternal(ExtensionLoader &loader) {
             output.SetValue(2, count, Value(result.row_count));
             output.SetValue(3, count, Value(static_cast<int32_t>(result.column_count)));
             output.SetValue(4, count, Value(result.status));
+            if (result.encoding.empty()) {
+                output.SetValue(5, count, Value(LogicalType::VARCHAR));
+                output.SetValue(6, count, Value(LogicalType::DOUBLE));
+            } else {
+                output.SetValue(5, count, Value(result.encoding));
+                output.SetValue(6, count, Value::DOUBLE(result.encoding_confidence));
+            }
+            output.SetValue(7, count, result.column_types.empty() ? Value(LogicalType::VARCHAR)
+                                                                  : Value(result.column_types));
             
             state.current_row++;
             count++;
@@ -597,9 +696,252 @@ static void LoadInternal(ExtensionLoader &loader) {
     );
     folder_import_set.AddFunction(folder_import_3args);
 
+    // Named parameters shared by all overloads
+    for (auto &func : folder_import_set.functions) {
+        func.named_parameters["mode"] = LogicalType::VARCHAR;
+        func.named_parameters["table_name"] = LogicalType::VARCHAR;
+        func.named_parameters["recursive"] = LogicalType::BOOLEAN;
+        func.named_parameters["include"] = LogicalType::VARCHAR;
+        func.named_parameters["exclude"] = LogicalType::VARCHAR;
+        func.named_parameters["min_size"] = LogicalType::BIGINT;
+        func.named_parameters["max_size"] = LogicalType::BIGINT;
+        func.named_parameters["modified_after"] = LogicalType::TIMESTAMP;
+        func.named_parameters["modified_before"] = LogicalType::TIMESTAMP;
+        func.named_parameters["sheets"] = LogicalType::VARCHAR;
+        func.named_parameters["column_types"] = LogicalType::VARCHAR;
+    }
+
     // Register with the extension loader
     loader.RegisterFunction(folder_import_set);
     
+    // Register watch_folder / unwatch_folder / gdpdu_watch_status functions
+    struct WatchFolderBindData : public TableFunctionData {
+        FolderWatchConfig config;
+        bool stop;
+    };
+
+    // One result row per started or stopped watcher
+    struct WatchFolderGlobalState : public GlobalTableFunctionState {
+        std::vector<int64_t> watch_ids;
+        std::vector<std::string> statuses;
+        std::string folder;
+        idx_t current_row;
+
+        WatchFolderGlobalState() : current_row(0) {}
+    };
+
+    auto WatchFolderBind = [](ClientContext &context,
+                              TableFunctionBindInput &input,
+                              vector<LogicalType> &return_types,
+                              vector<string> &names) -> unique_ptr<FunctionData> {
+        auto bind_data = make_uniq<WatchFolderBindData>();
+        bind_data->stop = false;
+        bind_data->config.folder = input.inputs[0].GetValue<string>();
+        if (input.inputs.size() > 1 && !input.inputs[1].IsNull()) {
+            bind_data->config.file_type = input.inputs[1].GetValue<string>();
+        }
+        if (input.inputs.size() > 2 && !input.inputs[2].IsNull()) {
+            bind_data->config.options = input.inputs[2].GetValue<string>();
+        }
+
+        auto &config = bind_data->config.import_config;
+        for (auto &kv : input.named_parameters) {
+            if (kv.second.IsNull()) continue;
+            auto param = StringUtil::Lower(kv.first);
+            if (param == "stable_seconds") {
+                bind_data->config.stable_seconds = kv.second.GetValue<int32_t>();
+            } else if (param == "poll_seconds") {
+                bind_data->config.poll_seconds = kv.second.GetValue<int32_t>();
+            } else if (param == "recursive") {
+                config.recursive = kv.second.GetValue<bool>();
+            } else if (param == "include") {
+                config.include = kv.second.GetValue<string>();
+            } else if (param == "exclude") {
+                config.exclude = kv.second.GetValue<string>();
+            } else if (param == "min_size") {
+                config.min_size = kv.second.GetValue<int64_t>();
+            } else if (param == "max_size") {
+                config.max_size = kv.second.GetValue<int64_t>();
+            } else if (param == "sheets") {
+                config.sheets = kv.second.GetValue<string>();
+            } else if (param == "column_types") {
+                config.column_types = kv.second.GetValue<string>();
+            }
+        }
+
+        return_types.push_back(LogicalType::BIGINT);
+        names.push_back("watch_id");
+        return_types.push_back(LogicalType::VARCHAR);
+        names.push_back("folder");
+        return_types.push_back(LogicalType::VARCHAR);
+        names.push_back("status");
+        return std::move(bind_data);
+    };
+
+    auto UnwatchFolderBind = [](ClientContext &context,
+                                TableFunctionBindInput &input,
+                                vector<LogicalType> &return_types,
+                                vector<string> &names) -> unique_ptr<FunctionData> {
+        auto bind_data = make_uniq<WatchFolderBindData>();
+        bind_data->stop = true;
+        if (!input.inputs.empty() && !input.inputs[0].IsNull()) {
+            bind_data->config.folder = input.inputs[0].GetValue<string>();
+        }
+
+        return_types.push_back(LogicalType::BIGINT);
+        names.push_back("watch_id");
+        return_types.push_back(LogicalType::VARCHAR);
+        names.push_back("folder");
+        return_types.push_back(LogicalType::VARCHAR);
+        names.push_back("status");
+        return std::move(bind_data);
+    };
+
+    // Starting/stopping happens once per query, in init (like the imports)
+    auto WatchFolderInit = [](ClientContext &context,
+                              TableFunctionInitInput &input) -> unique_ptr<GlobalTableFunctionState> {
+        auto state = make_uniq<WatchFolderGlobalState>();
+        auto &bind_data = input.bind_data->Cast<WatchFolderBindData>();
+        state->folder = bind_data.config.folder;
+
+        if (bind_data.stop) {
+            state->watch_ids = stop_folder_watch(DatabaseInstance::GetDatabase(context), bind_data.config.folder);
+            state->statuses.assign(state->watch_ids.size(), "Stopped");
+            if (state->watch_ids.empty()) {
+                state->watch_ids.push_back(-1);
+                state->statuses.push_back("Not watched");
+            }
+        } else {
+            std::string error;
+            int64_t id = start_folder_watch(context.db, bind_data.config, error);
+            state->watch_ids.push_back(id);
+            state->statuses.push_back(id < 0 ? error : "Watching");
+        }
+        return std::move(state);
+    };
+
+    auto WatchFolderScan = [](ClientContext &context,
+                              TableFunctionInput &data,
+                              DataChunk &output) -> void {
+        auto &state = data.global_state->Cast<WatchFolderGlobalState>();
+        idx_t count = 0;
+        while (state.current_row < state.watch_ids.size() && count < STANDARD_VECTOR_SIZE) {
+            int64_t id = state.watch_ids[state.current_row];
+            output.SetValue(0, count, id < 0 ? Value(LogicalType::BIGINT) : Value::BIGINT(id));
+            output.SetValue(1, count, state.folder.empty() ? Value(LogicalType::VARCHAR) : Value(state.folder));
+            output.SetValue(2, count, Value(state.statuses[state.current_row]));
+            state.current_row++;
+            count++;
+        }
+        output.SetCardinality(count);
+    };
+
+    TableFunctionSet watch_folder_set("watch_folder");
+    watch_folder_set.AddFunction(TableFunction("watch_folder", {LogicalType::VARCHAR},
+                                               WatchFolderScan, WatchFolderBind, WatchFolderInit));
+    watch_folder_set.AddFunction(TableFunction("watch_folder", {LogicalType::VARCHAR, LogicalType::VARCHAR},
+                                               WatchFolderScan, WatchFolderBind, WatchFolderInit));
+    watch_folder_set.AddFunction(TableFunction("watch_folder",
+                                               {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
+                                               WatchFolderScan, WatchFolderBind, WatchFolderInit));
+    for (auto &func : watch_folder_set.functions) {
+        func.named_parameters["stable_seconds"] = LogicalType::INTEGER;
+        func.named_parameters["poll_seconds"] = LogicalType::INTEGER;
+        func.named_parameters["recursive"] = LogicalType::BOOLEAN;
+        func.named_parameters["include"] = LogicalType::VARCHAR;
+        func.named_parameters["exclude"] = LogicalType::VARCHAR;
+        func.named_parameters["min_size"] = LogicalType::BIGINT;
+        func.named_parameters["max_size"] = LogicalType::BIGINT;
+        func.named_parameters["sheets"] = LogicalType::VARCHAR;
+        func.named_parameters["column_types"] = LogicalType::VARCHAR;
+    }
+    loader.RegisterFunction(watch_folder_set);
+
+    // unwatch_folder(path) stops one watcher, unwatch_folder() all of this database
+    TableFunctionSet unwatch_folder_set("unwatch_folder");
+    unwatch_folder_set.AddFunction(TableFunction("unwatch_folder", {},
+                                                 WatchFolderScan, UnwatchFolderBind, WatchFolderInit));
+    unwatch_folder_set.AddFunction(TableFunction("unwatch_folder", {LogicalType::VARCHAR},
+                                                 WatchFolderScan, UnwatchFolderBind, WatchFolderInit));
+    loader.RegisterFunction(unwatch_folder_set);
+
+    struct WatchStatusGlobalState : public GlobalTableFunctionState {
+        std::vector<FolderWatchStatus> rows;
+        idx_t current_row;
+
+        WatchStatusGlobalState() : current_row(0) {}
+    };
+
+    auto WatchStatusBind = [](ClientContext &context,
+                              TableFunctionBindInput &input,
+                              vector<LogicalType> &return_types,
+                              vector<string> &names) -> unique_ptr<FunctionData> {
+        return_types.push_back(LogicalType::BIGINT);
+        names.push_back("watch_id");
+        return_types.push_back(LogicalType::VARCHAR);
+        names.push_back("folder");
+        return_types.push_back(LogicalType::VARCHAR);
+        names.push_back("file_type");
+        return_types.push_back(LogicalType::VARCHAR);
+        names.push_back("backend");
+        return_types.push_back(LogicalType::BOOLEAN);
+        names.push_back("active");
+        return_types.push_back(LogicalType::BIGINT);
+        names.push_back("queue_length");
+        return_types.push_back(LogicalType::BIGINT);
+        names.push_back("imported_files");
+        return_types.push_back(LogicalType::BIGINT);
+        names.push_back("failed_files");
+        return_types.push_back(LogicalType::TIMESTAMP);
+        names.push_back("last_import");
+        return_types.push_back(LogicalType::VARCHAR);
+        names.push_back("last_file");
+        return_types.push_back(LogicalType::VARCHAR);
+        names.push_back("last_status");
+        return_types.push_back(LogicalType::VARCHAR);
+        names.push_back("last_error");
+        return make_uniq<TableFunctionData>();
+    };
+
+    auto WatchStatusInit = [](ClientContext &context,
+                              TableFunctionInitInput &input) -> unique_ptr<GlobalTableFunctionState> {
+        auto state = make_uniq<WatchStatusGlobalState>();
+        state->rows = get_folder_watch_status(DatabaseInstance::GetDatabase(context));
+        return std::move(state);
+    };
+
+    auto WatchStatusScan = [](ClientContext &context,
+                              TableFunctionInput &data,
+                              DataChunk &output) -> void {
+        auto &state = data.global_state->Cast<WatchStatusGlobalState>();
+        idx_t count = 0;
+        while (state.current_row < state.rows.size() && count < STANDARD_VECTOR_SIZE) {
+            auto &row = state.rows[state.current_row];
+            auto optional = [](const std::string &s) {
+                return s.empty() ? Value(LogicalType::VARCHAR) : Value(s);
+            };
+            output.SetValue(0, count, Value::BIGINT(row.watch_id));
+            output.SetValue(1, count, Value(row.folder));
+            output.SetValue(2, count, Value(row.file_type));
+            output.SetValue(3, count, Value(row.backend));
+            output.SetValue(4, count, Value::BOOLEAN(row.active));
+            output.SetValue(5, count, Value::BIGINT(row.queue_length));
+            output.SetValue(6, count, Value::BIGINT(row.imported_files));
+            output.SetValue(7, count, Value::BIGINT(row.failed_files));
+            output.SetValue(8, count, row.last_import < 0 ? Value(LogicalType::TIMESTAMP)
+                                                          : Value::TIMESTAMP(Timestamp::FromEpochSeconds(row.last_import)));
+            output.SetValue(9, count, optional(row.last_file));
+            output.SetValue(10, count, optional(row.last_status));
+            output.SetValue(11, count, optional(row.last_error));
+            state.current_row++;
+            count++;
+        }
+        output.SetCardinality(count);
+    };
+
+    TableFunction watch_status_func("gdpdu_watch_status", {}, WatchStatusScan, WatchStatusBind, WatchStatusInit);
+    loader.RegisterFunction(watch_status_func);
+
     // Register export_gdpdu table function
     // Bind data for export_gdpdu
     struct GdpduExportBindData : public TableFunctionData {
@@ -692,6 +1034,14 @@ static void LoadInternal(ExtensionLoader &loader) {
         NextcloudImportBind,
         NextcloudImportInit
     );
+    nextcloud_import_func.named_parameters["recursive"] = LogicalType::BOOLEAN;
+    nextcloud_import_func.named_parameters["since"] = LogicalType::VARCHAR;
+    nextcloud_import_func.named_parameters["download_concurrency"] = LogicalType::INTEGER;
+    nextcloud_import_func.named_parameters["extract_concurrency"] = LogicalType::INTEGER;
+    nextcloud_import_func.named_parameters["import_concurrency"] = LogicalType::INTEGER;
+    nextcloud_import_func.named_parameters["queue_size"] = LogicalType::INTEGER;
+    nextcloud_import_func.named_parameters["cache"] = LogicalType::BOOLEAN;
+    nextcloud_import_func.named_parameters["cache_dir"] = LogicalType::VARCHAR;
     nextcloud_import_set.AddFunction(nextcloud_import_func);
 
     loader.RegisterFunction(nextcloud_import_set);
@@ -702,6 +1052,9 @@ static void LoadInternal(ExtensionLoader &loader) {
     // Bind data for Buchungsstapel import
     struct BuchungsstapelBindData : public TableFunctionData {
         std::string folder_path;
+        bool recursive = false;
+        std::string mode = "tables";
+        std::string table_name;
     };
 
     // Global state for Buchungsstapel import
@@ -721,6 +1074,18 @@ static void LoadInternal(ExtensionLoader &loader) {
         auto bind_data = make_uniq<BuchungsstapelBindData>();
         bind_data->folder_path = input.inputs[0].GetValue<string>();
 
+        for (auto &kv : input.named_parameters) {
+            if (kv.second.IsNull()) continue;
+            auto param = StringUtil::Lower(kv.first);
+            if (param == "recursive") {
+                bind_data->recursive = kv.second.GetValue<bool>();
+            } else if (param == "mode") {
+                bind_data->mode = kv.second.GetValue<string>();
+            } else if (param == "table_name") {
+                bind_data->table_name = kv.second.GetValue<string>();
+            }
+        }
+
         return_types.push_back(LogicalType::VARCHAR);  // table_name
         names.push_back("table_name");
         return_types.push_back(LogicalType::VARCHAR);  // file_name
@@ -741,7 +1106,8 @@ static void LoadInternal(ExtensionLoader &loader) {
         auto &db = DatabaseInstance::GetDatabase(context);
         Connection conn(db);
 
-        state->results = import_buchungsstapel(conn, bind_data.folder_path);
+        state->results = import_buchungsstapel(conn, bind_data.folder_path, bind_data.recursive,
+                                               bind_data.mode, bind_data.table_name);
         state->current_row = 0;
         state->done = state->results.empty();
 
@@ -786,9 +1152,391 @@ static void LoadInternal(ExtensionLoader &loader) {
         BuchungsstapelBind,
         BuchungsstapelInit
     );
+    buchungsstapel_func.named_parameters["recursive"] = LogicalType::BOOLEAN;
+    buchungsstapel_func.named_parameters["mode"] = LogicalType::VARCHAR;
+    buchungsstapel_func.named_parameters["table_name"] = LogicalType::VARCHAR;
     buchungsstapel_set.AddFunction(buchungsstapel_func);
 
     loader.RegisterFunction(buchungsstapel_set);
+
+    // Register read_datev_extf table function
+    TableFunctionSet datev_extf_set("read_datev_extf");
+
+    // Bind data for DATEV EXTF import
+    struct DatevExtfBindData : public TableFunctionData {
+        std::string folder_path;
+        bool recursive = false;
+    };
+
+    // Global state for DATEV EXTF import
+    struct DatevExtfGlobalState : public GlobalTableFunctionState {
+        std::vector<BuchungsstapelImportResult> results;
+        idx_t current_row;
+        bool done;
+
+        DatevExtfGlobalState() : current_row(0), done(false) {}
+    };
+
+    // Bind function
+    auto DatevExtfBind = [](ClientContext &context,
+                            TableFunctionBindInput &input,
+                            vector<LogicalType> &return_types,
+                            vector<string> &names) -> unique_ptr<FunctionData> {
+        auto bind_data = make_uniq<DatevExtfBindData>();
+        bind_data->folder_path = input.inputs[0].GetValue<string>();
+
+        for (auto &kv : input.named_parameters) {
+            if (kv.second.IsNull()) continue;
+            auto param = StringUtil::Lower(kv.first);
+            if (param == "recursive") {
+                bind_data->recursive = kv.second.GetValue<bool>();
+            }
+        }
+
+        return_types.push_back(LogicalType::VARCHAR);  // table_name
+        names.push_back("table_name");
+        return_types.push_back(LogicalType::VARCHAR);  // file_name
+        names.push_back("file_name");
+        return_types.push_back(LogicalType::VARCHAR);  // format
+        names.push_back("format");
+        return_types.push_back(LogicalType::BIGINT);   // row_count
+        names.push_back("row_count");
+        return_types.push_back(LogicalType::VARCHAR);  // status
+        names.push_back("status");
+
+        return std::move(bind_data);
+    };
+
+    // Init function
+    auto DatevExtfInit = [](ClientContext &context,
+                            TableFunctionInitInput &input) -> unique_ptr<GlobalTableFunctionState> {
+        auto state = make_uniq<DatevExtfGlobalState>();
+        auto &bind_data = input.bind_data->Cast<DatevExtfBindData>();
+        auto &db = DatabaseInstance::GetDatabase(context);
+        Connection conn(db);
+
+        state->results = import_datev_extf(conn, bind_data.folder_path, bind_data.recursive);
+        state->current_row = 0;
+        state->done = state->results.empty();
+
+        return std::move(state);
+    };
+
+    // Scan function
+    auto DatevExtfScan = [](ClientContext &context,
+                            TableFunctionInput &data,
+                            DataChunk &output) -> void {
+        auto &state = data.global_state->Cast<DatevExtfGlobalState>();
+
+        if (state.done) return;
+
+        idx_t count = 0;
+        idx_t max_count = STANDARD_VECTOR_SIZE;
+
+        while (state.current_row < state.results.size() && count < max_count) {
+            auto &result = state.results[state.current_row];
+
+            output.SetValue(0, count, Value(result.table_name));
+            output.SetValue(1, count, Value(result.file_name));
+            output.SetValue(2, count, result.format.empty() ? Value(LogicalType::VARCHAR) : Value(result.format));
+            output.SetValue(3, count, Value(result.row_count));
+            output.SetValue(4, count, Value(result.status));
+
+            state.current_row++;
+            count++;
+        }
+
+        output.SetCardinality(count);
+
+        if (state.current_row >= state.results.size()) {
+            state.done = true;
+        }
+    };
+
+    // Single argument: read_datev_extf('/path/to/folder')
+    TableFunction datev_extf_func(
+        "read_datev_extf",
+        {LogicalType::VARCHAR},
+        DatevExtfScan,
+        DatevExtfBind,
+        DatevExtfInit
+    );
+    datev_extf_func.named_parameters["recursive"] = LogicalType::BOOLEAN;
+    datev_extf_set.AddFunction(datev_extf_func);
+
+    loader.RegisterFunction(datev_extf_set);
+
+    // Register gdpdu_saldenliste table function
+    TableFunctionSet saldenliste_set("gdpdu_saldenliste");
+
+    // Bind data for gdpdu_saldenliste
+    struct SaldenlisteBindData : public TableFunctionData {
+        SaldenlisteConfig config;
+    };
+
+    // Global state for gdpdu_saldenliste
+    struct SaldenlisteGlobalState : public GlobalTableFunctionState {
+        std::vector<SaldenlisteRow> rows;
+        idx_t current_row;
+        bool done;
+
+        SaldenlisteGlobalState() : current_row(0), done(false) {}
+    };
+
+    // Bind function
+    auto SaldenlisteBind = [](ClientContext &context,
+                              TableFunctionBindInput &input,
+                              vector<LogicalType> &return_types,
+                              vector<string> &names) -> unique_ptr<FunctionData> {
+        auto bind_data = make_uniq<SaldenlisteBindData>();
+        bind_data->config.table_name = input.inputs[0].GetValue<string>();
+        bind_data->config.from_date = input.inputs[1].ToString();
+        bind_data->config.to_date = input.inputs[2].ToString();
+
+        for (auto &kv : input.named_parameters) {
+            if (kv.second.IsNull()) continue;
+            auto param = StringUtil::Lower(kv.first);
+            if (param == "konto_column") {
+                bind_data->config.konto_column = kv.second.GetValue<string>();
+            } else if (param == "gegenkonto_column") {
+                bind_data->config.gegenkonto_column = kv.second.GetValue<string>();
+            } else if (param == "betrag_column") {
+                bind_data->config.betrag_column = kv.second.GetValue<string>();
+            } else if (param == "soll_haben_column") {
+                bind_data->config.soll_haben_column = kv.second.GetValue<string>();
+            } else if (param == "datum_column") {
+                bind_data->config.datum_column = kv.second.GetValue<string>();
+            } else if (param == "refresh") {
+                bind_data->config.refresh = kv.second.GetValue<bool>();
+            }
+        }
+
+        return_types.push_back(LogicalType::VARCHAR);          // konto
+        names.push_back("konto");
+        return_types.push_back(LogicalType::DECIMAL(38, 2));   // anfangssaldo
+        names.push_back("anfangssaldo");
+        return_types.push_back(LogicalType::DECIMAL(38, 2));   // soll
+        names.push_back("soll");
+        return_types.push_back(LogicalType::DECIMAL(38, 2));   // haben
+        names.push_back("haben");
+        return_types.push_back(LogicalType::DECIMAL(38, 2));   // endsaldo
+        names.push_back("endsaldo");
+
+        return std::move(bind_data);
+    };
+
+    // Init function: computes the Saldenliste (a report has no status column, so errors are raised)
+    auto SaldenlisteInit = [](ClientContext &context,
+                              TableFunctionInitInput &input) -> unique_ptr<GlobalTableFunctionState> {
+        auto state = make_uniq<SaldenlisteGlobalState>();
+        auto &bind_data = input.bind_data->Cast<SaldenlisteBindData>();
+        auto &db = DatabaseInstance::GetDatabase(context);
+        Connection conn(db);
+
+        SaldenlisteResult result = compute_saldenliste(conn, bind_data.config);
+        if (!result.error.empty()) {
+            throw InvalidInputException("gdpdu_saldenliste: " + result.error);
+        }
+        state->rows = std::move(result.rows);
+        state->current_row = 0;
+        state->done = state->rows.empty();
+
+        return std::move(state);
+    };
+
+    // Scan function
+    auto SaldenlisteScan = [](ClientContext &context,
+                              TableFunctionInput &data,
+                              DataChunk &output) -> void {
+        auto &state = data.global_state->Cast<SaldenlisteGlobalState>();
+
+        if (state.done) return;
+
+        idx_t count = 0;
+        idx_t max_count = STANDARD_VECTOR_SIZE;
+
+        while (state.current_row < state.rows.size() && count < max_count) {
+            auto &row = state.rows[state.current_row];
+
+            output.SetValue(0, count, Value(row.konto));
+            output.SetValue(1, count, row.anfangssaldo);
+            output.SetValue(2, count, row.soll);
+            output.SetValue(3, count, row.haben);
+            output.SetValue(4, count, row.endsaldo);
+
+            state.current_row++;
+            count++;
+        }
+
+        output.SetCardinality(count);
+
+        if (state.current_row >= state.rows.size()) {
+            state.done = true;
+        }
+    };
+
+    // gdpdu_saldenliste('ledger_table', DATE '2025-01-01', DATE '2025-03-31')
+    TableFunction saldenliste_func(
+        "gdpdu_saldenliste",
+        {LogicalType::VARCHAR, LogicalType::DATE, LogicalType::DATE},
+        SaldenlisteScan,
+        SaldenlisteBind,
+        SaldenlisteInit
+    );
+    saldenliste_func.named_parameters["konto_column"] = LogicalType::VARCHAR;
+    saldenliste_func.named_parameters["gegenkonto_column"] = LogicalType::VARCHAR;
+    saldenliste_func.named_parameters["betrag_column"] = LogicalType::VARCHAR;
+    saldenliste_func.named_parameters["soll_haben_column"] = LogicalType::VARCHAR;
+    saldenliste_func.named_parameters["datum_column"] = LogicalType::VARCHAR;
+    saldenliste_func.named_parameters["refresh"] = LogicalType::BOOLEAN;
+    saldenliste_set.AddFunction(saldenliste_func);
+
+    loader.RegisterFunction(saldenliste_set);
+
+    // Register gdpdu_reconcile_saldenliste table function
+    TableFunctionSet reconcile_set("gdpdu_reconcile_saldenliste");
+
+    // Bind data for gdpdu_reconcile_saldenliste
+    struct ReconcileBindData : public TableFunctionData {
+        SaldenlisteReconcileConfig config;
+    };
+
+    // Global state for gdpdu_reconcile_saldenliste
+    struct ReconcileGlobalState : public GlobalTableFunctionState {
+        std::vector<SaldenlisteDifference> rows;
+        idx_t current_row;
+        bool done;
+
+        ReconcileGlobalState() : current_row(0), done(false) {}
+    };
+
+    // Bind function
+    auto ReconcileBind = [](ClientContext &context,
+                            TableFunctionBindInput &input,
+                            vector<LogicalType> &return_types,
+                            vector<string> &names) -> unique_ptr<FunctionData> {
+        auto bind_data = make_uniq<ReconcileBindData>();
+        bind_data->config.ledger.table_name = input.inputs[0].GetValue<string>();
+        bind_data->config.xlsx_path = input.inputs[1].GetValue<string>();
+
+        for (auto &kv : input.named_parameters) {
+            if (kv.second.IsNull()) continue;
+            auto param = StringUtil::Lower(kv.first);
+            if (param == "sheet") {
+                bind_data->config.sheet = kv.second.GetValue<string>();
+            } else if (param == "from_date") {
+                bind_data->config.ledger.from_date = kv.second.ToString();
+            } else if (param == "to_date") {
+                bind_data->config.ledger.to_date = kv.second.ToString();
+            } else if (param == "tolerance") {
+                bind_data->config.tolerance = kv.second.GetValue<double>();
+            } else if (param == "konto_column") {
+                bind_data->config.ledger.konto_column = kv.second.GetValue<string>();
+            } else if (param == "gegenkonto_column") {
+                bind_data->config.ledger.gegenkonto_column = kv.second.GetValue<string>();
+            } else if (param == "betrag_column") {
+                bind_data->config.ledger.betrag_column = kv.second.GetValue<string>();
+            } else if (param == "soll_haben_column") {
+                bind_data->config.ledger.soll_haben_column = kv.second.GetValue<string>();
+            } else if (param == "datum_column") {
+                bind_data->config.ledger.datum_column = kv.second.GetValue<string>();
+            }
+        }
+
+        return_types.push_back(LogicalType::VARCHAR);          // konto
+        names.push_back("konto");
+        return_types.push_back(LogicalType::VARCHAR);          // bezeichnung
+        names.push_back("bezeichnung");
+        return_types.push_back(LogicalType::VARCHAR);          // status
+        names.push_back("status");
+        const char *amounts[] = {"workbook_soll", "ledger_soll", "delta_soll",
+                                 "workbook_haben", "ledger_haben", "delta_haben",
+                                 "workbook_saldo", "ledger_saldo", "delta_saldo"};
+        for (auto amount : amounts) {
+            return_types.push_back(LogicalType::DECIMAL(38, 2));
+            names.push_back(amount);
+        }
+
+        return std::move(bind_data);
+    };
+
+    // Init function: loads the workbook and compares it with the ledger
+    auto ReconcileInit = [](ClientContext &context,
+                            TableFunctionInitInput &input) -> unique_ptr<GlobalTableFunctionState> {
+        auto state = make_uniq<ReconcileGlobalState>();
+        auto &bind_data = input.bind_data->Cast<ReconcileBindData>();
+        auto &db = DatabaseInstance::GetDatabase(context);
+        Connection conn(db);
+
+        SaldenlisteReconcileResult result = reconcile_saldenliste(conn, bind_data.config);
+        if (!result.error.empty()) {
+            throw InvalidInputException("gdpdu_reconcile_saldenliste: " + result.error);
+        }
+        state->rows = std::move(result.rows);
+        state->current_row = 0;
+        state->done = state->rows.empty();
+
+        return std::move(state);
+    };
+
+    // Scan function
+    auto ReconcileScan = [](ClientContext &context,
+                            TableFunctionInput &data,
+                            DataChunk &output) -> void {
+        auto &state = data.global_state->Cast<ReconcileGlobalState>();
+
+        if (state.done) return;
+
+        idx_t count = 0;
+        idx_t max_count = STANDARD_VECTOR_SIZE;
+
+        while (state.current_row < state.rows.size() && count < max_count) {
+            auto &row = state.rows[state.current_row];
+
+            output.SetValue(0, count, Value(row.konto));
+            output.SetValue(1, count, row.bezeichnung.empty() ? Value() : Value(row.bezeichnung));
+            output.SetValue(2, count, Value(row.status));
+            output.SetValue(3, count, row.workbook_soll);
+            output.SetValue(4, count, row.ledger_soll);
+            output.SetValue(5, count, row.delta_soll);
+            output.SetValue(6, count, row.workbook_haben);
+            output.SetValue(7, count, row.ledger_haben);
+            output.SetValue(8, count, row.delta_haben);
+            output.SetValue(9, count, row.workbook_saldo);
+            output.SetValue(10, count, row.ledger_saldo);
+            output.SetValue(11, count, row.delta_saldo);
+
+            state.current_row++;
+            count++;
+        }
+
+        output.SetCardinality(count);
+
+        if (state.current_row >= state.rows.size()) {
+            state.done = true;
+        }
+    };
+
+    // gdpdu_reconcile_saldenliste('ledger_table', '/data/saldenliste.xlsx')
+    TableFunction reconcile_func(
+        "gdpdu_reconcile_saldenliste",
+        {LogicalType::VARCHAR, LogicalType::VARCHAR},
+        ReconcileScan,
+        ReconcileBind,
+        ReconcileInit
+    );
+    reconcile_func.named_parameters["sheet"] = LogicalType::VARCHAR;
+    reconcile_func.named_parameters["from_date"] = LogicalType::DATE;
+    reconcile_func.named_parameters["to_date"] = LogicalType::DATE;
+    reconcile_func.named_parameters["tolerance"] = LogicalType::DOUBLE;
+    reconcile_func.named_parameters["konto_column"] = LogicalType::VARCHAR;
+    reconcile_func.named_parameters["gegenkonto_column"] = LogicalType::VARCHAR;
+    reconcile_func.named_parameters["betrag_column"] = LogicalType::VARCHAR;
+    reconcile_func.named_parameters["soll_haben_column"] = LogicalType::VARCHAR;
+    reconcile_func.named_parameters["datum_column"] = LogicalType::VARCHAR;
+    reconcile_set.AddFunction(reconcile_func);
+
+    loader.RegisterFunction(reconcile_set);
 }
 
 // Extension class implementation for DuckDB 1.4+
@@ -1,6 +1,7 @@
 #include "gdpdu_importer.hpp"
 #include "gdpdu_parser.hpp"
 #include "gdpdu_table_creator.hpp"
+#include "data_source.hpp"
 #include <sstream>
 #include <algorithm>
 
@@ -148,7 +149,8 @@ static bool contains_path_traversal(const std::string& path) {
     return false;
 }
 
-std::vector<ImportResult> import_gdpdu_navision(Connection& conn, const std::string& directory_path, const std::string& column_name_field) {
+std::vector<ImportResult> import_gdpdu_navision(Connection& conn, const std::string& directory_path, const std::string& column_name_field,
+                                                const std::string& table_prefix) {
     std::vector<ImportResult> results;
 
     // Validate path against directory traversal
@@ -161,10 +163,22 @@ std::vector<ImportResult> import_gdpdu_navision(Connection& conn, const std::str
         return results;
     }
 
+    // zip:// and webdav:// sources are read from a local copy
+    SourceMount mount(directory_path);
+    if (!mount.ok()) {
+        ImportResult r;
+        r.table_name = "(source)";
+        r.row_count = 0;
+        r.status = mount.error();
+        results.push_back(r);
+        return results;
+    }
+    const std::string& local_path = mount.local_path();
+
     // Step 1: Parse index.xml
     GdpduSchema schema;
     try {
-        schema = parse_index_xml(directory_path, column_name_field);
+        schema = parse_index_xml(local_path, column_name_field);
     } catch (const std::exception& e) {
         ImportResult r;
         r.table_name = "(schema)";
@@ -173,6 +187,9 @@ std::vector<ImportResult> import_gdpdu_navision(Connection& conn, const std::str
         results.push_back(r);
         return results;
     }
+    for (auto& table : schema.tables) {
+        table.name = table_prefix + table.name;
+    }
     
     // Step 2: Create tables
     auto create_results = create_tables(conn, schema);
@@ -198,7 +215,7 @@ std::vector<ImportResult> import_gdpdu_navision(Connection& conn, const std::str
             results.push_back(result);
             continue;
         }
-        std::string data_path = join_path(directory_path, table.url);
+        std::string data_path = join_path(local_path, table.url);
         
         // Use DuckDB's native read_csv with:
         // - semicolon delimiter
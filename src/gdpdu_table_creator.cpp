@@ -4,6 +4,41 @@
 
 namespace duckdb {
 
+static const char* const VERSIONS_TABLE = "gdpdu_table_versions";
+
+// Escape single quotes for SQL string literals
+static std::string escape_sql(const std::string& value) {
+    std::string result;
+    result.reserve(value.size() + 10);
+    for (char c : value) {
+        if (c == '\'') {
+            result += "''";
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+void bump_table_generation(Connection& conn, const std::string& table_name) {
+    std::string name = "'" + escape_sql(table_name) + "'";
+    conn.Query(std::string("CREATE TABLE IF NOT EXISTS ") + VERSIONS_TABLE +
+               " (table_name VARCHAR, generation BIGINT, replaced_at TIMESTAMP)");
+    conn.Query(std::string("UPDATE ") + VERSIONS_TABLE + " SET generation = generation + 1, "
+               "replaced_at = now()::TIMESTAMP WHERE table_name = " + name);
+    conn.Query(std::string("INSERT INTO ") + VERSIONS_TABLE + " SELECT " + name + ", 1, now()::TIMESTAMP "
+               "WHERE NOT EXISTS (SELECT 1 FROM " + VERSIONS_TABLE + " WHERE table_name = " + name + ")");
+}
+
+int64_t get_table_generation(Connection& conn, const std::string& table_name) {
+    auto result = conn.Query(std::string("SELECT MAX(generation) FROM ") + VERSIONS_TABLE +
+                             " WHERE table_name = '" + escape_sql(table_name) + "'");
+    if (result->HasError() || result->RowCount() == 0 || result->GetValue(0, 0).IsNull()) {
+        return 0;
+    }
+    return result->GetValue(0, 0).GetValue<int64_t>();
+}
+
 std::string generate_create_table_sql(const TableDef& table) {
     std::ostringstream sql;
     sql << "CREATE TABLE \"" << table.name << "\" (";
@@ -52,6 +87,7 @@ TableCreateResult create_table(Connection& conn, const TableDef& table) {
             result.error_message = query_result->GetError();
         } else {
             result.success = true;
+            bump_table_generation(conn, table.name);
         }
     } catch (const std::exception& e) {
         result.success = false;
@@ -3,6 +3,7 @@
 #include "gdpdu_table_creator.hpp"
 #include "gdpdu_schema.hpp"
 #include "gdpdu_importer.hpp"
+#include "data_source.hpp"
 #include <sstream>
 #include <algorithm>
 
@@ -191,12 +192,24 @@ std::vector<ImportResult> import_xml_data(
         return results;
     }
     
+    // zip:// and webdav:// sources are read from a local copy
+    SourceMount mount(directory_path);
+    if (!mount.ok()) {
+        ImportResult r;
+        r.table_name = "(source)";
+        r.row_count = 0;
+        r.status = mount.error();
+        results.push_back(r);
+        return results;
+    }
+    const std::string& local_path = mount.local_path();
+
     // Step 2: Parse XML
     XmlSchema schema;
     try {
         XmlParserConfig parser_config = config;
         parser_config.parser_type = parser_type;
-        schema = parser->parse(directory_path, parser_config);
+        schema = parser->parse(local_path, parser_config);
     } catch (const std::exception& e) {
         ImportResult r;
         r.table_name = "(schema)";
@@ -231,7 +244,7 @@ std::vector<ImportResult> import_xml_data(
         }
         
         // Build data file path
-        std::string data_path = join_path(directory_path, xml_table.url);
+        std::string data_path = join_path(local_path, xml_table.url);
         
         // Use DuckDB's native read_csv
         std::ostringstream sql;
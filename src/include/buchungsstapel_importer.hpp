@@ -6,10 +6,11 @@
 
 namespace duckdb {
 
-// Result of importing a single Buchungsstapel file
+// Result of importing a single DATEV EXTF file
 struct BuchungsstapelImportResult {
     std::string table_name;
     std::string file_name;
+    std::string format;  // format category and version from the header, e.g. "Buchungsstapel v13"
     int64_t row_count;
     std::string status;  // "OK" or error message
 
@@ -17,19 +18,44 @@ struct BuchungsstapelImportResult {
 };
 
 // Import all DATEV Buchungsstapel EXTF CSV files from a folder
-// For each file:
-//   1. Parses header row (row 1) to extract year from Datum-von field
-//   2. Parses column names from row 2
+// Each file is read natively in one buffered pass:
+//   1. Header row (row 1): booking period from the Datum-von/Datum-bis fields
+//   2. Column names from row 2
 //   3. Creates a DuckDB table named after the file (without .csv extension)
-//   4. Loads data with type conversions:
-//      - Belegdatum: DDMM compact format -> DATE
-//      - Umsatz/Basis-Umsatz: German decimal (comma) -> DECIMAL(18,2)
+//   4. Streams the data rows into the table as typed vectors, types from the column table of
+//      the header's format category:
+//      - Belegdatum: DDMM compact format -> DATE (year from the booking period,
+//        rolling over to Datum-bis's year for months before Datum-von's month)
+//      - Umsatz/Basis-Umsatz/Skonto and other amounts: German decimal (comma) -> DECIMAL(18,2)
 //      - Kurs: German decimal -> DECIMAL(18,6)
-//      - All other columns: VARCHAR
+//      - Konto/Gegenkonto and other numbers: INTEGER, TTMMJJJJ dates: DATE, 0/1 flags: BOOLEAN
+//      - All other columns: VARCHAR (UTF-8, or converted from Windows-1252/CP850)
 //   5. Adds file_name column with the source filename
+// Rows whose amount, Kurs or Belegdatum doesn't parse are skipped; other invalid typed values
+// become NULL. The status reports both counts.
+// recursive: also pick up files from subdirectories
+// mode: "tables" (default) creates one table per file; "journal" loads all files in parallel into
+//   one table (table_name, default "buchungsstapel") with the union of their columns plus
+//   file_name, row_ordinal (record number within the file) and the header metadata
+//   stapel_datum_von, stapel_datum_bis, stapel_wj_beginn, stapel_berater, stapel_mandant,
+//   stapel_bezeichnung
 std::vector<BuchungsstapelImportResult> import_buchungsstapel(
     Connection& conn,
-    const std::string& folder_path
+    const std::string& folder_path,
+    bool recursive = false,
+    const std::string& mode = "tables",
+    const std::string& table_name = ""
+);
+
+// Import all DATEV EXTF files ("EXTF_*.csv") from a folder, one table per file as in
+// import_buchungsstapel's "tables" mode. Columns are typed by the header's format category:
+// Buchungsstapel (21), Debitoren/Kreditoren (16), Sachkontenbeschriftungen (20),
+// Zahlungsbedingungen (46) and Diverse Adressen (48); other categories load as VARCHAR.
+// Rows whose key (Konto, Nummer) doesn't parse are skipped.
+std::vector<BuchungsstapelImportResult> import_datev_extf(
+    Connection& conn,
+    const std::string& folder_path,
+    bool recursive = false
 );
 
 } // namespace duckdb
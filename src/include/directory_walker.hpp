@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// A regular file found by walk_directory()
+struct DirectoryEntry {
+    std::string relative_path;  // '/'-separated path relative to the walk root (e.g. "2024/01/report.csv")
+    std::string name;           // filename only (e.g. "report.csv")
+    int64_t size;               // bytes, -1 if the entry was not stat'ed
+    int64_t mtime;              // seconds since epoch, -1 if the entry was not stat'ed
+
+    DirectoryEntry() : size(-1), mtime(-1) {}
+};
+
+// Filters and settings for walk_directory()
+struct DirectoryWalkOptions {
+    bool recursive;                          // descend into subdirectories
+    std::vector<std::string> include_globs;  // keep only files matching one of these (empty = all)
+    std::vector<std::string> exclude_globs;  // drop files (and prune directories) matching one of these
+    int64_t min_size;                        // bytes, -1 = no limit
+    int64_t max_size;                        // bytes, -1 = no limit
+    int64_t min_mtime;                       // seconds since epoch, -1 = no limit
+    int64_t max_mtime;                       // seconds since epoch, -1 = no limit
+    bool need_stat;                          // fill size/mtime even when no size/mtime filter is set
+    int max_threads;                         // directories scanned in parallel when recursive
+
+    // Cheap filename check applied before any stat() call (e.g. extension match)
+    std::function<bool(const std::string&)> name_filter;
+
+    DirectoryWalkOptions()
+        : recursive(false), min_size(-1), max_size(-1), min_mtime(-1), max_mtime(-1),
+          need_stat(false), max_threads(8) {}
+};
+
+// List regular files below root_path, sorted by relative path.
+// Hidden entries (leading '.') are skipped. On POSIX the dirent d_type is used to
+// classify entries, so stat() only runs for DT_UNKNOWN/symlinks or when size/mtime
+// are needed. Subdirectories are scanned by up to max_threads worker threads.
+std::vector<DirectoryEntry> walk_directory(const std::string& root_path, const DirectoryWalkOptions& options);
+
+// List all subdirectories below root_path (relative paths, sorted), skipping hidden and
+// excluded ones and not following directory symlinks
+std::vector<std::string> list_subdirectories(const std::string& root_path, const std::vector<std::string>& exclude_globs);
+
+// Fill size/mtime of a single regular file; false if it doesn't exist or isn't a regular file
+bool stat_file(const std::string& path, DirectoryEntry& entry);
+
+// Case-insensitive glob match: '*' (within one path segment), '**' (across segments),
+// '?' and '[...]' / '[!...]' character classes.
+// Patterns without '/' are matched against the filename, others against the relative path.
+bool glob_match(const std::string& pattern, const std::string& relative_path);
+
+// Split a comma-separated glob list ("*.csv, 2024/**") into trimmed patterns
+std::vector<std::string> split_glob_list(const std::string& list);
+
+} // namespace duckdb
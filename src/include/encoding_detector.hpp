@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Result of sniffing a text file's encoding from its raw bytes
+struct EncodingGuess {
+    std::string encoding;                   // "UTF-8", "UTF-16", "ISO-8859-1", "Windows-1252" or "CP850"
+    double confidence;                      // 0.0 - 1.0
+    std::vector<std::string> reader_names;  // read_csv encoding names to try, best first
+    // CP850 and Windows-1252 are only known to read_csv with DuckDB's encodings extension:
+    // reader_names then apply to a UTF-8 copy of the file (see append_as_utf8)
+    bool utf8_copy;
+
+    EncodingGuess() : confidence(0.0), utf8_copy(false) {}
+};
+
+// Guess the encoding of a byte buffer.
+// Order of checks: BOM, UTF-8 validity, then German umlaut byte scoring to tell
+// CP850 (DOS exports) from ISO-8859-1/Windows-1252.
+// complete: the buffer holds the whole file (an all-ASCII sample is then certain)
+EncodingGuess detect_encoding(const char* data, size_t size, bool complete);
+
+// Guess the encoding of a file from a sample: the first 64 KB plus a few
+// 16 KB windows spread over the rest of the file
+EncodingGuess detect_file_encoding(const std::string& path);
+
+// Display name for a read_csv encoding name ("latin-1" -> "ISO-8859-1", "cp850" -> "CP850")
+std::string canonical_encoding_name(const std::string& reader_name);
+
+// True if the bytes are valid UTF-8
+bool is_valid_utf8(const char* data, size_t size);
+
+// Append single-byte text in encoding ("ISO-8859-1", "Windows-1252" or "CP850") to out as UTF-8
+void append_as_utf8(std::string& out, const char* data, size_t size, const std::string& encoding);
+
+} // namespace duckdb
@@ -13,18 +13,75 @@ struct FileImportResult {
     int64_t row_count;
     int column_count;
     std::string status;  // "OK" or error message
-    
-    FileImportResult() : row_count(0), column_count(0), status("") {}
+    std::string encoding;        // CSV/TSV: encoding used to read the file, empty for other types
+    double encoding_confidence;  // 0.0 - 1.0, how sure the byte-sample detection was
+    std::string column_types;    // "name TYPE, name TYPE" of the resulting table (column_types override format)
+
+    FileImportResult() : row_count(0), column_count(0), status(""), encoding_confidence(0.0) {}
+};
+
+// Additional import_folder settings (set via named parameters)
+struct FolderImportConfig {
+    // "tables" (default): one table per file
+    // "union": all matching files are loaded into one table with a source_file column
+    // "sync": like "tables", but only new or changed files are imported and tables of
+    //         deleted files are dropped (tracked in gdpdu_import_manifest)
+    std::string mode;
+    // Target table for union mode; defaults to the snake_case folder name
+    std::string table_name;
+
+    // File discovery filters (see DirectoryWalkOptions)
+    bool recursive;            // also import files from subdirectories
+    std::string include;       // comma-separated globs, e.g. "2024/**, *_final.csv"
+    std::string exclude;       // comma-separated globs; matching directories are skipped
+    int64_t min_size;          // bytes, -1 = no limit
+    int64_t max_size;          // bytes, -1 = no limit
+    int64_t modified_after;    // seconds since epoch, -1 = no limit
+    int64_t modified_before;   // seconds since epoch, -1 = no limit
+
+    // xlsx: comma-separated sheet name globs ("*" = all); each matching sheet becomes
+    // table "<file>__<sheet>". Empty = first sheet only, one table per file.
+    std::string sheets;
+
+    // Column type overrides in DDL form, e.g. "betrag DOUBLE, konto VARCHAR, kurs DECIMAL(18,6)";
+    // replaces the inferred type of these columns (names after snake_case conversion)
+    std::string column_types;
+
+    FolderImportConfig()
+        : mode("tables"), table_name(""), recursive(false), min_size(-1), max_size(-1),
+          modified_after(-1), modified_before(-1) {}
 };
 
 // Import all files from a folder
+// Files in subdirectories (recursive := true) get the relative path in file_name and
+// the path folded into the table name ("2024/01/report.csv" -> "2024_01_report")
+// Every file imported in "sync" mode is recorded in gdpdu_import_manifest
+// (folder, file_path, table_name, file_size, file_mtime, content_hash, row_count, column_count, imported_at);
+// "tables" and "union" don't touch it
 // options: optional DuckDB read options passed through to the reader
 //   e.g. "all_varchar=true" for xlsx, "delimiter=';'" for csv
 std::vector<FileImportResult> import_folder(
     Connection& conn,
     const std::string& folder_path,
     const std::string& file_type = "csv",
-    const std::string& options = ""
+    const std::string& options = "",
+    const FolderImportConfig& config = FolderImportConfig()
+);
+
+// Import the given files (paths relative to folder_path) one table per file as in "tables" mode,
+// recording them in gdpdu_import_manifest by size and mtime (no content hash). Used by
+// watch_folder for files that settled.
+std::vector<FileImportResult> import_files(
+    Connection& conn,
+    const std::string& folder_path,
+    const std::vector<std::string>& files,
+    const std::string& file_type,
+    const std::string& options = "",
+    const FolderImportConfig& config = FolderImportConfig()
 );
 
+// True if filename has an extension import_folder picks up for file_type
+// ("csv" also matches .txt, "xlsx" also .xls, "json" also .jsonl)
+bool matches_file_type(const std::string& filename, const std::string& file_type);
+
 } // namespace duckdb
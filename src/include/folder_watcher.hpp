@@ -0,0 +1,54 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "folder_importer.hpp"
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Settings of one watch_folder() call
+struct FolderWatchConfig {
+    std::string folder;
+    std::string file_type;
+    std::string options;                // read options passed through to the reader
+    FolderImportConfig import_config;   // discovery filters and sheets; files always get one table each
+    int stable_seconds;                 // import a file once size and mtime were unchanged this long
+    int poll_seconds;                   // interval of the full sync that catches missed events
+                                        // (the only trigger where inotify is unavailable)
+
+    FolderWatchConfig() : file_type("csv"), stable_seconds(5), poll_seconds(60) {}
+};
+
+// Snapshot of a watcher for gdpdu_watch_status()
+struct FolderWatchStatus {
+    int64_t watch_id;
+    std::string folder;
+    std::string file_type;
+    std::string backend;        // "inotify" or "polling"
+    bool active;
+    int64_t queue_length;       // changed files waiting to become stable
+    int64_t imported_files;
+    int64_t failed_files;
+    int64_t last_import;        // seconds since epoch, -1 = nothing imported yet
+    std::string last_file;
+    std::string last_status;
+    std::string last_error;
+
+    FolderWatchStatus()
+        : watch_id(0), active(false), queue_length(0), imported_files(0), failed_files(0), last_import(-1) {}
+};
+
+// Start a background watcher thread that imports files of config.folder as they land.
+// The watcher only holds a weak reference to the database and ends when it is closed.
+// On start, a sync (see import_folder mode 'sync') picks up files that changed while nobody watched.
+// Returns the watch id, or -1 with error set.
+int64_t start_folder_watch(const shared_ptr<DatabaseInstance>& db, const FolderWatchConfig& config, std::string& error);
+
+// Stop the watchers of db on folder (all watchers of db if folder is empty). Returns the stopped ids.
+std::vector<int64_t> stop_folder_watch(DatabaseInstance& db, const std::string& folder);
+
+// Status of all watchers of db
+std::vector<FolderWatchStatus> get_folder_watch_status(DatabaseInstance& db);
+
+} // namespace duckdb
@@ -23,7 +23,10 @@ struct ImportResult {
 // 3. Loads data from .txt files
 // Returns vector of results for each table
 // column_name_field: "Name" (default) or "Description" - which XML element to use for column names
-std::vector<ImportResult> import_gdpdu_navision(Connection& conn, const std::string& directory_path, const std::string& column_name_field = "Name");
+// table_prefix: prepended to every table name (e.g. "export2024_"), so several exports can be
+//   imported side by side, also concurrently on separate connections
+std::vector<ImportResult> import_gdpdu_navision(Connection& conn, const std::string& directory_path, const std::string& column_name_field = "Name",
+                                                const std::string& table_prefix = "");
 
 // Import DATEV GDPdU data from a directory
 // Similar to import_gdpdu_navision but optimized for DATEV export format:
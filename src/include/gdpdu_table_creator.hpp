@@ -27,4 +27,12 @@ TableCreateResult create_table(Connection& conn, const TableDef& table);
 // Generate CREATE TABLE SQL statement for a table
 std::string generate_create_table_sql(const TableDef& table);
 
+// Generation counter per table name in gdpdu_table_versions, saved with the database. Every
+// importer bumps it when it creates or replaces a table, so caches derived from a table (the
+// Saldenliste cache) can tell a re-import apart from the table they were computed from.
+void bump_table_generation(Connection& conn, const std::string& table_name);
+
+// Current generation of table_name; 0 for tables no importer created
+int64_t get_table_generation(Connection& conn, const std::string& table_name);
+
 } // namespace duckdb
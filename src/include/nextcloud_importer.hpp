@@ -2,6 +2,7 @@
 
 #include <string>
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 
 namespace duckdb {
@@ -13,23 +14,61 @@ struct NextcloudImportResult {
     std::string table_name;   // prefixed table name (e.g. "export2024_Buchungen")
     int64_t row_count;        // number of rows imported
     std::string status;       // "OK" or error description
-    std::string source_zip;   // original zip filename (e.g. "export2024.zip")
+    std::string source_zip;   // original zip filename, with its subfolder path when listed recursively
+                              // (e.g. "export2024.zip", "2024/01/export2024.zip")
 
     NextcloudImportResult() : row_count(0), status(""), source_zip("") {}
 };
 
+// Additional import_gdpdu_nextcloud settings (set via named parameters)
+struct NextcloudImportConfig {
+    bool recursive;               // also import zips from subfolders (e.g. "2024/01/export.zip")
+
+    // Change filter: since_last imports only zips not imported by an earlier import of this URL
+    // (path and ETag not recorded; without an ETag: modified after the newest recorded zip);
+    // since imports only zips modified after the given time (seconds since epoch, UTC), -1 = all zips
+    bool since_last;
+    int64_t since;
+
+    size_t download_concurrency;  // parallel downloads (and WebDAV connections)
+    size_t extract_concurrency;   // zips extracted at the same time
+    size_t import_concurrency;    // zips imported at the same time, each on its own connection
+    size_t queue_size;            // finished zips that may wait for the next stage
+
+    // Keep downloaded zips in a local cache keyed by ETag and size; a zip whose ETag is unchanged
+    // since the last run is taken from the cache instead of downloaded again
+    bool use_cache;
+    std::string cache_dir;        // empty = "cache" in the download directory of the URL; else a
+                                  // subdirectory per URL (url_directory_name) is used below it
+
+    NextcloudImportConfig()
+        : recursive(false), since_last(false), since(-1), download_concurrency(2), extract_concurrency(1), import_concurrency(1), queue_size(2),
+          use_cache(true) {}
+};
+
 // Import all GDPdU exports from a Nextcloud folder
 // 1. Lists zip files via WebDAV
 // 2. Downloads each zip to temp directory
 // 3. Extracts zip contents
 // 4. Imports tables with prefixed names
-// 5. Returns aggregated results
+// 5. Returns aggregated results, in listing order
+// Steps 2-4 run as a pipeline: each stage has its own workers and hands zips to the next stage
+// through a bounded queue, so later zips download while earlier ones are extracted and imported.
+// A full queue holds up the stage before it, which bounds the temp disk space in use.
+// With use_cache, downloaded zips are moved to the cache directory as "<16 hex digits: hash of
+// ETag and size>.zip" and kept there; entries of zips no longer in the listing (or changed) are
+// removed at the end. Files not named like a cache entry are never removed.
+// Every zip whose tables all imported is recorded in gdpdu_nextcloud_watermark
+// (url, zip_path, etag, file_size, last_modified, imported_at), the high-water mark since_last
+// compares against. Zips left out by the change filter are reported as "(skipped)" and cost no
+// transfer.
 // Uses skip-and-continue pattern: failed zips produce error results but don't abort the batch
 std::vector<NextcloudImportResult> import_from_nextcloud(
     Connection& conn,
     const std::string& nextcloud_url,
     const std::string& username,
-    const std::string& password
+    const std::string& password,
+    const NextcloudImportConfig& config = NextcloudImportConfig()
 );
 
 } // namespace duckdb
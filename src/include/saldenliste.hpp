@@ -0,0 +1,83 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// Settings of one gdpdu_saldenliste() call
+struct SaldenlisteConfig {
+    std::string table_name;   // ledger table (Buchungsstapel, Sachposten, ...)
+    std::string from_date;    // YYYY-MM-DD, widened to the first of its month
+    std::string to_date;      // YYYY-MM-DD, widened to the end of its month
+
+    // Ledger columns; empty = detected from the column names (see README)
+    std::string konto_column;
+    std::string gegenkonto_column;     // only used together with a Soll/Haben column
+    std::string betrag_column;
+    std::string soll_haben_column;     // 'S'/'H'; without it betrag is signed (> 0 = Soll)
+    std::string datum_column;
+
+    bool refresh;  // drop the cached months of this ledger and recompute them
+
+    SaldenlisteConfig() : refresh(false) {}
+};
+
+// One account of the Saldenliste; amounts are DECIMAL(38,2) values
+struct SaldenlisteRow {
+    std::string konto;
+    Value anfangssaldo;  // balance of all bookings before from_date's month
+    Value soll;          // debits within the period
+    Value haben;         // credits within the period
+    Value endsaldo;      // anfangssaldo + soll - haben
+};
+
+struct SaldenlisteResult {
+    std::vector<SaldenlisteRow> rows;
+    std::string error;  // empty on success
+};
+
+// Compute a Saldenliste (trial balance) per account over [from_date, to_date] in whole months.
+// Each booking counts for its account and, with a Soll/Haben column, the opposite side for its
+// Gegenkonto. Monthly sums per account are kept in gdpdu_saldenliste_cache
+// (source_table, definition, monat, konto, soll, haben, computed_at); a call only recomputes the
+// months from the newest cached month up to to_date, earlier months are taken from the cache.
+SaldenlisteResult compute_saldenliste(Connection& conn, const SaldenlisteConfig& config);
+
+// Settings of one gdpdu_reconcile_saldenliste() call
+struct SaldenlisteReconcileConfig {
+    // Ledger table and column overrides; from_date/to_date are optional here (empty = all bookings)
+    SaldenlisteConfig ledger;
+    std::string xlsx_path;
+    std::string sheet;     // empty = first sheet
+    double tolerance;      // absolute difference still counted as equal
+
+    SaldenlisteReconcileConfig() : tolerance(0.0) {}
+};
+
+// One account whose ledger sums don't match the workbook; amounts are DECIMAL(38,2) values,
+// NULL on the workbook side for accounts missing there
+struct SaldenlisteDifference {
+    std::string konto;
+    std::string bezeichnung;
+    std::string status;  // "differs", "missing in ledger" or "missing in workbook"
+    Value workbook_soll, ledger_soll, delta_soll;
+    Value workbook_haben, ledger_haben, delta_haben;
+    Value workbook_saldo, ledger_saldo, delta_saldo;
+};
+
+struct SaldenlisteReconcileResult {
+    std::vector<SaldenlisteDifference> rows;
+    std::string error;  // empty on success
+};
+
+// Compare the ledger against a Saldenliste workbook (DATEV layout, columns A-H: Konto, Bezeichnung,
+// Soll and Haben of the month, Soll and Haben cumulated, EB-Wert, Saldo; rows without a numeric
+// Saldo such as headings are ignored). The workbook is loaded once, the ledger aggregated per
+// account in one scan and both hash-joined on the account number. Ledger Soll/Haben are compared
+// with the cumulated columns and EB-Wert + Soll - Haben with the Saldo; only accounts with a
+// difference above the tolerance are returned.
+SaldenlisteReconcileResult reconcile_saldenliste(Connection& conn, const SaldenlisteReconcileConfig& config);
+
+} // namespace duckdb
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -8,7 +11,14 @@ namespace duckdb {
 struct WebDavFile {
     std::string name;      // filename (e.g. "export2024.zip")
     std::string href;      // full path from PROPFIND response
+    std::string path;      // decoded path below the listed folder (e.g. "2024/01/export2024.zip")
     bool is_collection;    // true if directory
+    std::string etag;      // getetag as sent by the server (quotes included), empty if not reported
+    int64_t size;          // getcontentlength in bytes, -1 if not reported
+    std::string last_modified;  // getlastmodified as sent (e.g. "Tue, 15 Oct 2024 10:15:00 GMT")
+    int64_t modified_time;      // last_modified in seconds since epoch (UTC), -1 if not reported
+
+    WebDavFile() : is_collection(false), size(-1), modified_time(-1) {}
 };
 
 struct WebDavResult {
@@ -21,29 +31,85 @@ struct WebDavDownloadResult {
     bool success;
     std::string error_message;
     std::string local_path;     // path to downloaded file
+    int64_t bytes_written;      // size of the downloaded file
+    int64_t bytes_transferred;  // body bytes received by this call (less than bytes_written when resumed)
+    bool resumed;               // continued a partial download instead of starting over
+    std::string content_encoding;  // "gzip" or "deflate" if the body arrived compressed, else empty
+
+    WebDavDownloadResult() : success(false), bytes_written(0), bytes_transferred(0), resumed(false) {}
 };
 
 class WebDavClient {
 public:
     // Construct with Nextcloud base URL (e.g. "https://cloud.example.com/remote.php/dav/files/user/exports/")
-    // and credentials for HTTP Basic Auth
-    WebDavClient(const std::string& base_url, const std::string& username, const std::string& password);
+    // and credentials for HTTP Basic Auth.
+    // Requests reuse keep-alive connections from a pool of at most max_connections; concurrent
+    // calls (e.g. parallel downloads) each take their own connection and wait while all are busy.
+    WebDavClient(const std::string& base_url, const std::string& username, const std::string& password,
+                 size_t max_connections = 4);
+    ~WebDavClient();
 
     // List all files in the WebDAV folder. Returns only .zip files if filter_zips=true.
-    WebDavResult list_files(bool filter_zips = true);
+    // recursive also lists the files of all subfolders (sorted by path): with one Depth-infinity
+    // PROPFIND where the server supports it, otherwise by Depth-1 requests per folder, up to
+    // max_connections at a time. Responses are parsed while they stream in, one entry at a time.
+    WebDavResult list_files(bool filter_zips = true, bool recursive = false);
 
     // Download a single file to the specified local directory. Returns path to downloaded file.
-    WebDavDownloadResult download_file(const std::string& href, const std::string& local_dir);
+    // The body is streamed to disk through a fixed-size buffer (memory use doesn't grow with the
+    // file size) into "<file>.part" and synced to disk; the file gets its name once complete.
+    // expected_size and etag (from list_files) identify the version being fetched. If a transfer
+    // breaks off, the partial file and its ETag are kept and the download is resumed with a Range
+    // request (If-Range: only if the file is unchanged), also by a later call. Connection errors,
+    // 408/429 and 5xx are retried with exponential backoff (see set_retry_policy).
+    // Files that aren't compressed already (not .zip, .gz, .xlsx, ...) are requested with
+    // Accept-Encoding gzip/deflate and decoded while streaming to disk; bytes_transferred then
+    // counts the compressed bytes. Resumed requests always ask for the plain bytes.
+    WebDavDownloadResult download_file(const std::string& href, const std::string& local_dir,
+                                       int64_t expected_size = -1, const std::string& etag = "");
+
+    // Stream up to length bytes (-1: up to the end) of a file from offset to on_data, without
+    // writing it to disk. Uses a Range request; a server that ignores it is handled by skipping
+    // the leading bytes. An offset past the end reads nothing. No retries; false with error if the
+    // request fails or on_data returns false. A whole-file read may come compressed, as in download_file.
+    bool read_file(const std::string& href, int64_t offset, int64_t length,
+                   const std::function<bool(const char*, size_t)>& on_data, std::string& error);
+
+    // Attempts per download and the wait before the first retry, doubled for every further
+    // one (capped at 30s). Default: 5 attempts, 1000 ms.
+    void set_retry_policy(int max_attempts, int initial_backoff_ms);
+
+    // Ask for gzip/deflate-compressed listings and downloads (see download_file). Default: on.
+    void set_compression(bool enabled);
 
 private:
+    class ConnectionPool;
+    class PooledConnection;
+
     std::string base_url_;
     std::string username_;
     std::string password_;
     std::string proto_host_port_;  // e.g. "https://cloud.example.com"
     std::string base_path_;        // e.g. "/remote.php/dav/files/user/exports/"
+    std::unique_ptr<ConnectionPool> pool_;
+    size_t max_connections_;
+    int max_attempts_;
+    int initial_backoff_ms_;
+    bool compression_;
 
     std::string make_auth_header() const;
     void parse_url();
+
+    // PROPFIND on path with the given Depth header; each entry except path itself is passed to
+    // on_entry as soon as it is parsed. Returns the HTTP status (207 on success) or 0 if the
+    // request failed, with error set unless the status is 207.
+    int propfind(const std::string& path, const std::string& depth,
+                 const std::function<void(const WebDavFile&)>& on_entry, std::string& error);
+
+    // List the folders in pending and everything below them with Depth-1 requests, passing
+    // files to on_file (serialized). False with error on the first failing folder.
+    bool list_tree(std::vector<std::string> pending, const std::function<void(const WebDavFile&)>& on_file,
+                   std::string& error);
 };
 
 // Create a temporary directory for downloads. Returns the path.
@@ -51,6 +117,14 @@ private:
 // Cross-platform fallback: uses platform temp directory
 std::string create_temp_download_dir();
 
+// Directory name derived from a URL ("gdpdu_webdav_<hash>"), the same in every run
+std::string url_directory_name(const std::string& url);
+
+// Create (or reuse) the download directory for a WebDAV URL. Its name is derived from the URL,
+// so partial downloads an interrupted run left there are found and resumed by the next run.
+// Returns an empty string on failure.
+std::string get_download_dir(const std::string& url);
+
 // Remove a temporary directory and all its contents
 void cleanup_temp_dir(const std::string& dir_path);
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "miniz.hpp"
+
+#include <fstream>
 #include <string>
 #include <vector>
 
@@ -17,6 +20,16 @@ struct ZipExtractResult {
 // On error, returns result with success=false and error_message populated.
 ZipExtractResult extract_zip(const std::string& zip_path);
 
+// List the worksheet names of an .xlsx workbook in workbook order (chart sheets are skipped).
+// Only the zip directory, xl/workbook.xml and its relationships are read, not the sheets.
+// On error, returns an empty list and sets error.
+std::vector<std::string> list_xlsx_sheets(const std::string& xlsx_path, std::string& error);
+
+// Open zip for reads straight from file (opened in binary mode), so entries are decompressed
+// without loading the whole archive into memory. file must outlive zip; on success release
+// zip with mz_zip_reader_end().
+bool init_zip_file_reader(duckdb_miniz::mz_zip_archive& zip, std::ifstream& file);
+
 // Remove an extraction directory and all its contents.
 // Delegates to cleanup_temp_dir() from webdav_client.hpp.
 void cleanup_extract_dir(const std::string& dir_path);
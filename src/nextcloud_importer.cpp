@@ -2,9 +2,32 @@
 #include "webdav_client.hpp"
 #include "zip_extractor.hpp"
 #include "gdpdu_importer.hpp"
+#include "directory_walker.hpp"
 #include "duckdb.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#include <direct.h>
+#define mkdir(path, mode) _mkdir(path)
+#define rmdir(path) _rmdir(path)
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
 
 namespace duckdb {
 
@@ -58,19 +81,240 @@ static std::string sanitize_zip_prefix(const std::string& zip_filename) {
     return collapsed.substr(start, end - start);
 }
 
+// Blocking queue between two pipeline stages: push() waits while the queue is full,
+// pop() waits for an item and returns false once the queue is closed and drained
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(std::max<size_t>(1, capacity)), closed_(false) {}
+
+    void push(T item) {
+        std::unique_lock<std::mutex> guard(lock_);
+        not_full_.wait(guard, [this] { return items_.size() < capacity_; });
+        items_.push_back(std::move(item));
+        not_empty_.notify_one();
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> guard(lock_);
+        not_empty_.wait(guard, [this] { return !items_.empty() || closed_; });
+        if (items_.empty()) {
+            return false;
+        }
+        item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+
+    // No more items will be pushed
+    void close() {
+        std::lock_guard<std::mutex> guard(lock_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+private:
+    size_t capacity_;
+    bool closed_;
+    std::deque<T> items_;
+    std::mutex lock_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
+
+// One zip on its way through the pipeline
+struct ZipJob {
+    size_t index;             // position in the listing; results are reported in this order
+    std::string local_path;   // downloaded zip
+    bool cached;              // local_path is a cache entry and stays after extraction
+    std::string extract_dir;
+    std::string import_path;  // directory containing index.xml
+};
+
+// Cache file name of a zip: FNV-1a hash of ETag and size as 16 hex digits, so a changed file
+// (new ETag) never matches an old entry. Empty if the server reports no ETag.
+static std::string cache_key(const WebDavFile& file) {
+    if (file.etag.empty()) {
+        return "";
+    }
+    std::string identity = file.etag + "|" + std::to_string(file.size);
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : identity) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << hash << ".zip";
+    return oss.str();
+}
+
+// True for names cache_key() produces; cache pruning never touches anything else
+static bool is_cache_key(const std::string& name) {
+    if (name.size() != 20 || name.compare(16, 4, ".zip") != 0) {
+        return false;
+    }
+    for (size_t i = 0; i < 16; ++i) {
+        if (!std::isxdigit(static_cast<unsigned char>(name[i])) || std::isupper(static_cast<unsigned char>(name[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// High-water mark (change filter)
+// ============================================================================
+
+static const char* const WATERMARK_TABLE = "gdpdu_nextcloud_watermark";
+
+// Escape single quotes for SQL string literals
+static std::string escape_sql(const std::string& value) {
+    std::string result;
+    result.reserve(value.size() + 10);
+    for (char c : value) {
+        if (c == '\'') {
+            result += "''";
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+// What earlier imports of a URL have seen: the imported zips by path and ETag, and the newest
+// last-modified time (only compared against for zips without an ETag)
+struct Watermark {
+    int64_t last_modified;  // seconds since epoch, -1 if nothing was recorded
+    std::set<std::pair<std::string, std::string>> imported;  // (zip_path, etag)
+
+    Watermark() : last_modified(-1) {}
+};
+
+static bool ensure_watermark_table(Connection& conn, std::string& error) {
+    std::ostringstream sql;
+    sql << "CREATE TABLE IF NOT EXISTS " << WATERMARK_TABLE << " ("
+        << "url VARCHAR, zip_path VARCHAR, etag VARCHAR, file_size BIGINT, last_modified BIGINT, "
+        << "imported_at TIMESTAMP, PRIMARY KEY (url, zip_path))";
+    auto result = conn.Query(sql.str());
+    if (result->HasError()) {
+        error = result->GetError();
+        return false;
+    }
+    return true;
+}
+
+static Watermark load_watermark(Connection& conn, const std::string& url) {
+    Watermark mark;
+    auto result = conn.Query(std::string("SELECT zip_path, etag, last_modified FROM ") + WATERMARK_TABLE +
+                             " WHERE url = '" + escape_sql(url) + "'");
+    if (result->HasError()) {
+        return mark;
+    }
+    for (idx_t row = 0; row < result->RowCount(); ++row) {
+        if (!result->GetValue(1, row).IsNull()) {
+            mark.imported.insert(std::make_pair(result->GetValue(0, row).ToString(), result->GetValue(1, row).ToString()));
+        }
+        if (!result->GetValue(2, row).IsNull()) {
+            mark.last_modified = std::max(mark.last_modified, result->GetValue(2, row).GetValue<int64_t>());
+        }
+    }
+    return mark;
+}
+
+// Record the given zips in one statement
+static void record_watermark(Connection& conn, const std::string& url, const std::vector<const WebDavFile*>& zips) {
+    if (zips.empty()) {
+        return;
+    }
+    std::ostringstream sql;
+    sql << "INSERT OR REPLACE INTO " << WATERMARK_TABLE << " VALUES ";
+    for (size_t i = 0; i < zips.size(); ++i) {
+        const WebDavFile& zip = *zips[i];
+        sql << (i ? ", " : "") << "("
+            << "'" << escape_sql(url) << "', "
+            << "'" << escape_sql(zip.path) << "', "
+            << (zip.etag.empty() ? "NULL" : "'" + escape_sql(zip.etag) + "'") << ", "
+            << zip.size << ", "
+            << (zip.modified_time < 0 ? "NULL" : std::to_string(zip.modified_time)) << ", "
+            << "now()::TIMESTAMP)";
+    }
+    conn.Query(sql.str());
+}
+
+// Whether a zip passes the change filter. Against the watermark a zip with an ETag is new unless
+// its path was recorded with that ETag, however old it is: a zip that failed in an earlier run
+// while newer ones imported, or one uploaded late with its original modification time, is still
+// imported. Only zips without an ETag fall back to the newest recorded modification time; those
+// without a modification time are always imported.
+static bool passes_change_filter(const WebDavFile& file, const NextcloudImportConfig& config, const Watermark& mark) {
+    if (config.since_last) {
+        if (!file.etag.empty()) {
+            return mark.imported.count(std::make_pair(file.path, file.etag)) == 0;
+        }
+        return file.modified_time < 0 || mark.last_modified < 0 || file.modified_time > mark.last_modified;
+    }
+    return config.since < 0 || file.modified_time < 0 || file.modified_time > config.since;
+}
+
+static NextcloudImportResult stage_error(const std::string& table_name, const std::string& status,
+                                         const std::string& source_zip) {
+    NextcloudImportResult r;
+    r.table_name = table_name;
+    r.row_count = 0;
+    r.status = status;
+    r.source_zip = source_zip;
+    return r;
+}
+
+// Determine the GDPdU data directory by looking for index.xml
+static std::string find_import_path(const ZipExtractResult& extract_result) {
+    std::string import_path = extract_result.extract_dir;
+    for (const auto& extracted_file : extract_result.extracted_files) {
+        if (extracted_file == "index.xml") {
+            // index.xml is at root, use extract_dir directly
+            import_path = extract_result.extract_dir;
+            break;
+        } else if (extracted_file.size() > 10 && extracted_file.substr(extracted_file.size() - 10) == "/index.xml") {
+            // index.xml is in a subdirectory
+            std::string subdir = extracted_file.substr(0, extracted_file.size() - 10);
+            import_path = extract_result.extract_dir + "/" + subdir;
+            break;
+        }
+    }
+    return import_path;
+}
+
+// Start count workers running fn and return their threads
+template <class F>
+static std::vector<std::thread> start_workers(size_t count, F fn) {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < std::max<size_t>(1, count); ++i) {
+        threads.push_back(std::thread(fn, i));
+    }
+    return threads;
+}
+
+static void join_workers(std::vector<std::thread>& threads) {
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
 std::vector<NextcloudImportResult> import_from_nextcloud(
     Connection& conn,
     const std::string& nextcloud_url,
     const std::string& username,
-    const std::string& password
+    const std::string& password,
+    const NextcloudImportConfig& config
 ) {
     std::vector<NextcloudImportResult> results;
 
-    // Create WebDAV client
-    WebDavClient client(nextcloud_url, username, password);
+    // Create WebDAV client; every download worker gets its own connection
+    WebDavClient client(nextcloud_url, username, password, std::max<size_t>(1, config.download_concurrency));
 
     // List zip files from Nextcloud
-    auto list_result = client.list_files(true);
+    auto list_result = client.list_files(true, config.recursive);
     if (!list_result.success) {
         NextcloudImportResult r;
         r.table_name = "(listing)";
@@ -81,111 +325,243 @@ std::vector<NextcloudImportResult> import_from_nextcloud(
         return results;
     }
 
-    // Create temp download directory
-    std::string temp_dir;
-    try {
-        temp_dir = create_temp_download_dir();
-    } catch (const std::exception& e) {
+    // Download directory of this URL; partial downloads of an interrupted run are resumed from it
+    std::string download_dir = get_download_dir(nextcloud_url);
+    if (download_dir.empty()) {
         NextcloudImportResult r;
         r.table_name = "(temp_dir)";
         r.row_count = 0;
-        r.status = "Failed to create temp directory: " + std::string(e.what());
+        r.status = "Failed to create download directory";
+        r.source_zip = "";
+        results.push_back(r);
+        return results;
+    }
+
+    const auto& files = list_result.files;
+
+    // High-water mark of earlier imports of this URL
+    std::string watermark_error;
+    if (!ensure_watermark_table(conn, watermark_error)) {
+        NextcloudImportResult r;
+        r.table_name = "(watermark)";
+        r.row_count = 0;
+        r.status = "Could not create " + std::string(WATERMARK_TABLE) + ": " + watermark_error;
         r.source_zip = "";
         results.push_back(r);
         return results;
     }
+    Watermark watermark;
+    if (config.since_last) {
+        watermark = load_watermark(conn, nextcloud_url);
+    }
 
-    // Process each zip file (skip-and-continue pattern)
-    for (const auto& file : list_result.files) {
-        std::string prefix = sanitize_zip_prefix(file.name);
-
-        // Download the zip file
-        auto dl = client.download_file(file.href, temp_dir);
-        if (!dl.success) {
-            NextcloudImportResult r;
-            r.table_name = "(download)";
-            r.row_count = 0;
-            r.status = "Download failed: " + dl.error_message;
-            r.source_zip = file.name;
-            results.push_back(r);
-            continue;
-        }
-
-        // Extract the zip file
-        auto extract_result = extract_zip(dl.local_path);
-        if (!extract_result.success) {
-            NextcloudImportResult r;
-            r.table_name = "(extract)";
-            r.row_count = 0;
-            r.status = "Extraction failed: " + extract_result.error_message;
-            r.source_zip = file.name;
-            results.push_back(r);
-            continue;
-        }
-
-        // Determine the GDPdU data directory by looking for index.xml
-        std::string import_path = extract_result.extract_dir;
-        for (const auto& extracted_file : extract_result.extracted_files) {
-            if (extracted_file == "index.xml") {
-                // index.xml is at root, use extract_dir directly
-                import_path = extract_result.extract_dir;
-                break;
-            } else if (extracted_file.size() > 10 && extracted_file.substr(extracted_file.size() - 10) == "/index.xml") {
-                // index.xml is in a subdirectory
-                std::string subdir = extracted_file.substr(0, extracted_file.size() - 10);
-                import_path = extract_result.extract_dir + "/" + subdir;
-                break;
+    // Table prefixes, made unique so zips imported at the same time never share a table name
+    // ("Export 2024.zip" and "Export_2024.zip" -> "Export_2024", "Export_2024_2"); subfolders are
+    // folded in ("2024/01/export.zip" -> "2024_01_export")
+    std::vector<std::string> prefixes;
+    std::set<std::string> used_prefixes;
+    for (const auto& file : files) {
+        std::string prefix = sanitize_zip_prefix(file.path);
+        std::string unique = prefix;
+        for (int n = 2; used_prefixes.count(unique); ++n) {
+            unique = prefix + "_" + std::to_string(n);
+        }
+        used_prefixes.insert(unique);
+        prefixes.push_back(unique);
+    }
+
+    // Per-zip download directories live under their own folder, so no table prefix (a zip named
+    // "cache.zip" or "mirror.zip") can name the zip cache or a webdav:// mirror
+    std::string zips_dir = download_dir + "/zips";
+    mkdir(zips_dir.c_str(), 0755);
+
+    // Zip cache; without a usable cache directory every zip is downloaded. A cache_dir given by
+    // the user gets a subdirectory per URL, so URLs sharing it (or files already in it) are
+    // never pruned by another URL's run.
+    std::string cache_dir;
+    if (config.use_cache) {
+        cache_dir = config.cache_dir.empty() ? download_dir + "/cache" : config.cache_dir;
+        if (mkdir(cache_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+            cache_dir.clear();
+        } else if (!config.cache_dir.empty()) {
+            cache_dir += "/" + url_directory_name(nextcloud_url);
+            if (mkdir(cache_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+                cache_dir.clear();
             }
         }
+    }
+    std::vector<std::string> cache_keys;
+    for (const auto& file : files) {
+        cache_keys.push_back(cache_dir.empty() ? "" : cache_key(file));
+    }
 
-        // Import the GDPdU data
-        std::vector<ImportResult> import_results;
-        try {
-            import_results = import_gdpdu_navision(conn, import_path);
-        } catch (const std::exception& e) {
-            NextcloudImportResult r;
-            r.table_name = "(import)";
-            r.row_count = 0;
-            r.status = "Import failed: " + std::string(e.what());
-            r.source_zip = file.name;
-            results.push_back(r);
-            cleanup_extract_dir(extract_result.extract_dir);
-            continue;
+    // Results per zip, filled by whichever stage finishes (or fails) the zip; zips left out by
+    // the change filter are reported right away and never downloaded
+    std::vector<std::vector<NextcloudImportResult>> zip_results(files.size());
+    std::vector<bool> selected(files.size(), true);
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!passes_change_filter(files[i], config, watermark)) {
+            selected[i] = false;
+            zip_results[i].push_back(stage_error(
+                "(skipped)", config.since_last ? "Not modified since the last import" : "Not modified since 'since'",
+                files[i].path));
         }
+    }
+
+    BoundedQueue<ZipJob> extract_queue(config.queue_size);
+    BoundedQueue<ZipJob> import_queue(config.queue_size);
+    std::atomic<size_t> next_download(0);
 
-        // Rename tables with prefix and create results
-        for (const auto& import_res : import_results) {
-            std::string prefixed_name = prefix + "_" + import_res.table_name;
+    // Stage 1: download (skip-and-continue: a failed zip only records its error)
+    auto download_worker = [&](size_t) {
+        for (size_t i = next_download++; i < files.size(); i = next_download++) {
+            if (!selected[i]) {
+                continue;
+            }
+            const auto& file = files[i];
+            ZipJob job;
+            job.index = i;
+            job.cached = false;
+
+            // Unchanged since it was cached (same ETag and size): no transfer at all
+            std::string cache_path = cache_keys[i].empty() ? "" : cache_dir + "/" + cache_keys[i];
+            DirectoryEntry cached_entry;
+            if (!cache_path.empty() && stat_file(cache_path, cached_entry) &&
+                (file.size < 0 || cached_entry.size == file.size)) {
+                job.local_path = cache_path;
+                job.cached = true;
+                extract_queue.push(std::move(job));
+                continue;
+            }
 
-            // Rename the table
+            // Each zip gets its own directory, named by its (unique) table prefix so a later run
+            // finds a partial download again
+            std::string zip_dir = zips_dir + "/" + prefixes[i];
+            mkdir(zip_dir.c_str(), 0755);
+            auto dl = client.download_file(file.href, zip_dir, file.size, file.etag);
+            if (!dl.success) {
+                zip_results[i].push_back(stage_error("(download)", "Download failed: " + dl.error_message, file.path));
+                continue;
+            }
+            job.local_path = dl.local_path;
+
+            // Move it into the cache; if that fails (e.g. cache_dir on another file system) the
+            // zip is used uncached
+            if (!cache_path.empty() && rename(dl.local_path.c_str(), cache_path.c_str()) == 0) {
+                job.local_path = cache_path;
+                job.cached = true;
+            }
+            extract_queue.push(std::move(job));
+        }
+    };
+
+    // Stage 2: extract; an uncached zip is deleted as soon as it is extracted
+    auto extract_worker = [&](size_t) {
+        ZipJob job;
+        while (extract_queue.pop(job)) {
+            const auto& file = files[job.index];
+            ZipExtractResult extract_result;
             try {
-                std::string rename_sql = "ALTER TABLE \"" + import_res.table_name + "\" RENAME TO \"" + prefixed_name + "\"";
-                conn.Query(rename_sql);
-
-                // Create success result
-                NextcloudImportResult r;
-                r.table_name = prefixed_name;
-                r.row_count = import_res.row_count;
-                r.status = import_res.status;
-                r.source_zip = file.name;
-                results.push_back(r);
+                extract_result = extract_zip(job.local_path);
             } catch (const std::exception& e) {
-                // Rename failed, report error but continue
-                NextcloudImportResult r;
-                r.table_name = prefixed_name;
-                r.row_count = import_res.row_count;
-                r.status = "Rename failed: " + std::string(e.what());
-                r.source_zip = file.name;
-                results.push_back(r);
+                extract_result.success = false;
+                extract_result.error_message = e.what();
+            }
+            // A cached zip that doesn't extract is dropped too, so the next run downloads it again
+            if (!job.cached || !extract_result.success) {
+                remove(job.local_path.c_str());
+            }
+            if (!extract_result.success) {
+                zip_results[job.index].push_back(
+                    stage_error("(extract)", "Extraction failed: " + extract_result.error_message, file.path));
+                continue;
             }
+            job.extract_dir = extract_result.extract_dir;
+            job.import_path = find_import_path(extract_result);
+            import_queue.push(std::move(job));
+        }
+    };
+
+    // Stage 3: import with prefixed table names. The first worker uses the caller's connection,
+    // further workers open their own.
+    auto import_worker = [&](size_t worker) {
+        std::unique_ptr<Connection> own_conn;
+        ZipJob job;
+        while (import_queue.pop(job)) {
+            const auto& file = files[job.index];
+            auto& out = zip_results[job.index];
+            try {
+                if (worker > 0 && !own_conn) {
+                    own_conn.reset(new Connection(*conn.context->db));
+                }
+                Connection& import_conn = worker > 0 ? *own_conn : conn;
+                auto import_results = import_gdpdu_navision(import_conn, job.import_path, "Name",
+                                                            prefixes[job.index] + "_");
+                for (const auto& import_res : import_results) {
+                    NextcloudImportResult r;
+                    r.table_name = import_res.table_name;
+                    r.row_count = import_res.row_count;
+                    r.status = import_res.status;
+                    r.source_zip = file.path;
+                    out.push_back(r);
+                }
+            } catch (const std::exception& e) {
+                out.push_back(stage_error("(import)", "Import failed: " + std::string(e.what()), file.path));
+            }
+
+            // Clean up extraction directory
+            cleanup_extract_dir(job.extract_dir);
         }
+    };
 
-        // Clean up extraction directory
-        cleanup_extract_dir(extract_result.extract_dir);
+    auto downloaders = start_workers(config.download_concurrency, download_worker);
+    auto extractors = start_workers(config.extract_concurrency, extract_worker);
+    auto importers = start_workers(config.import_concurrency, import_worker);
+
+    join_workers(downloaders);
+    extract_queue.close();
+    join_workers(extractors);
+    import_queue.close();
+    join_workers(importers);
+
+    for (auto& zip : zip_results) {
+        results.insert(results.end(), zip.begin(), zip.end());
+    }
+
+    // Move the high-water mark over the zips whose tables all imported
+    std::vector<const WebDavFile*> imported;
+    for (size_t i = 0; i < files.size(); ++i) {
+        bool ok = selected[i] && !zip_results[i].empty();
+        for (const auto& r : zip_results[i]) {
+            ok = ok && r.status == "OK";
+        }
+        if (ok) {
+            imported.push_back(&files[i]);
+        }
     }
+    record_watermark(conn, nextcloud_url, imported);
 
-    // Clean up temp download directory
-    cleanup_temp_dir(temp_dir);
+    // Clean up the download directories of zips that downloaded completely; failed downloads
+    // keep their partial file for the next run
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (selected[i] && (zip_results[i].empty() || zip_results[i][0].table_name != "(download)")) {
+            cleanup_temp_dir(zips_dir + "/" + prefixes[i]);
+        }
+    }
+
+    // Drop cache entries of zips that were removed or changed on the server
+    if (!cache_dir.empty()) {
+        std::set<std::string> current(cache_keys.begin(), cache_keys.end());
+        DirectoryWalkOptions walk_options;
+        walk_options.name_filter = is_cache_key;
+        for (const auto& entry : walk_directory(cache_dir, walk_options)) {
+            if (!current.count(entry.name)) {
+                remove((cache_dir + "/" + entry.name).c_str());
+            }
+        }
+    }
+    rmdir(zips_dir.c_str());
+    rmdir(download_dir.c_str());
 
     return results;
 }
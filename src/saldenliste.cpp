@@ -0,0 +1,482 @@
+#include "saldenliste.hpp"
+#include "gdpdu_table_creator.hpp"
+#include "duckdb/common/string_util.hpp"
+#include <sstream>
+
+namespace duckdb {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+static const char* const CACHE_TABLE = "gdpdu_saldenliste_cache";
+static const char* const WORKBOOK_TABLE = "__gdpdu_reconcile_workbook";
+
+// Escape single quotes for SQL string literals
+static std::string escape_sql(const std::string& value) {
+    std::string result;
+    result.reserve(value.size() + 10);
+    for (char c : value) {
+        if (c == '\'') {
+            result += "''";
+        } else {
+            result += c;
+        }
+    }
+    return result;
+}
+
+static std::string quote_identifier(const std::string& name) {
+    std::string result = "\"";
+    for (char c : name) {
+        if (c == '"') {
+            result += "\"\"";
+        } else {
+            result += c;
+        }
+    }
+    return result + "\"";
+}
+
+// Column names and types of a table, empty if it doesn't exist
+static std::vector<std::string> get_table_columns(Connection& conn, const std::string& table_name,
+                                                  std::vector<std::string>& types) {
+    std::vector<std::string> columns;
+    auto result = conn.Query("DESCRIBE " + quote_identifier(table_name));
+    if (!result->HasError()) {
+        for (idx_t row = 0; row < result->RowCount(); ++row) {
+            columns.push_back(result->GetValue(0, row).ToString());
+            types.push_back(result->GetValue(1, row).ToString());
+        }
+    }
+    return columns;
+}
+
+// First candidate present in columns (case-insensitive), empty if none
+static std::string find_column(const std::vector<std::string>& columns, const char* const* candidates) {
+    for (const char* const* candidate = candidates; *candidate; ++candidate) {
+        for (const auto& column : columns) {
+            if (StringUtil::Lower(column) == *candidate) {
+                return column;
+            }
+        }
+    }
+    return "";
+}
+
+// Column names of the ledger layouts imported by this extension: Buchungsstapel
+// (read_buchungsstapel) and GDPdU Sachposten (import_gdpdu_navision)
+static const char* const KONTO_CANDIDATES[] = {"konto", "sachkontonr", "sachkonto", "kontonummer", "kontonr", nullptr};
+static const char* const GEGENKONTO_CANDIDATES[] = {"gegenkonto_ohne_bu_schl_ssel", "gegenkonto", "gegenkontonr", nullptr};
+static const char* const BETRAG_CANDIDATES[] = {"umsatz_ohne_soll_haben_kz", "umsatz", "betrag", nullptr};
+static const char* const SOLL_HABEN_CANDIDATES[] = {"soll_haben_kennzeichen", "soll_haben_kz", "soll_haben", nullptr};
+static const char* const DATUM_CANDIDATES[] = {"belegdatum", "buchungsdatum", "datum", nullptr};
+
+// Resolve a configured or detected column; false with error set if it is missing
+static bool resolve_column(const std::vector<std::string>& columns, const std::string& configured,
+                           const char* const* candidates, const std::string& role, std::string& column,
+                           std::string& error) {
+    if (!configured.empty()) {
+        for (const auto& c : columns) {
+            if (StringUtil::Lower(c) == StringUtil::Lower(configured)) {
+                column = c;
+                return true;
+            }
+        }
+        error = "Column '" + configured + "' not found";
+        return false;
+    }
+    column = find_column(columns, candidates);
+    if (column.empty()) {
+        error = "No " + role + " column found (set " + role + "_column := ...)";
+        return false;
+    }
+    return true;
+}
+
+static bool run(Connection& conn, const std::string& sql, std::string& error) {
+    auto result = conn.Query(sql);
+    if (result->HasError()) {
+        error = result->GetError();
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Monthly aggregation
+// ============================================================================
+
+// The resolved ledger columns of one call
+struct LedgerColumns {
+    std::string konto;
+    std::string gegenkonto;  // empty: bookings only count for konto
+    std::string betrag;
+    std::string soll_haben;  // empty: betrag is signed
+    std::string datum;
+
+    // Cache key part: a different column mapping gives different sums
+    std::string Definition() const {
+        return konto + "|" + gegenkonto + "|" + betrag + "|" + soll_haben + "|" + datum;
+    }
+};
+
+// Amount expression for the sums: DECIMAL and integer columns are summed as they are,
+// anything else (DOUBLE, VARCHAR) is cast per row so the sums stay exact
+static std::string amount_expr(const std::string& column, const std::string& type) {
+    if (type.compare(0, 7, "DECIMAL") == 0 || type == "INTEGER" || type == "BIGINT" || type == "SMALLINT" ||
+        type == "HUGEINT") {
+        return quote_identifier(column);
+    }
+    return "CAST(" + quote_identifier(column) + " AS DECIMAL(38,2))";
+}
+
+// Resolve the ledger columns of config.table_name and the amount expression; the date column is
+// only required with require_datum
+static bool resolve_ledger(Connection& conn, const SaldenlisteConfig& config, bool require_datum,
+                           LedgerColumns& cols, std::string& amount, std::string& error) {
+    std::vector<std::string> types;
+    std::vector<std::string> columns = get_table_columns(conn, config.table_name, types);
+    if (columns.empty()) {
+        error = "Table '" + config.table_name + "' not found";
+        return false;
+    }
+
+    if (!resolve_column(columns, config.konto_column, KONTO_CANDIDATES, "konto", cols.konto, error) ||
+        !resolve_column(columns, config.betrag_column, BETRAG_CANDIDATES, "betrag", cols.betrag, error)) {
+        return false;
+    }
+    if ((require_datum || !config.datum_column.empty()) &&
+        !resolve_column(columns, config.datum_column, DATUM_CANDIDATES, "datum", cols.datum, error)) {
+        return false;
+    }
+    // Soll/Haben and Gegenkonto are optional: a ledger with signed amounts (Sachposten) already
+    // has one entry per side, so the Gegenkonto is only used with a Soll/Haben indicator
+    if (config.soll_haben_column.empty()) {
+        cols.soll_haben = find_column(columns, SOLL_HABEN_CANDIDATES);
+    } else if (!resolve_column(columns, config.soll_haben_column, SOLL_HABEN_CANDIDATES, "soll_haben",
+                               cols.soll_haben, error)) {
+        return false;
+    }
+    if (cols.soll_haben.empty()) {
+        // nothing to do: signed amounts, bookings count for konto only
+    } else if (config.gegenkonto_column.empty()) {
+        cols.gegenkonto = find_column(columns, GEGENKONTO_CANDIDATES);
+    } else if (!resolve_column(columns, config.gegenkonto_column, GEGENKONTO_CANDIDATES, "gegenkonto",
+                               cols.gegenkonto, error)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i] == cols.betrag) {
+            amount = amount_expr(cols.betrag, types[i]);
+        }
+    }
+    return true;
+}
+
+// Debit/credit sums per account (and per month if monthly) for bookings in [from, to), with one
+// scan of the ledger; from/to may be empty. The hash aggregate groups by konto and Gegenkonto;
+// only its (small) result is then split into the two sides: the Soll of a booking is the Haben of
+// its Gegenkonto. Without a Soll/Haben column positive amounts are Soll and negative amounts Haben.
+static std::string ledger_sums_sql(const std::string& table_name, const LedgerColumns& cols,
+                                   const std::string& amount, const std::string& from, const std::string& to,
+                                   bool monthly) {
+    std::string soll, haben;
+    if (cols.soll_haben.empty()) {
+        soll = "CASE WHEN " + amount + " > 0 THEN " + amount + " ELSE 0 END";
+        haben = "CASE WHEN " + amount + " < 0 THEN -" + amount + " ELSE 0 END";
+    } else {
+        soll = "CASE WHEN " + quote_identifier(cols.soll_haben) + " = 'S' THEN " + amount + " ELSE 0 END";
+        haben = "CASE WHEN " + quote_identifier(cols.soll_haben) + " = 'H' THEN " + amount + " ELSE 0 END";
+    }
+    std::string month = monthly ? "monat, " : "";
+
+    std::ostringstream pairs;
+    pairs << "SELECT ";
+    if (monthly) {
+        pairs << "date_trunc('month', " << quote_identifier(cols.datum) << ")::DATE AS monat, ";
+    }
+    pairs << quote_identifier(cols.konto) << " AS konto, "
+          << (cols.gegenkonto.empty() ? std::string("NULL") : quote_identifier(cols.gegenkonto)) << " AS gegenkonto, "
+          << "SUM(" << soll << ") AS soll, SUM(" << haben << ") AS haben "
+          << "FROM " << quote_identifier(table_name)
+          << " WHERE " << quote_identifier(cols.betrag) << " IS NOT NULL";
+    if (!from.empty()) {
+        pairs << " AND " << quote_identifier(cols.datum) << " >= DATE '" << from << "'";
+    }
+    if (!to.empty()) {
+        pairs << " AND " << quote_identifier(cols.datum) << " < DATE '" << to << "'";
+    }
+    pairs << " GROUP BY ALL";
+
+    // The account number is cast and checked only once the sides are summed: in a plain
+    // subquery the optimizer would push that filter down into the ledger scan (a string cast per row)
+    std::ostringstream sql;
+    sql << "WITH pairs AS MATERIALIZED (" << pairs.str() << "), "
+        << "sides AS MATERIALIZED (SELECT " << month << "konto, SUM(soll) AS soll, SUM(haben) AS haben FROM ("
+        << "SELECT " << month << "konto, soll, haben FROM pairs";
+    if (!cols.gegenkonto.empty()) {
+        sql << " UNION ALL SELECT " << month << "gegenkonto, haben, soll FROM pairs";
+    }
+    sql << ") GROUP BY " << month << "konto) "
+        << "SELECT " << month << "trim(CAST(konto AS VARCHAR)) AS konto, soll, haben FROM sides "
+        << "WHERE konto IS NOT NULL AND trim(CAST(konto AS VARCHAR)) <> ''";
+    return sql.str();
+}
+
+// Month boundaries of the period as YYYY-MM-DD: first day of from's month, first day of to's
+// month and first day of the month after to
+static bool period_months(Connection& conn, const SaldenlisteConfig& config, std::string& from_month,
+                          std::string& to_month, std::string& end_month, std::string& error) {
+    auto result = conn.Query("SELECT date_trunc('month', DATE '" + escape_sql(config.from_date) + "')::DATE::VARCHAR, "
+                             "date_trunc('month', DATE '" + escape_sql(config.to_date) + "')::DATE::VARCHAR, "
+                             "(date_trunc('month', DATE '" + escape_sql(config.to_date) + "') + INTERVAL 1 MONTH)::DATE::VARCHAR");
+    if (result->HasError()) {
+        error = "Invalid period: " + result->GetError();
+        return false;
+    }
+    from_month = result->GetValue(0, 0).ToString();
+    to_month = result->GetValue(1, 0).ToString();
+    end_month = result->GetValue(2, 0).ToString();
+    if (from_month > to_month) {
+        error = "from_date must not be after to_date";
+        return false;
+    }
+    return true;
+}
+
+// Identity of the ledger table the cache rows were computed from: its generation in
+// gdpdu_table_versions (bumped by every importer that replaces the table, saved with the database)
+// and its row count
+static void ledger_identity(Connection& conn, const std::string& table_name, std::string& generation,
+                            std::string& rows) {
+    generation = std::to_string(get_table_generation(conn, table_name));
+    auto result = conn.Query("SELECT COUNT(*)::VARCHAR FROM " + quote_identifier(table_name));
+    rows = "NULL";
+    if (!result->HasError() && result->RowCount() > 0 && !result->GetValue(0, 0).IsNull()) {
+        rows = result->GetValue(0, 0).ToString();
+    }
+}
+
+// ============================================================================
+// Main function
+// ============================================================================
+
+SaldenlisteResult compute_saldenliste(Connection& conn, const SaldenlisteConfig& config) {
+    SaldenlisteResult result;
+
+    LedgerColumns cols;
+    std::string amount;
+    if (!resolve_ledger(conn, config, true, cols, amount, result.error)) {
+        return result;
+    }
+
+    std::string from_month, to_month, end_month;
+    if (!period_months(conn, config, from_month, to_month, end_month, result.error)) {
+        return result;
+    }
+
+    // source_generation/source_rows were added later: a cache table of an earlier version gets them
+    std::ostringstream create;
+    create << "CREATE TABLE IF NOT EXISTS " << CACHE_TABLE << " ("
+           << "source_table VARCHAR, definition VARCHAR, monat DATE, konto VARCHAR, "
+           << "soll DECIMAL(38,2), haben DECIMAL(38,2), computed_at TIMESTAMP, "
+           << "source_generation BIGINT, source_rows BIGINT)";
+    if (!run(conn, create.str(), result.error) ||
+        !run(conn, std::string("ALTER TABLE ") + CACHE_TABLE + " ADD COLUMN IF NOT EXISTS source_generation BIGINT", result.error) ||
+        !run(conn, std::string("ALTER TABLE ") + CACHE_TABLE + " ADD COLUMN IF NOT EXISTS source_rows BIGINT", result.error)) {
+        return result;
+    }
+
+    std::string key = "source_table = '" + escape_sql(config.table_name) + "' AND definition = '" +
+                      escape_sql(cols.Definition()) + "'";
+    std::string source_generation, source_rows;
+    ledger_identity(conn, config.table_name, source_generation, source_rows);
+
+    // Months to compute: everything on refresh, without a cache or when the ledger table was
+    // replaced or changed in size since the cache was filled (a re-import by sync mode,
+    // watch_folder or import_gdpdu_nextcloud may have changed any month); else from the newest
+    // cached month (it may have been incomplete) up to to_date. Earlier months come from the cache.
+    std::string recompute_from;
+    bool recompute = true;
+    if (!config.refresh) {
+        auto newest = conn.Query(std::string("SELECT MAX(monat)::VARCHAR, bool_and(source_generation IS NOT DISTINCT FROM ") +
+                                 source_generation + " AND source_rows IS NOT DISTINCT FROM " + source_rows + ") FROM " +
+                                 CACHE_TABLE + " WHERE " + key);
+        if (!newest->HasError() && newest->RowCount() > 0 && !newest->GetValue(0, 0).IsNull() &&
+            newest->GetValue(1, 0).GetValue<bool>()) {
+            recompute_from = newest->GetValue(0, 0).ToString();
+            recompute = recompute_from <= to_month;
+        }
+    }
+
+    if (recompute) {
+        if (!run(conn, "BEGIN TRANSACTION", result.error)) {
+            return result;
+        }
+        std::string delete_sql = std::string("DELETE FROM ") + CACHE_TABLE + " WHERE " + key;
+        if (!recompute_from.empty()) {
+            delete_sql += " AND monat >= DATE '" + recompute_from + "'";
+        }
+        std::string insert_sql = std::string("INSERT INTO ") + CACHE_TABLE +
+                                 " (source_table, definition, monat, konto, soll, haben, computed_at, "
+                                 "source_generation, source_rows) SELECT '" +
+                                 escape_sql(config.table_name) + "', '" + escape_sql(cols.Definition()) +
+                                 "', monat, konto, soll, haben, now()::TIMESTAMP, " + source_generation + ", " + source_rows +
+                                 " FROM (" +
+                                 ledger_sums_sql(config.table_name, cols, amount, recompute_from, end_month, true) + ")";
+        if (!run(conn, delete_sql, result.error) || !run(conn, insert_sql, result.error)) {
+            conn.Query("ROLLBACK");
+            return result;
+        }
+        if (!run(conn, "COMMIT", result.error)) {
+            return result;
+        }
+    }
+
+    // Assemble the period from the monthly sums
+    std::ostringstream report;
+    report << "SELECT konto, "
+           << "SUM(CASE WHEN monat < DATE '" << from_month << "' THEN soll - haben ELSE 0 END)::DECIMAL(38,2), "
+           << "SUM(CASE WHEN monat >= DATE '" << from_month << "' THEN soll ELSE 0 END)::DECIMAL(38,2), "
+           << "SUM(CASE WHEN monat >= DATE '" << from_month << "' THEN haben ELSE 0 END)::DECIMAL(38,2), "
+           << "SUM(soll - haben)::DECIMAL(38,2) "
+           << "FROM " << CACHE_TABLE << " WHERE " << key << " AND monat <= DATE '" << to_month << "' "
+           << "GROUP BY konto ORDER BY TRY_CAST(konto AS BIGINT) NULLS LAST, konto";
+    auto rows = conn.Query(report.str());
+    if (rows->HasError()) {
+        result.error = rows->GetError();
+        return result;
+    }
+    for (idx_t row = 0; row < rows->RowCount(); ++row) {
+        SaldenlisteRow entry;
+        entry.konto = rows->GetValue(0, row).ToString();
+        entry.anfangssaldo = rows->GetValue(1, row);
+        entry.soll = rows->GetValue(2, row);
+        entry.haben = rows->GetValue(3, row);
+        entry.endsaldo = rows->GetValue(4, row);
+        result.rows.push_back(entry);
+    }
+    return result;
+}
+
+// ============================================================================
+// Reconciliation against a Saldenliste workbook
+// ============================================================================
+
+// Account number as join key: "0800", "800" and "800.0" (numeric Excel cells read as text)
+// all become "800"
+static std::string konto_key(const std::string& expr) {
+    return "regexp_replace(regexp_replace(trim(CAST(" + expr + " AS VARCHAR)), '\\.0+$', ''), '^0+([0-9])', '\\1')";
+}
+
+SaldenlisteReconcileResult reconcile_saldenliste(Connection& conn, const SaldenlisteReconcileConfig& config) {
+    SaldenlisteReconcileResult result;
+
+    bool filtered = !config.ledger.from_date.empty() || !config.ledger.to_date.empty();
+    LedgerColumns cols;
+    std::string amount;
+    if (!resolve_ledger(conn, config.ledger, filtered, cols, amount, result.error)) {
+        return result;
+    }
+
+    // Optional period: [from_date, to_date] inclusive
+    std::string from, to;
+    if (filtered) {
+        auto period = conn.Query("SELECT " +
+                                 (config.ledger.from_date.empty() ? std::string("NULL")
+                                      : "(DATE '" + escape_sql(config.ledger.from_date) + "')::VARCHAR") + ", " +
+                                 (config.ledger.to_date.empty() ? std::string("NULL")
+                                      : "(DATE '" + escape_sql(config.ledger.to_date) + "' + 1)::VARCHAR"));
+        if (period->HasError()) {
+            result.error = "Invalid period: " + period->GetError();
+            return result;
+        }
+        if (!period->GetValue(0, 0).IsNull()) from = period->GetValue(0, 0).ToString();
+        if (!period->GetValue(1, 0).IsNull()) to = period->GetValue(1, 0).ToString();
+    }
+
+    // Workbook: one read as text, the cells are cast below
+    conn.Query(std::string("DROP TABLE IF EXISTS ") + WORKBOOK_TABLE);
+    std::string load = std::string("CREATE TEMP TABLE ") + WORKBOOK_TABLE + " AS SELECT * FROM read_xlsx('" +
+                       escape_sql(config.xlsx_path) + "', header=false, all_varchar=true";
+    if (!config.sheet.empty()) {
+        load += ", sheet='" + escape_sql(config.sheet) + "'";
+    }
+    load += ")";
+    if (!run(conn, load, result.error)) {
+        result.error = "Cannot read workbook '" + config.xlsx_path + "': " + result.error;
+        return result;
+    }
+    std::vector<std::string> types;
+    std::vector<std::string> cells = get_table_columns(conn, WORKBOOK_TABLE, types);
+    if (cells.size() < 8) {
+        conn.Query(std::string("DROP TABLE IF EXISTS ") + WORKBOOK_TABLE);
+        result.error = "Workbook has " + std::to_string(cells.size()) +
+                       " columns, expected 8 (Konto, Bezeichnung, Soll, Haben, Soll kumuliert, Haben kumuliert, "
+                       "EB-Wert, Saldo)";
+        return result;
+    }
+    auto cell_amount = [&](size_t i) {
+        return "TRY_CAST(trim(" + quote_identifier(cells[i]) + ") AS DECIMAL(38,2))";
+    };
+
+    std::ostringstream workbook;
+    workbook << "SELECT " << konto_key(quote_identifier(cells[0])) << " AS konto, "
+             << "first(trim(" << quote_identifier(cells[1]) << ")) AS bezeichnung, "
+             << "SUM(COALESCE(" << cell_amount(4) << ", 0)) AS soll, "
+             << "SUM(COALESCE(" << cell_amount(5) << ", 0)) AS haben, "
+             << "SUM(COALESCE(" << cell_amount(6) << ", 0)) AS eb, "
+             << "SUM(" << cell_amount(7) << ") AS saldo "
+             << "FROM " << WORKBOOK_TABLE << " WHERE " << cell_amount(7) << " IS NOT NULL AND "
+             << "trim(" << quote_identifier(cells[0]) << ") <> '' GROUP BY 1";
+
+    std::ostringstream ledger;
+    ledger << "SELECT " << konto_key("konto") << " AS konto, SUM(soll) AS soll, SUM(haben) AS haben FROM ("
+           << ledger_sums_sql(config.ledger.table_name, cols, amount, from, to, false) << ") GROUP BY 1";
+
+    std::string tolerance = std::to_string(config.tolerance);
+    std::ostringstream sql;
+    sql << "WITH workbook AS (" << workbook.str() << "), ledger AS (" << ledger.str() << "), "
+        << "joined AS (SELECT COALESCE(w.konto, l.konto) AS konto, w.bezeichnung, "
+        << "CASE WHEN w.konto IS NULL THEN 'missing in workbook' WHEN l.konto IS NULL THEN 'missing in ledger' "
+        << "ELSE 'differs' END AS status, "
+        << "w.soll AS workbook_soll, COALESCE(l.soll, 0)::DECIMAL(38,2) AS ledger_soll, "
+        << "w.haben AS workbook_haben, COALESCE(l.haben, 0)::DECIMAL(38,2) AS ledger_haben, "
+        << "w.saldo AS workbook_saldo, "
+        << "(COALESCE(w.eb, 0) + COALESCE(l.soll, 0) - COALESCE(l.haben, 0))::DECIMAL(38,2) AS ledger_saldo "
+        << "FROM workbook w FULL OUTER JOIN ledger l ON w.konto = l.konto) "
+        << "SELECT konto, bezeichnung, status, "
+        << "workbook_soll, ledger_soll, (ledger_soll - COALESCE(workbook_soll, 0))::DECIMAL(38,2) AS delta_soll, "
+        << "workbook_haben, ledger_haben, (ledger_haben - COALESCE(workbook_haben, 0))::DECIMAL(38,2) AS delta_haben, "
+        << "workbook_saldo, ledger_saldo, (ledger_saldo - COALESCE(workbook_saldo, 0))::DECIMAL(38,2) AS delta_saldo "
+        << "FROM joined WHERE abs(delta_soll) > " << tolerance << " OR abs(delta_haben) > " << tolerance
+        << " OR abs(delta_saldo) > " << tolerance
+        << " ORDER BY TRY_CAST(konto AS BIGINT) NULLS LAST, konto";
+    auto rows = conn.Query(sql.str());
+    conn.Query(std::string("DROP TABLE IF EXISTS ") + WORKBOOK_TABLE);
+    if (rows->HasError()) {
+        result.error = rows->GetError();
+        return result;
+    }
+    for (idx_t row = 0; row < rows->RowCount(); ++row) {
+        SaldenlisteDifference entry;
+        entry.konto = rows->GetValue(0, row).ToString();
+        entry.bezeichnung = rows->GetValue(1, row).IsNull() ? "" : rows->GetValue(1, row).ToString();
+        entry.status = rows->GetValue(2, row).ToString();
+        entry.workbook_soll = rows->GetValue(3, row);
+        entry.ledger_soll = rows->GetValue(4, row);
+        entry.delta_soll = rows->GetValue(5, row);
+        entry.workbook_haben = rows->GetValue(6, row);
+        entry.ledger_haben = rows->GetValue(7, row);
+        entry.delta_haben = rows->GetValue(8, row);
+        entry.workbook_saldo = rows->GetValue(9, row);
+        entry.ledger_saldo = rows->GetValue(10, row);
+        entry.delta_saldo = rows->GetValue(11, row);
+        result.rows.push_back(entry);
+    }
+    return result;
+}
+
+} // namespace duckdb
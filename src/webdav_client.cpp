@@ -1,23 +1,39 @@
 #include "webdav_client.hpp"
 #include "httplib.hpp"
 #include "pugixml.hpp"
+#include "miniz.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <sstream>
 #include <ctime>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
 #include <direct.h>
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #define mkdir(path, mode) _mkdir(path)
 #else
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <fcntl.h>
 #endif
 
 namespace duckdb {
@@ -104,6 +120,37 @@ static std::string extract_filename(const std::string& path) {
     return path;
 }
 
+// Seconds since epoch of an HTTP date in RFC 1123 form ("Tue, 15 Oct 2024 10:15:00 GMT"),
+// -1 if it doesn't parse
+static int64_t parse_http_date(const std::string& value) {
+    static const char* const months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                         "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+    int day = 0, year = 0, hour = 0, minute = 0, second = 0;
+    char month_name[4] = {0};
+    size_t comma = value.find(',');
+    std::string rest = comma == std::string::npos ? value : value.substr(comma + 1);
+    if (sscanf(rest.c_str(), " %d %3s %d %d:%d:%d", &day, month_name, &year, &hour, &minute, &second) != 6) {
+        return -1;
+    }
+    int month = 0;
+    while (month < 12 && std::string(months[month]) != month_name) {
+        month++;
+    }
+    if (month == 12) {
+        return -1;
+    }
+    month++;
+
+    // Days since 1970-01-01 of the civil date (proleptic Gregorian calendar)
+    int64_t y = month <= 2 ? year - 1 : year;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yoe = y - era * 400;
+    int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = era * 146097 + doe - 719468;
+    return days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
 // Case-insensitive string ending check
 static bool ends_with_ignore_case(const std::string& str, const std::string& suffix) {
     if (suffix.size() > str.size()) return false;
@@ -111,9 +158,97 @@ static bool ends_with_ignore_case(const std::string& str, const std::string& suf
                      [](char a, char b) { return std::tolower(a) == std::tolower(b); });
 }
 
-WebDavClient::WebDavClient(const std::string& base_url, const std::string& username, const std::string& password)
-    : base_url_(base_url), username_(username), password_(password) {
+// Keep-alive connections to the server. A connection is taken out for one request and put back
+// afterwards; up to max_connections exist at a time, further callers wait for a free one.
+class WebDavClient::ConnectionPool {
+public:
+    ConnectionPool(const std::string& proto_host_port, size_t max_connections)
+        : proto_host_port_(proto_host_port), max_connections_(std::max<size_t>(1, max_connections)), in_use_(0) {}
+
+    std::unique_ptr<CPPHTTPLIB_NAMESPACE::Client> acquire() {
+        std::unique_lock<std::mutex> guard(lock_);
+        available_.wait(guard, [this] { return in_use_ < max_connections_; });
+        in_use_++;
+        if (!idle_.empty()) {
+            std::unique_ptr<CPPHTTPLIB_NAMESPACE::Client> client = std::move(idle_.back());
+            idle_.pop_back();
+            return client;
+        }
+        guard.unlock();
+        return connect();
+    }
+
+    // Return a connection; a connection whose last request failed is closed instead of reused
+    void release(std::unique_ptr<CPPHTTPLIB_NAMESPACE::Client> client, bool reusable) {
+        std::lock_guard<std::mutex> guard(lock_);
+        if (client && reusable) {
+            idle_.push_back(std::move(client));
+        }
+        in_use_--;
+        available_.notify_one();
+    }
+
+    std::unique_ptr<CPPHTTPLIB_NAMESPACE::Client> connect() const {
+        std::unique_ptr<CPPHTTPLIB_NAMESPACE::Client> client(new CPPHTTPLIB_NAMESPACE::Client(proto_host_port_));
+
+        // Configure SSL and timeouts; the read timeout is set per request
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+        client->enable_server_certificate_verification(false);
+#endif
+        client->set_keep_alive(true);
+        // Compressed bodies are decoded by ContentDecoder while they stream in (httplib's own
+        // decompression depends on zlib, which DuckDB's bundled copy may be built without)
+        client->set_decompress(false);
+        client->set_connection_timeout(30, 0); // 30 seconds
+        client->set_write_timeout(30, 0);
+        return client;
+    }
+
+private:
+    std::string proto_host_port_;
+    size_t max_connections_;
+    size_t in_use_;
+    std::vector<std::unique_ptr<CPPHTTPLIB_NAMESPACE::Client>> idle_;
+    std::mutex lock_;
+    std::condition_variable available_;
+};
+
+// A connection taken from the pool for the duration of one request
+class WebDavClient::PooledConnection {
+public:
+    explicit PooledConnection(ConnectionPool& pool) : pool_(pool), client_(pool.acquire()), reusable_(true) {}
+
+    ~PooledConnection() {
+        pool_.release(std::move(client_), reusable_);
+    }
+
+    CPPHTTPLIB_NAMESPACE::Client* operator->() { return client_.get(); }
+
+    // Replace the connection with a new one, e.g. after the server closed an idle keep-alive
+    // connection
+    void reconnect() {
+        client_ = pool_.connect();
+    }
+
+    // Don't reuse the connection (the request failed halfway)
+    void discard() { reusable_ = false; }
+
+private:
+    ConnectionPool& pool_;
+    std::unique_ptr<CPPHTTPLIB_NAMESPACE::Client> client_;
+    bool reusable_;
+};
+
+WebDavClient::WebDavClient(const std::string& base_url, const std::string& username, const std::string& password,
+                           size_t max_connections)
+    : base_url_(base_url), username_(username), password_(password),
+      max_connections_(std::max<size_t>(1, max_connections)), max_attempts_(5), initial_backoff_ms_(1000),
+      compression_(true) {
     parse_url();
+    pool_.reset(new ConnectionPool(proto_host_port_, max_connections));
+}
+
+WebDavClient::~WebDavClient() {
 }
 
 void WebDavClient::parse_url() {
@@ -149,149 +284,583 @@ std::string WebDavClient::make_auth_header() const {
     return "Basic " + base64_encode(credentials);
 }
 
-WebDavResult WebDavClient::list_files(bool filter_zips) {
-    WebDavResult result;
-    result.success = false;
+// Local part of an XML element name: "d:response" -> "response". Servers pick their own
+// namespace prefix for DAV: (d:, D:, none), and pugixml doesn't resolve namespaces.
+static std::string local_name(const std::string& name) {
+    size_t colon = name.find(':');
+    return colon == std::string::npos ? name : name.substr(colon + 1);
+}
 
-    try {
-        // Create HTTP client
-        CPPHTTPLIB_NAMESPACE::Client client(proto_host_port_.c_str());
+// Incremental parser of a PROPFIND multistatus body. Bytes are fed as they arrive from the
+// connection; every complete <response> element is cut out, parsed on its own and passed to
+// on_response, so memory holds one entry at a time no matter how long the listing is.
+class MultistatusParser {
+public:
+    explicit MultistatusParser(std::function<void(const pugi::xml_node&)> on_response)
+        : on_response_(std::move(on_response)), scan_(0), response_start_(0), in_response_(false) {}
+
+    // False (with error()) if a response element doesn't parse
+    bool feed(const char* data, size_t size) {
+        buffer_.append(data, size);
+        while (true) {
+            size_t open = buffer_.find('<', scan_);
+            if (open == std::string::npos) {
+                // Text between elements; nothing to keep outside a response
+                if (!in_response_) {
+                    buffer_.clear();
+                }
+                scan_ = buffer_.size();
+                return true;
+            }
+            size_t close = buffer_.find('>', open);
+            if (close == std::string::npos) {
+                // Tag continues in the next chunk
+                if (!in_response_) {
+                    buffer_.erase(0, open);
+                    open = 0;
+                }
+                scan_ = open;
+                return true;
+            }
+            scan_ = close + 1;
 
-        // Configure SSL and timeouts
-#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
-        client.enable_server_certificate_verification(false);
-#endif
-        client.set_connection_timeout(30, 0); // 30 seconds
-        client.set_read_timeout(30, 0);
-        client.set_write_timeout(30, 0);
-
-        // Build PROPFIND request
-        CPPHTTPLIB_NAMESPACE::Request req;
-        req.method = "PROPFIND";
-        req.path = base_path_;
-        req.set_header("Authorization", make_auth_header().c_str());
-        req.set_header("Depth", "1");
-        req.set_header("Content-Type", "application/xml");
-        req.body = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
-                   "<d:propfind xmlns:d=\"DAV:\">"
-                   "<d:prop><d:resourcetype/></d:prop>"
-                   "</d:propfind>";
-
-        // Send request
-        auto res = client.send(req);
-
-        // Check for connection errors
-        if (!res) {
-            result.error_message = "Connection failed to " + proto_host_port_ + " - check URL and network connectivity";
-            return result;
+            bool end_tag = buffer_[open + 1] == '/';
+            size_t name_start = open + (end_tag ? 2 : 1);
+            size_t name_end = buffer_.find_first_of(" \t\r\n/>", name_start);
+            if (local_name(buffer_.substr(name_start, name_end - name_start)) != "response") {
+                continue;
+            }
+            if (!end_tag && !in_response_ && buffer_[close - 1] != '/') {
+                in_response_ = true;
+                response_start_ = open;
+            } else if (end_tag && in_response_) {
+                pugi::xml_document doc;
+                pugi::xml_parse_result parsed = doc.load_buffer(buffer_.data() + response_start_, scan_ - response_start_);
+                if (!parsed) {
+                    error_ = parsed.description();
+                    return false;
+                }
+                on_response_(doc.first_child());
+                buffer_.erase(0, scan_);
+                scan_ = 0;
+                in_response_ = false;
+            }
         }
+    }
 
-        // Check HTTP status
-        if (res->status == 401) {
-            result.error_message = "Authentication failed: check username and password";
-            return result;
+    const std::string& error() const { return error_; }
+
+private:
+    std::function<void(const pugi::xml_node&)> on_response_;
+    std::string buffer_;     // unparsed rest: the current response element (or a partial tag)
+    size_t scan_;            // position in buffer_ up to which tags have been looked at
+    size_t response_start_;  // start of the open response element in buffer_
+    bool in_response_;
+    std::string error_;
+};
+
+// Fill a WebDavFile from one <response> element: href, collection flag, ETag, size and
+// modification time. False if the element has no href.
+static bool parse_propfind_entry(const pugi::xml_node& response, WebDavFile& file) {
+    bool has_href = false;
+    for (auto child : response.children()) {
+        std::string child_name = local_name(child.name());
+        if (child_name == "href") {
+            file.href = child.child_value();
+            has_href = true;
+        } else if (child_name != "propstat") {
+            continue;
         }
-
-        if (res->status != 207) {
-            std::ostringstream oss;
-            oss << "PROPFIND request failed with status " << res->status;
-            if (!res->body.empty()) {
-                oss << ": " << res->body.substr(0, 200);
+        for (auto prop : child.children()) {
+            if (local_name(prop.name()) != "prop") {
+                continue;
             }
-            result.error_message = oss.str();
-            return result;
+            for (auto property : prop.children()) {
+                std::string property_name = local_name(property.name());
+                if (property_name == "resourcetype") {
+                    for (auto type : property.children()) {
+                        if (local_name(type.name()) == "collection") {
+                            file.is_collection = true;
+                        }
+                    }
+                } else if (property_name == "getetag") {
+                    file.etag = property.child_value();
+                } else if (property_name == "getcontentlength" && *property.child_value()) {
+                    file.size = std::strtoll(property.child_value(), nullptr, 10);
+                } else if (property_name == "getlastmodified") {
+                    file.last_modified = property.child_value();
+                    file.modified_time = parse_http_date(file.last_modified);
+                }
+            }
+        }
+    }
+    return has_href;
+}
+
+// Href without a trailing slash, so "/dav/a/" and "/dav/a" compare equal
+static std::string strip_trailing_slash(const std::string& href) {
+    return !href.empty() && href.back() == '/' ? href.substr(0, href.size() - 1) : href;
+}
+
+// Accept-Encoding of requests whose body may come compressed (listings, whole-file downloads of
+// uncompressed formats); "identity" is sent explicitly with the others, Range requests among them,
+// since a range of an encoded body can't be appended to decoded data
+static const char* ACCEPT_COMPRESSED = "gzip, deflate";
+static const char* ACCEPT_IDENTITY = "identity";
+
+// Formats that are compressed already; asking the server to compress them again gains nothing
+static bool is_compressed_format(const std::string& filename) {
+    static const char* const extensions[] = {".zip", ".gz", ".tgz", ".bz2", ".xz", ".7z", ".xlsx",
+                                             ".docx", ".pdf", ".jpg", ".jpeg", ".png"};
+    for (const char* extension : extensions) {
+        if (ends_with_ignore_case(filename, extension)) {
+            return true;
         }
+    }
+    return false;
+}
 
-        // Parse XML response
-        pugi::xml_document doc;
-        pugi::xml_parse_result parse_result = doc.load_string(res->body.c_str());
+// Decodes a response body sent with Content-Encoding gzip or deflate while it streams in, using
+// DuckDB's bundled miniz; decoded bytes go to the sink in chunks of at most 64 KB, so a download
+// stays streamed to disk. gzip members are checked against their CRC-32 and length; "deflate" is
+// zlib-wrapped per RFC 9110, but raw deflate (sent by some servers) is recognized as well.
+class ContentDecoder {
+public:
+    typedef std::function<bool(const char*, size_t)> Sink;
 
-        if (!parse_result) {
-            result.error_message = "Failed to parse PROPFIND XML response: " + std::string(parse_result.description());
-            return result;
+    ContentDecoder() : kind_(IDENTITY), inflating_(false), ended_(false), crc_(0), size_(0) {
+        memset(&stream_, 0, sizeof(stream_));
+    }
+
+    ~ContentDecoder() {
+        reset();
+    }
+
+    // Start decoding a response with this Content-Encoding (empty or "identity": pass through).
+    // False for an encoding that isn't supported.
+    bool start(const std::string& content_encoding) {
+        reset();
+        std::string encoding = content_encoding;
+        std::transform(encoding.begin(), encoding.end(), encoding.begin(), ::tolower);
+        if (encoding.empty() || encoding == "identity") {
+            kind_ = IDENTITY;
+        } else if (encoding == "gzip" || encoding == "x-gzip") {
+            kind_ = GZIP;
+        } else if (encoding == "deflate") {
+            kind_ = DEFLATE;
+        } else {
+            return false;
         }
+        return true;
+    }
 
-        // Find all response elements (try different namespace prefixes)
-        std::vector<pugi::xml_node> response_nodes;
+    bool is_encoded() const { return kind_ != IDENTITY; }
 
-        // Try common namespace prefixes
-        for (auto node : doc.children()) {
-            for (auto response : node.children()) {
-                std::string name = response.name();
-                // Check if this is a response element (handles d:response, D:response, response, etc.)
-                if (name.find("response") != std::string::npos ||
-                    name == "response" ||
-                    name == "d:response" ||
-                    name == "D:response") {
-                    response_nodes.push_back(response);
-                }
+    // Decode a chunk of the body. False (with error()) on corrupt data, data after the end of
+    // the compressed stream, or when the sink returns false (error() stays empty).
+    bool feed(const char* data, size_t size, const Sink& sink) {
+        if (kind_ == IDENTITY) {
+            return sink(data, size);
+        }
+        if (inflating_) {
+            return inflate(data, size, sink);
+        }
+        if (ended_) {
+            return trailer(data, size);
+        }
+        // Collect the gzip header (or the first two bytes of a deflate body) before inflating
+        header_.append(data, size);
+        size_t header_size = 0;
+        int window_bits = -MZ_DEFAULT_WINDOW_BITS;
+        if (kind_ == GZIP) {
+            int parsed = parse_gzip_header(header_size);
+            if (parsed <= 0) {
+                return parsed == 0;
+            }
+        } else {
+            if (header_.size() < 2) {
+                return true;
             }
+            unsigned cmf = static_cast<unsigned char>(header_[0]);
+            unsigned flg = static_cast<unsigned char>(header_[1]);
+            if ((cmf & 0x0F) == 8 && (cmf * 256 + flg) % 31 == 0) {
+                window_bits = MZ_DEFAULT_WINDOW_BITS;  // zlib header, checked by miniz with the Adler-32
+            }
+        }
+        if (duckdb_miniz::mz_inflateInit2(&stream_, window_bits) != duckdb_miniz::MZ_OK) {
+            error_ = "Failed to initialize decompression";
+            return false;
         }
+        inflating_ = true;
+        std::string rest = header_.substr(header_size);
+        header_.clear();
+        return inflate(rest.data(), rest.size(), sink);
+    }
+
+    // True once the compressed stream arrived completely (always true for identity)
+    bool finished() const {
+        return kind_ == IDENTITY || (ended_ && (kind_ != GZIP || header_.size() == 8));
+    }
 
-        // Process each response
-        for (const auto& response : response_nodes) {
-            WebDavFile file;
+    const std::string& error() const { return error_; }
+
+private:
+    enum Kind { IDENTITY, GZIP, DEFLATE };
+
+    static const size_t OUTPUT_SIZE = 65536;
+
+    void reset() {
+        if (inflating_) {
+            duckdb_miniz::mz_inflateEnd(&stream_);
+        }
+        memset(&stream_, 0, sizeof(stream_));
+        kind_ = IDENTITY;
+        inflating_ = false;
+        ended_ = false;
+        header_.clear();
+        error_.clear();
+        crc_ = MZ_CRC32_INIT;
+        size_ = 0;
+    }
 
-            // Extract href
-            pugi::xml_node href_node;
-            for (auto child : response.children()) {
-                std::string child_name = child.name();
-                if (child_name.find("href") != std::string::npos) {
-                    href_node = child;
-                    break;
+    // RFC 1952 member header: 1 = complete (header_size set), 0 = need more bytes, -1 = invalid
+    int parse_gzip_header(size_t& header_size) {
+        const std::string& h = header_;
+        if (h.size() < 10) {
+            return 0;
+        }
+        if (static_cast<unsigned char>(h[0]) != 0x1F || static_cast<unsigned char>(h[1]) != 0x8B || h[2] != 8) {
+            error_ = "Invalid gzip header";
+            return -1;
+        }
+        unsigned flags = static_cast<unsigned char>(h[3]);
+        size_t pos = 10;
+        if (flags & 0x04) {  // FEXTRA
+            if (h.size() < pos + 2) {
+                return 0;
+            }
+            pos += 2 + (static_cast<unsigned char>(h[pos]) | static_cast<unsigned char>(h[pos + 1]) << 8);
+        }
+        for (unsigned flag = 0x08; flag <= 0x10; flag <<= 1) {  // FNAME, FCOMMENT: zero-terminated
+            if (flags & flag) {
+                size_t end = pos < h.size() ? h.find('\0', pos) : std::string::npos;
+                if (end == std::string::npos) {
+                    return 0;
                 }
+                pos = end + 1;
             }
+        }
+        if (flags & 0x02) {  // FHCRC
+            pos += 2;
+        }
+        if (h.size() < pos) {
+            return 0;
+        }
+        header_size = pos;
+        return 1;
+    }
 
-            if (!href_node) continue;
+    bool inflate(const char* data, size_t size, const Sink& sink) {
+        stream_.next_in = reinterpret_cast<const unsigned char*>(data);
+        stream_.avail_in = static_cast<unsigned int>(size);
+        unsigned char output[OUTPUT_SIZE];
+        while (true) {
+            stream_.next_out = output;
+            stream_.avail_out = OUTPUT_SIZE;
+            int status = duckdb_miniz::mz_inflate(&stream_, duckdb_miniz::MZ_NO_FLUSH);
+            size_t produced = OUTPUT_SIZE - stream_.avail_out;
+            if (produced > 0) {
+                crc_ = duckdb_miniz::mz_crc32(crc_, output, produced);
+                size_ += produced;
+                if (!sink(reinterpret_cast<const char*>(output), produced)) {
+                    return false;
+                }
+            }
+            if (status == duckdb_miniz::MZ_STREAM_END) {
+                // The gzip trailer (or garbage) may follow in the same chunk
+                const char* rest = reinterpret_cast<const char*>(stream_.next_in);
+                size_t rest_size = stream_.avail_in;
+                duckdb_miniz::mz_inflateEnd(&stream_);
+                inflating_ = false;
+                ended_ = true;
+                return trailer(rest, rest_size);
+            }
+            if (status != duckdb_miniz::MZ_OK && status != duckdb_miniz::MZ_BUF_ERROR) {
+                error_ = "Corrupt compressed data";
+                return false;
+            }
+            if (stream_.avail_in == 0 && stream_.avail_out != 0) {
+                return true;  // everything consumed, wait for the next chunk
+            }
+            if (status == duckdb_miniz::MZ_BUF_ERROR && produced == 0) {
+                error_ = "Corrupt compressed data";
+                return false;
+            }
+        }
+    }
 
-            file.href = href_node.child_value();
+    // Bytes after the end of the deflate stream: the 8-byte gzip trailer (CRC-32, length mod 2^32)
+    bool trailer(const char* data, size_t size) {
+        size_t wanted = kind_ == GZIP ? 8 : 0;
+        if (header_.size() + size > wanted) {
+            error_ = "Unexpected data after the end of the compressed body";
+            return false;
+        }
+        header_.append(data, size);
+        if (kind_ == GZIP && header_.size() == 8) {
+            uint32_t crc = 0;
+            uint32_t length = 0;
+            for (int i = 3; i >= 0; --i) {
+                crc = crc << 8 | static_cast<unsigned char>(header_[i]);
+                length = length << 8 | static_cast<unsigned char>(header_[4 + i]);
+            }
+            if (crc != static_cast<uint32_t>(crc_) || length != static_cast<uint32_t>(size_)) {
+                error_ = "gzip checksum mismatch";
+                return false;
+            }
+        }
+        return true;
+    }
 
-            // Skip the folder itself (base_path)
-            if (file.href == base_path_ || file.href == base_path_.substr(0, base_path_.size() - 1)) {
-                continue;
+    Kind kind_;
+    duckdb_miniz::mz_stream stream_;
+    bool inflating_;
+    bool ended_;
+    std::string header_;  // gzip header until inflating starts, then the trailer
+    duckdb_miniz::mz_ulong crc_;
+    uint64_t size_;       // decoded bytes
+    std::string error_;
+};
+
+int WebDavClient::propfind(const std::string& path, const std::string& depth,
+                           const std::function<void(const WebDavFile&)>& on_entry, std::string& error) {
+    // Build PROPFIND request
+    CPPHTTPLIB_NAMESPACE::Request req;
+    req.method = "PROPFIND";
+    req.path = path;
+    req.set_header("Authorization", make_auth_header().c_str());
+    req.set_header("Depth", depth.c_str());
+    req.set_header("Content-Type", "application/xml");
+    req.set_header("Accept-Encoding", compression_ ? ACCEPT_COMPRESSED : ACCEPT_IDENTITY);
+    req.body = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+               "<d:propfind xmlns:d=\"DAV:\">"
+               "<d:prop><d:resourcetype/><d:getetag/><d:getcontentlength/><d:getlastmodified/></d:prop>"
+               "</d:propfind>";
+
+    // The body is parsed while it arrives; entries are passed on right away (the folder itself
+    // excluded), an error status keeps the start of the body for the message
+    std::string self = strip_trailing_slash(path);
+    MultistatusParser parser([&](const pugi::xml_node& response) {
+        WebDavFile file;
+        if (parse_propfind_entry(response, file) && strip_trailing_slash(file.href) != self) {
+            std::string decoded_href = url_decode(file.href);
+            file.name = extract_filename(strip_trailing_slash(decoded_href));
+            std::string decoded_base = url_decode(base_path_);
+            file.path = decoded_href.compare(0, decoded_base.size(), decoded_base) == 0
+                            ? strip_trailing_slash(decoded_href.substr(decoded_base.size()))
+                            : file.name;
+            on_entry(file);
+        }
+    });
+    int status = 0;
+    size_t received = 0;
+    std::string error_body;
+    bool parse_failed = false;
+    ContentDecoder decoder;
+    std::string encoding;
+    bool unsupported_encoding = false;
+    req.response_handler = [&](const CPPHTTPLIB_NAMESPACE::Response& response) {
+        status = response.status;
+        encoding = response.get_header_value("Content-Encoding");
+        unsupported_encoding = !decoder.start(encoding);
+        return !unsupported_encoding;
+    };
+    req.content_receiver = [&](const char* data, size_t data_length, uint64_t, uint64_t) {
+        received += data_length;
+        return decoder.feed(data, data_length, [&](const char* decoded, size_t decoded_length) {
+            if (status != 207) {
+                error_body.append(decoded, std::min(decoded_length, 200 - std::min<size_t>(200, error_body.size())));
+                return true;
+            }
+            if (!parser.feed(decoded, decoded_length)) {
+                parse_failed = true;
+                return false;
             }
+            return true;
+        });
+    };
+
+    // Take a keep-alive connection from the pool; a failure on a reused connection (closed by
+    // the server while idle, nothing received yet) is retried once on a new connection
+    PooledConnection client(*pool_);
+    client->set_read_timeout(30, 0);
+    auto res = client->send(req);
+    if (!res && received == 0) {
+        client.reconnect();
+        client->set_read_timeout(30, 0);
+        res = client->send(req);
+    }
 
-            // Check if it's a collection
-            file.is_collection = false;
-            for (auto propstat : response.children()) {
-                std::string propstat_name = propstat.name();
-                if (propstat_name.find("propstat") != std::string::npos) {
-                    for (auto prop : propstat.children()) {
-                        std::string prop_name = prop.name();
-                        if (prop_name.find("prop") != std::string::npos) {
-                            for (auto resourcetype : prop.children()) {
-                                std::string rt_name = resourcetype.name();
-                                if (rt_name.find("resourcetype") != std::string::npos) {
-                                    for (auto collection : resourcetype.children()) {
-                                        std::string coll_name = collection.name();
-                                        if (coll_name.find("collection") != std::string::npos) {
-                                            file.is_collection = true;
-                                            break;
-                                        }
-                                    }
-                                }
-                            }
-                        }
+    if (parse_failed) {
+        client.discard();
+        error = "Failed to parse PROPFIND XML response: " + parser.error();
+        return 0;
+    }
+    if (unsupported_encoding) {
+        client.discard();
+        error = "PROPFIND response has an unsupported Content-Encoding: " + encoding;
+        return 0;
+    }
+    if (!decoder.error().empty()) {
+        client.discard();
+        error = "Failed to decode PROPFIND response (" + encoding + "): " + decoder.error();
+        return 0;
+    }
+    if (res && status == 207 && !decoder.finished()) {
+        error = "Compressed PROPFIND response ended early";
+        return 0;
+    }
+    if (!res) {
+        client.discard();
+        error = "Connection failed to " + proto_host_port_ + " - check URL and network connectivity";
+        return 0;
+    }
+
+    // Check HTTP status
+    if (status == 401) {
+        error = "Authentication failed: check username and password";
+    } else if (status != 207) {
+        std::ostringstream oss;
+        oss << "PROPFIND request failed with status " << status;
+        if (!error_body.empty()) {
+            oss << ": " << error_body;
+        }
+        error = oss.str();
+    }
+    return status;
+}
+
+bool WebDavClient::list_tree(std::vector<std::string> pending,
+                             const std::function<void(const WebDavFile&)>& on_file, std::string& error) {
+    std::mutex lock;
+    std::condition_variable changed;
+    size_t active = 0;
+    bool failed = false;
+
+    // Workers take a folder, list it with Depth 1 and queue its subfolders; the walk is done
+    // when no folder is pending and none is being listed
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            changed.wait(guard, [&] { return failed || !pending.empty() || active == 0; });
+            if (failed || pending.empty()) {
+                return;
+            }
+            std::string path = pending.back();
+            pending.pop_back();
+            active++;
+            guard.unlock();
+
+            std::vector<WebDavFile> entries;
+            std::string folder_error;
+            int status = propfind(path, "1", [&](const WebDavFile& entry) { entries.push_back(entry); },
+                                  folder_error);
+
+            guard.lock();
+            active--;
+            if (status != 207) {
+                if (!failed) {
+                    error = folder_error;
+                }
+                failed = true;
+            } else {
+                for (const auto& entry : entries) {
+                    if (entry.is_collection) {
+                        pending.push_back(entry.href);
+                    } else {
+                        on_file(entry);
                     }
                 }
             }
+            changed.notify_all();
+        }
+    };
 
-            // Extract and decode filename
-            std::string decoded_href = url_decode(file.href);
-            file.name = extract_filename(decoded_href);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < max_connections_; ++i) {
+        threads.push_back(std::thread(worker));
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return !failed;
+}
+
+WebDavResult WebDavClient::list_files(bool filter_zips, bool recursive) {
+    WebDavResult result;
+    result.success = false;
+
+    std::mutex files_lock;
+    auto add_file = [&](const WebDavFile& file) {
+        if (filter_zips && !ends_with_ignore_case(file.name, ".zip")) {
+            return; // Skip non-zip files
+        }
+        std::lock_guard<std::mutex> guard(files_lock);
+        result.files.push_back(file);
+    };
+
+    try {
+        if (!recursive) {
+            if (propfind(base_path_, "1", [&](const WebDavFile& entry) {
+                    if (!entry.is_collection) {
+                        add_file(entry);
+                    }
+                }, result.error_message) != 207) {
+                return result;
+            }
+            result.success = true;
+            return result;
+        }
 
-            // Filter if needed
-            if (file.is_collection) {
-                continue; // Skip directories
+        // Recursive: one Depth-infinity request where the server allows it. Servers that refuse
+        // it (403 propfind-finite-depth, 400, 501) are walked folder by folder instead; servers
+        // that quietly answer with Depth 1 (e.g. Nextcloud) leave folders without entries below
+        // them, which are walked the same way.
+        std::vector<std::string> collections;
+        std::set<std::string> parents;
+        std::string error;
+        int status = propfind(base_path_, "infinity", [&](const WebDavFile& entry) {
+            std::string href = strip_trailing_slash(entry.href);
+            parents.insert(href.substr(0, href.rfind('/')));
+            if (entry.is_collection) {
+                collections.push_back(href);
+            } else {
+                add_file(entry);
             }
+        }, error);
 
-            if (filter_zips && !ends_with_ignore_case(file.name, ".zip")) {
-                continue; // Skip non-zip files
+        std::vector<std::string> pending;
+        if (status == 207) {
+            for (const auto& collection : collections) {
+                if (!parents.count(collection)) {
+                    pending.push_back(collection + "/");
+                }
             }
+        } else if (status == 400 || status == 403 || status == 501) {
+            result.files.clear();
+            pending.push_back(base_path_);
+        } else {
+            result.error_message = error;
+            return result;
+        }
 
-            result.files.push_back(file);
+        if (!pending.empty() && !list_tree(pending, add_file, result.error_message)) {
+            return result;
         }
 
+        // Workers finish in any order; list by path
+        std::sort(result.files.begin(), result.files.end(),
+                  [](const WebDavFile& a, const WebDavFile& b) { return a.path < b.path; });
         result.success = true;
 
     } catch (const std::exception& e) {
@@ -303,91 +872,597 @@ WebDavResult WebDavClient::list_files(bool filter_zips) {
     return result;
 }
 
-WebDavDownloadResult WebDavClient::download_file(const std::string& href, const std::string& local_dir) {
-    WebDavDownloadResult result;
-    result.success = false;
+// Size of the write buffer of a download; the response body is never held in memory as a whole
+static const size_t DOWNLOAD_BUFFER_SIZE = 1 << 20;
 
-    try {
-        // Create HTTP client
-        CPPHTTPLIB_NAMESPACE::Client client(proto_host_port_.c_str());
+// Size of a local file, -1 if it doesn't exist
+static int64_t local_file_size(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return -1;
+    }
+    return static_cast<int64_t>(st.st_size);
+}
 
-        // Configure SSL and timeouts
-#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
-        client.enable_server_certificate_verification(false);
-#endif
-        client.set_connection_timeout(30, 0);
-        client.set_read_timeout(60, 0); // Longer timeout for downloads
-        client.set_write_timeout(30, 0);
+// Local file a download is streamed into: chunks from the connection are collected in a
+// fixed-size buffer and written out whenever it is full, finish() flushes and syncs to disk
+class DownloadFile {
+public:
+    explicit DownloadFile(const std::string& path)
+        : path_(path), fd_(-1), used_(0), bytes_written_(0) {}
 
-        // Prepare headers
-        CPPHTTPLIB_NAMESPACE::Headers headers = {
-            {"Authorization", make_auth_header()}
-        };
+    ~DownloadFile() {
+        if (fd_ >= 0) {
+            close_fd();
+        }
+    }
 
-        // Send GET request
-        auto res = client.Get(href.c_str(), headers);
+    // Open for writing; append continues an existing partial file
+    bool open(bool append) {
+        if (fd_ >= 0) {
+            close_fd();
+        }
+#ifdef _WIN32
+        int flags = _O_WRONLY | _O_CREAT | _O_BINARY | (append ? _O_APPEND : _O_TRUNC);
+        fd_ = _open(path_.c_str(), flags, _S_IREAD | _S_IWRITE);
+#else
+        int flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+        fd_ = ::open(path_.c_str(), flags, 0644);
+#endif
+        if (fd_ < 0) {
+            return false;
+        }
+        used_ = 0;
+        bytes_written_ = append ? std::max<int64_t>(0, local_file_size(path_)) : 0;
+        buffer_.resize(DOWNLOAD_BUFFER_SIZE);
+        return true;
+    }
 
-        // Check for errors
-        if (!res) {
-            result.error_message = "Connection failed while downloading " + href;
-            return result;
+    bool write(const char* data, size_t length) {
+        while (length > 0) {
+            size_t n = std::min(length, buffer_.size() - used_);
+            memcpy(&buffer_[used_], data, n);
+            used_ += n;
+            data += n;
+            length -= n;
+            if (used_ == buffer_.size() && !flush()) {
+                return false;
+            }
         }
+        return true;
+    }
 
-        if (res->status == 401) {
-            result.error_message = "Authentication failed while downloading " + href;
-            return result;
+    // Flush the buffer, sync the file to disk and close it. Also used when a transfer broke off:
+    // everything received so far stays in the file for a resumed download.
+    bool finish() {
+        if (fd_ < 0) {
+            return true;
+        }
+        if (!flush()) {
+            close_fd();
+            return false;
         }
+#ifdef _WIN32
+        bool synced = _commit(fd_) == 0;
+#else
+        bool synced = fsync(fd_) == 0;
+#endif
+        return close_fd() && synced;
+    }
 
-        if (res->status == 404) {
-            result.error_message = "File not found: " + href;
-            return result;
+    // Close and delete the file
+    void discard() {
+        if (fd_ >= 0) {
+            close_fd();
         }
+        remove(path_.c_str());
+        bytes_written_ = 0;
+    }
 
-        if (res->status != 200) {
-            std::ostringstream oss;
-            oss << "Download failed with status " << res->status << " for " << href;
-            result.error_message = oss.str();
-            return result;
+    bool is_open() const { return fd_ >= 0; }
+    // Size of the file including data of earlier attempts
+    int64_t bytes_written() const { return bytes_written_; }
+
+private:
+    std::string path_;
+    int fd_;
+    std::vector<char> buffer_;
+    size_t used_;
+    int64_t bytes_written_;
+
+    bool flush() {
+        size_t offset = 0;
+        while (offset < used_) {
+#ifdef _WIN32
+            int n = _write(fd_, &buffer_[offset], static_cast<unsigned int>(used_ - offset));
+#else
+            ssize_t n = ::write(fd_, &buffer_[offset], used_ - offset);
+#endif
+            if (n <= 0) {
+                return false;
+            }
+            offset += static_cast<size_t>(n);
         }
+        bytes_written_ += static_cast<int64_t>(used_);
+        used_ = 0;
+        return true;
+    }
 
-        // Extract filename and construct local path
-        std::string decoded_href = url_decode(href);
-        std::string filename = extract_filename(decoded_href);
+    bool close_fd() {
+#ifdef _WIN32
+        bool closed = _close(fd_) == 0;
+#else
+        bool closed = ::close(fd_) == 0;
+#endif
+        fd_ = -1;
+        return closed;
+    }
+};
+
+// What a partial download (<file>.part) belongs to, stored next to it in <file>.part.info:
+// the ETag and total size of the remote file when the download started
+struct PartInfo {
+    std::string etag;
+    int64_t size;
+
+    PartInfo() : size(-1) {}
+};
+
+static bool read_part_info(const std::string& path, PartInfo& info) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string size_line;
+    if (!std::getline(in, info.etag) || !std::getline(in, size_line)) {
+        return false;
+    }
+    info.size = std::strtoll(size_line.c_str(), nullptr, 10);
+    return !info.etag.empty();
+}
+
+static bool write_part_info(const std::string& path, const PartInfo& info) {
+    std::ofstream out(path, std::ios::trunc);
+    out << info.etag << "\n" << info.size << "\n";
+    out.close();
+    return static_cast<bool>(out);
+}
+
+// Total size from a "Content-Range: bytes 100-999/1000" header, -1 if unknown
+static int64_t content_range_total(const std::string& content_range) {
+    size_t slash = content_range.find('/');
+    if (slash == std::string::npos || content_range.compare(slash + 1, 1, "*") == 0) {
+        return -1;
+    }
+    return std::strtoll(content_range.c_str() + slash + 1, nullptr, 10);
+}
+
+// First byte from a "Content-Range: bytes 100-999/1000" header, -1 if malformed
+static int64_t content_range_start(const std::string& content_range) {
+    size_t space = content_range.find(' ');
+    if (space == std::string::npos) {
+        return -1;
+    }
+    return std::strtoll(content_range.c_str() + space + 1, nullptr, 10);
+}
 
-        std::string local_path = local_dir;
-        if (!local_path.empty() && local_path.back() != '/' && local_path.back() != '\\') {
-            local_path += '/';
+// HTTP status worth another attempt: timeouts, rate limiting and server-side errors
+static bool is_transient_status(int status) {
+    return status == 408 || status == 429 || status >= 500;
+}
+
+void WebDavClient::set_retry_policy(int max_attempts, int initial_backoff_ms) {
+    max_attempts_ = std::max(1, max_attempts);
+    initial_backoff_ms_ = std::max(0, initial_backoff_ms);
+}
+
+void WebDavClient::set_compression(bool enabled) {
+    compression_ = enabled;
+}
+
+WebDavDownloadResult WebDavClient::download_file(const std::string& href, const std::string& local_dir,
+                                                 int64_t expected_size, const std::string& etag) {
+    WebDavDownloadResult result;
+    result.success = false;
+
+    // Extract filename and construct local path
+    std::string decoded_href = url_decode(href);
+    std::string filename = extract_filename(decoded_href);
+
+    std::string local_path = local_dir;
+    if (!local_path.empty() && local_path.back() != '/' && local_path.back() != '\\') {
+        local_path += '/';
+    }
+    local_path += filename;
+
+    // The body goes to <file>.part and is renamed once complete; <file>.part.info records which
+    // version of the remote file it belongs to
+    std::string part_path = local_path + ".part";
+    std::string info_path = part_path + ".info";
+    DownloadFile outfile(part_path);
+
+    PartInfo expected;
+    expected.etag = etag;
+    expected.size = expected_size;
+
+    int backoff_ms = initial_backoff_ms_;
+    bool identity_only = false;  // set once an encoded body failed to decode
+    for (int attempt = 1; ; ++attempt) {
+        // Resume a partial file only if it belongs to the same version (same ETag, and size if known)
+        int64_t offset = 0;
+        PartInfo part;
+        int64_t part_size = local_file_size(part_path);
+        if (part_size > 0 && read_part_info(info_path, part) &&
+            (expected.etag.empty() || part.etag == expected.etag) &&
+            (expected.size < 0 || part.size < 0 || part.size == expected.size) &&
+            (part.size < 0 || part_size <= part.size)) {
+            offset = part_size;
+            expected.etag = part.etag;
+            if (expected.size < 0) {
+                expected.size = part.size;
+            }
+        } else if (part_size >= 0) {
+            remove(part_path.c_str());
+            remove(info_path.c_str());
         }
-        local_path += filename;
 
-        // Write to file
-        std::ofstream outfile(local_path, std::ios::binary);
-        if (!outfile) {
-            result.error_message = "Failed to open local file for writing: " + local_path;
-            return result;
+        int status = 0;
+        int64_t received = 0;
+        std::string encoding;
+        bool complete = false;
+        bool retry = false;
+        std::string error;
+
+        if (offset > 0 && offset == expected.size) {
+            // Everything arrived in an earlier attempt, only the rename is missing
+            complete = true;
+        } else {
+            try {
+                // Take a keep-alive connection from the pool
+                PooledConnection client(*pool_);
+
+                // Prepare headers; a resumed request asks for the rest of the file, and If-Range makes
+                // the server send the whole file instead if it changed in the meantime
+                CPPHTTPLIB_NAMESPACE::Headers headers = {
+                    {"Authorization", make_auth_header()}
+                };
+                if (offset > 0) {
+                    headers.insert(std::make_pair("Range", "bytes=" + std::to_string(offset) + "-"));
+                    headers.insert(std::make_pair("If-Range", expected.etag));
+                }
+                // A whole-file request of an uncompressed format may come gzip/deflate-encoded and is
+                // decoded on the way to disk; a resumed request needs the plain bytes
+                bool compress = compression_ && !identity_only && offset == 0 && !is_compressed_format(filename);
+                headers.insert(std::make_pair("Accept-Encoding", compress ? ACCEPT_COMPRESSED : ACCEPT_IDENTITY));
+
+                // Send GET request; the body is handed to the content receiver chunk by chunk.
+                // The part file is only touched once the server answered 200 or 206.
+                bool open_failed = false;
+                bool write_failed = false;
+                bool unsupported_encoding = false;
+                ContentDecoder decoder;
+                auto get = [&]() {
+                    client->set_read_timeout(60, 0); // Longer timeout for downloads
+                    return client->Get(href.c_str(), headers,
+                        [&](const CPPHTTPLIB_NAMESPACE::Response& response) {
+                            status = response.status;
+                            if (status == 200 || status == 206) {
+                                encoding = response.get_header_value("Content-Encoding");
+                                unsupported_encoding = !decoder.start(encoding) || (status == 206 && decoder.is_encoded());
+                                if (unsupported_encoding) {
+                                    return false;
+                                }
+                            }
+                            bool append = false;
+                            int64_t total = -1;
+                            if (status == 206) {
+                                std::string range = response.get_header_value("Content-Range");
+                                if (content_range_start(range) != offset) {
+                                    return false;
+                                }
+                                append = true;
+                                total = content_range_total(range);
+                            } else if (status == 200) {
+                                // The Content-Length of an encoded body is its compressed size
+                                if (response.has_header("Content-Length") && !decoder.is_encoded()) {
+                                    total = std::strtoll(response.get_header_value("Content-Length").c_str(), nullptr, 10);
+                                }
+                            } else {
+                                return false;
+                            }
+                            if (total >= 0) {
+                                expected.size = total;
+                            }
+                            if (expected.etag.empty() && response.has_header("ETag")) {
+                                expected.etag = response.get_header_value("ETag");
+                            }
+                            if (!outfile.open(append)) {
+                                open_failed = true;
+                                return false;
+                            }
+                            if (!append && !expected.etag.empty()) {
+                                write_part_info(info_path, expected);
+                            }
+                            return true;
+                        },
+                        [&](const char* data, size_t data_length) {
+                            received += static_cast<int64_t>(data_length);
+                            return decoder.feed(data, data_length, [&](const char* decoded, size_t decoded_length) {
+                                if (!outfile.write(decoded, decoded_length)) {
+                                    write_failed = true;
+                                    return false;
+                                }
+                                return true;
+                            });
+                        });
+                };
+                auto res = get();
+                if (!res && status == 0) {
+                    // No response at all: the reused connection may have been closed by the server
+                    client.reconnect();
+                    res = get();
+                }
+                if (!res) {
+                    // Aborted or broken off mid-response: the connection can't be reused
+                    client.discard();
+                }
+
+                // Keep what arrived (also after a broken connection) for the next attempt
+                bool flushed = outfile.finish();
+                result.bytes_transferred += received;
+
+                if (open_failed) {
+                    result.error_message = "Failed to open local file for writing: " + part_path;
+                    return result;
+                }
+                if (write_failed || !flushed) {
+                    outfile.discard();
+                    remove(info_path.c_str());
+                    result.error_message = "Failed to write downloaded data to: " + part_path;
+                    return result;
+                }
+                if (unsupported_encoding) {
+                    result.error_message = "Unsupported Content-Encoding '" + encoding + "' while downloading " + href;
+                    return result;
+                }
+
+                if (status == 401) {
+                    result.error_message = "Authentication failed while downloading " + href;
+                    return result;
+                }
+                if (status == 404) {
+                    remove(part_path.c_str());
+                    remove(info_path.c_str());
+                    result.error_message = "File not found: " + href;
+                    return result;
+                }
+                if (!decoder.error().empty()) {
+                    // What was decoded so far can't be trusted: start over without compression
+                    outfile.discard();
+                    remove(info_path.c_str());
+                    identity_only = true;
+                    retry = true;
+                    error = "Failed to decode " + href + ": " + decoder.error();
+                } else if (status == 416) {
+                    // The range doesn't fit the file on the server: start over
+                    remove(part_path.c_str());
+                    remove(info_path.c_str());
+                    retry = true;
+                    error = "Range not satisfiable for " + href;
+                } else if (status == 206 && !res && received == 0 && !write_failed) {
+                    // Content-Range didn't start where the partial file ends: start over
+                    remove(part_path.c_str());
+                    remove(info_path.c_str());
+                    retry = true;
+                    error = "Server resumed " + href + " at the wrong offset";
+                } else if (status != 0 && status != 200 && status != 206) {
+                    std::ostringstream oss;
+                    oss << "Download failed with status " << status << " for " << href;
+                    error = oss.str();
+                    if (!is_transient_status(status)) {
+                        result.error_message = error;
+                        return result;
+                    }
+                    retry = true;
+                } else if (!res) {
+                    std::ostringstream oss;
+                    if (status == 0) {
+                        oss << "Connection failed while downloading " << href;
+                    } else {
+                        oss << "Connection lost after " << outfile.bytes_written() << " bytes while downloading " << href;
+                    }
+                    error = oss.str();
+                    retry = true;
+                } else if (decoder.is_encoded() && !decoder.finished()) {
+                    // The connection closed before the end of the compressed stream; the decoded part
+                    // is kept and resumed
+                    error = "Compressed download of " + href + " ended early";
+                    retry = true;
+                } else if (expected.size >= 0 && outfile.bytes_written() != expected.size) {
+                    std::ostringstream oss;
+                    oss << "Incomplete download of " << href << ": received " << outfile.bytes_written()
+                        << " of " << expected.size << " bytes";
+                    error = oss.str();
+                    if (outfile.bytes_written() > expected.size) {
+                        outfile.discard();
+                        remove(info_path.c_str());
+                    }
+                    retry = true;
+                } else {
+                    complete = true;
+                }
+            } catch (const std::exception& e) {
+                outfile.finish();
+                error = "Exception during download: " + std::string(e.what());
+                retry = true;
+            }
         }
 
-        outfile.write(res->body.c_str(), res->body.size());
-        outfile.close();
+        if (complete) {
+            remove(local_path.c_str());
+            if (rename(part_path.c_str(), local_path.c_str()) != 0) {
+                result.error_message = "Failed to move downloaded file to: " + local_path;
+                return result;
+            }
+            remove(info_path.c_str());
+            result.success = true;
+            result.local_path = local_path;
+            result.bytes_written = local_file_size(local_path);
+            result.content_encoding = (encoding == "identity") ? "" : encoding;
+            // A 200 answer to a Range request (If-Range mismatch) restarted the file
+            result.resumed = result.resumed || (offset > 0 && status != 200);
+            return result;
+        }
 
-        if (!outfile) {
-            result.error_message = "Failed to write downloaded data to: " + local_path;
+        result.resumed = result.resumed || (offset > 0 && status == 206);
+        if (!retry || attempt >= max_attempts_) {
+            // A partial file with a known version stays for the next run to resume
+            std::ostringstream oss;
+            oss << error;
+            if (attempt > 1) {
+                oss << " (gave up after " << attempt << " attempts)";
+            }
+            result.error_message = oss.str();
             return result;
         }
 
-        result.success = true;
-        result.local_path = local_path;
+        // Exponential backoff before the next attempt
+        std::this_thread::sleep_for(std::chrono::milliseconds(backoff_ms));
+        backoff_ms = std::min(backoff_ms * 2, 30000);
+    }
+}
 
-    } catch (const std::exception& e) {
-        result.error_message = "Exception during download: " + std::string(e.what());
-    } catch (...) {
-        result.error_message = "Unknown exception during download";
+bool WebDavClient::read_file(const std::string& href, int64_t offset, int64_t length,
+                             const std::function<bool(const char*, size_t)>& on_data, std::string& error) {
+    if (length == 0) {
+        return true;
+    }
+    CPPHTTPLIB_NAMESPACE::Headers headers = {
+        {"Authorization", make_auth_header()}
+    };
+    if (offset > 0 || length > 0) {
+        std::string range = "bytes=" + std::to_string(offset) + "-";
+        if (length > 0) {
+            range += std::to_string(offset + length - 1);
+        }
+        headers.insert(std::make_pair("Range", range));
+    }
+    // Only a whole file may come compressed (see download_file)
+    bool compress = compression_ && offset == 0 && length < 0 && !is_compressed_format(url_decode(href));
+    headers.insert(std::make_pair("Accept-Encoding", compress ? ACCEPT_COMPRESSED : ACCEPT_IDENTITY));
+
+    int status = 0;
+    int64_t skip = 0;            // leading bytes to drop (server sent more than asked for)
+    int64_t remaining = length;  // bytes still wanted, -1 = all
+    bool stopped = false;        // on_data returned false
+    bool bad_range = false;
+    std::string encoding;
+    bool unsupported_encoding = false;
+    ContentDecoder decoder;
+    auto deliver = [&](const char* data, size_t data_length) {
+        if (skip > 0) {
+            size_t n = static_cast<size_t>(std::min<int64_t>(skip, static_cast<int64_t>(data_length)));
+            data += n;
+            data_length -= n;
+            skip -= static_cast<int64_t>(n);
+        }
+        if (remaining >= 0) {
+            data_length = static_cast<size_t>(std::min<int64_t>(remaining, static_cast<int64_t>(data_length)));
+            remaining -= static_cast<int64_t>(data_length);
+        }
+        if (data_length > 0 && !on_data(data, data_length)) {
+            stopped = true;
+            return false;
+        }
+        // Everything wanted arrived: stop reading a body the server sends in full
+        return remaining != 0 || status == 206;
+    };
+    PooledConnection client(*pool_);
+    auto get = [&]() {
+        client->set_read_timeout(60, 0);
+        return client->Get(href.c_str(), headers,
+            [&](const CPPHTTPLIB_NAMESPACE::Response& response) {
+                status = response.status;
+                if (status == 200 || status == 206) {
+                    encoding = response.get_header_value("Content-Encoding");
+                    unsupported_encoding = !decoder.start(encoding) || (status == 206 && decoder.is_encoded());
+                    if (unsupported_encoding) {
+                        return false;
+                    }
+                }
+                if (status == 200) {
+                    skip = offset;
+                } else if (status == 206) {
+                    int64_t start = content_range_start(response.get_header_value("Content-Range"));
+                    skip = offset - start;
+                    if (start < 0 || skip < 0) {
+                        bad_range = true;
+                        return false;
+                    }
+                } else {
+                    return status == 416;
+                }
+                return true;
+            },
+            [&](const char* data, size_t data_length) {
+                return decoder.feed(data, data_length, deliver);
+            });
+    };
+    auto res = get();
+    if (!res && status == 0) {
+        // No response at all: the reused connection may have been closed by the server
+        client.reconnect();
+        res = get();
+    }
+    if (!res) {
+        client.discard();
     }
 
-    return result;
+    if (stopped) {
+        error = "Reading " + href + " was stopped";
+        return false;
+    }
+    if (status == 416) {
+        return true;
+    }
+    if (status == 401) {
+        error = "Authentication failed while reading " + href;
+        return false;
+    }
+    if (status == 404) {
+        error = "File not found: " + href;
+        return false;
+    }
+    if (bad_range) {
+        error = "Server sent a range of " + href + " that doesn't start at " + std::to_string(offset);
+        return false;
+    }
+    if (unsupported_encoding) {
+        error = "Unsupported Content-Encoding '" + encoding + "' while reading " + href;
+        return false;
+    }
+    if (!decoder.error().empty()) {
+        error = "Failed to decode " + href + ": " + decoder.error();
+        return false;
+    }
+    if (status != 200 && status != 206) {
+        error = status == 0 ? "Connection failed while reading " + href
+                            : "GET failed with status " + std::to_string(status) + " for " + href;
+        return false;
+    }
+    if (!res && remaining != 0) {
+        error = "Connection lost while reading " + href;
+        return false;
+    }
+    if (!decoder.finished() && remaining != 0) {
+        error = "Compressed body of " + href + " ended early";
+        return false;
+    }
+    return true;
 }
 
-std::string create_temp_download_dir() {
+// Platform temp directory, ending with a separator
+static std::string temp_base_dir() {
     std::string temp_base;
 
 #ifdef _WIN32
@@ -420,20 +1495,57 @@ std::string create_temp_download_dir() {
         temp_base += '/';
 #endif
     }
+    return temp_base;
+}
 
-    // Create unique subdirectory name
-    std::ostringstream oss;
-    oss << "gdpdu_webdav_" << std::time(nullptr) << "_" << (rand() % 10000);
-    std::string dir_name = oss.str();
+std::string create_temp_download_dir() {
+    std::string temp_base = temp_base_dir();
+    if (temp_base.empty()) {
+        return "";
+    }
+
+    // Create unique subdirectory name; the counter keeps directories created at the same time
+    // (parallel extraction) apart, a name that exists anyway is retried with the next number
+    static std::atomic<unsigned> sequence(0);
+    for (int attempt = 0; attempt < 100; ++attempt) {
+        std::ostringstream oss;
+        oss << "gdpdu_webdav_" << std::time(nullptr) << "_" << (rand() % 10000) << "_" << sequence++;
+        std::string full_path = temp_base + oss.str();
+
+        // Create directory
+        if (mkdir(full_path.c_str(), 0755) == 0) {
+            return full_path;
+        }
+        if (errno != EEXIST) {
+            break;
+        }
+    }
+    return ""; // Failed to create directory
+}
 
-    std::string full_path = temp_base + dir_name;
+std::string url_directory_name(const std::string& url) {
+    // FNV-1a hash of the URL: stable across runs and builds
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : url) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    std::ostringstream oss;
+    oss << "gdpdu_webdav_" << std::hex << hash;
+    return oss.str();
+}
 
-    // Create directory
-    int mkdir_result = mkdir(full_path.c_str(), 0755);
-    if (mkdir_result != 0) {
-        return ""; // Failed to create directory
+std::string get_download_dir(const std::string& url) {
+    std::string temp_base = temp_base_dir();
+    if (temp_base.empty()) {
+        return "";
     }
 
+    std::string full_path = temp_base + url_directory_name(url);
+
+    if (mkdir(full_path.c_str(), 0755) != 0 && errno != EEXIST) {
+        return "";
+    }
     return full_path;
 }
 
@@ -1,10 +1,12 @@
 #include "zip_extractor.hpp"
 #include "webdav_client.hpp"
 #include "miniz.hpp"
+#include <pugixml.hpp>
 
 #include <fstream>
 #include <cstring>
 #include <vector>
+#include <map>
 
 #ifdef _WIN32
 #include <direct.h>
@@ -192,6 +194,115 @@ ZipExtractResult extract_zip(const std::string& zip_path) {
     }
 }
 
+// Random-access reads for miniz straight from the file
+static size_t zip_file_read(void* opaque, duckdb_miniz::mz_uint64 file_ofs, void* buf, size_t n) {
+    std::ifstream* file = static_cast<std::ifstream*>(opaque);
+    file->clear();
+    file->seekg(static_cast<std::streamoff>(file_ofs), std::ios::beg);
+    file->read(static_cast<char*>(buf), static_cast<std::streamsize>(n));
+    return static_cast<size_t>(file->gcount());
+}
+
+bool init_zip_file_reader(duckdb_miniz::mz_zip_archive& zip, std::ifstream& file) {
+    memset(&zip, 0, sizeof(zip));
+    if (!file) {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    duckdb_miniz::mz_uint64 file_size = static_cast<duckdb_miniz::mz_uint64>(file.tellg());
+    zip.m_pRead = zip_file_read;
+    zip.m_pIO_opaque = &file;
+    return duckdb_miniz::mz_zip_reader_init(&zip, file_size, 0) != 0;
+}
+
+// Extract a single archive entry into a string
+static bool read_zip_entry(duckdb_miniz::mz_zip_archive& zip, const char* name, std::string& out) {
+    int index = duckdb_miniz::mz_zip_reader_locate_file(&zip, name, nullptr, 0);
+    if (index < 0) {
+        return false;
+    }
+    size_t size = 0;
+    void* data = duckdb_miniz::mz_zip_reader_extract_to_heap(&zip, static_cast<duckdb_miniz::mz_uint>(index), &size, 0);
+    if (!data) {
+        return false;
+    }
+    out.assign(static_cast<const char*>(data), size);
+    duckdb_miniz::mz_free(data);
+    return true;
+}
+
+// Element/attribute name without namespace prefix ("x:sheet" -> "sheet")
+static std::string local_name(const char* name) {
+    const char* colon = strchr(name, ':');
+    return colon ? std::string(colon + 1) : std::string(name);
+}
+
+std::vector<std::string> list_xlsx_sheets(const std::string& xlsx_path, std::string& error) {
+    std::vector<std::string> sheets;
+
+    std::ifstream file(xlsx_path, std::ios::binary);
+    if (!file) {
+        error = "Failed to open workbook: " + xlsx_path;
+        return sheets;
+    }
+
+    duckdb_miniz::mz_zip_archive zip;
+    if (!init_zip_file_reader(zip, file)) {
+        error = "Not a valid xlsx (zip) file: " + xlsx_path;
+        return sheets;
+    }
+
+    std::string workbook_xml;
+    std::string rels_xml;
+    bool have_workbook = read_zip_entry(zip, "xl/workbook.xml", workbook_xml);
+    bool have_rels = read_zip_entry(zip, "xl/_rels/workbook.xml.rels", rels_xml);
+    duckdb_miniz::mz_zip_reader_end(&zip);
+
+    if (!have_workbook) {
+        error = "Workbook has no xl/workbook.xml: " + xlsx_path;
+        return sheets;
+    }
+
+    // Relationship id -> type, to tell worksheets from chart sheets
+    std::map<std::string, std::string> rel_types;
+    pugi::xml_document rels_doc;
+    if (have_rels && rels_doc.load_buffer(rels_xml.data(), rels_xml.size())) {
+        for (pugi::xml_node rel : rels_doc.document_element().children()) {
+            if (local_name(rel.name()) == "Relationship") {
+                rel_types[rel.attribute("Id").value()] = rel.attribute("Type").value();
+            }
+        }
+    }
+
+    pugi::xml_document doc;
+    if (!doc.load_buffer(workbook_xml.data(), workbook_xml.size())) {
+        error = "Failed to parse xl/workbook.xml: " + xlsx_path;
+        return sheets;
+    }
+    for (pugi::xml_node node : doc.document_element().children()) {
+        if (local_name(node.name()) != "sheets") {
+            continue;
+        }
+        for (pugi::xml_node sheet : node.children()) {
+            if (local_name(sheet.name()) != "sheet") {
+                continue;
+            }
+            std::string rel_id;
+            for (pugi::xml_attribute attr : sheet.attributes()) {
+                if (strchr(attr.name(), ':') && local_name(attr.name()) == "id") {
+                    rel_id = attr.value();
+                }
+            }
+            auto rel = rel_types.find(rel_id);
+            if (rel != rel_types.end() && rel->second.find("/worksheet") == std::string::npos) {
+                continue;
+            }
+            sheets.push_back(sheet.attribute("name").value());
+        }
+    }
+    return sheets;
+}
+
 void cleanup_extract_dir(const std::string& dir_path) {
     cleanup_temp_dir(dir_path);
 }
@@ -165,6 +165,304 @@ SELECT '--- Test 11: Wrong delimiter detection ---' as test;
 SELECT CASE WHEN status LIKE '%delimiter%' THEN 'PASS' ELSE 'FAIL: expected delimiter warning, got ' || status END as test_wrong_delimiter
 FROM import_gdpdu_navision('test/fixtures/wrong_delimiter');
 
+-- ============================================================
+-- Test 12: Folder union mode (one table, source_file column, schema drift)
+-- ============================================================
+SELECT '--- Test 12: Folder union mode ---' as test;
+
+SELECT * FROM import_folder('test/fixtures/union_csv', 'csv', mode := 'union', table_name := 'umsatz');
+
+SELECT CASE WHEN cnt = 3 THEN 'PASS' ELSE 'FAIL: expected 3 rows, got ' || cnt::VARCHAR END as test_union_row_count
+FROM (SELECT COUNT(*) as cnt FROM "umsatz");
+
+SELECT CASE WHEN cnt = 2 THEN 'PASS' ELSE 'FAIL: expected 2 source files, got ' || cnt::VARCHAR END as test_union_source_files
+FROM (SELECT COUNT(DISTINCT source_file) as cnt FROM "umsatz");
+
+SELECT CASE WHEN kostenstelle IS NULL THEN 'PASS' ELSE 'FAIL: expected NULL kostenstelle for January rows, got ' || kostenstelle END as test_union_drift
+FROM "umsatz" WHERE source_file = 'umsatz_2024_01.csv' AND konto = 8400;
+
+-- ============================================================
+-- Test 13: Recursive folder import with exclude glob
+-- ============================================================
+SELECT '--- Test 13: Recursive folder import ---' as test;
+
+SELECT * FROM import_folder('test/fixtures/nested_csv', 'csv', recursive := true, exclude := 'backup');
+
+SELECT CASE WHEN cnt = 2 THEN 'PASS' ELSE 'FAIL: expected 2 tables, got ' || cnt::VARCHAR END as test_recursive_file_count
+FROM (SELECT COUNT(*) as cnt FROM import_folder('test/fixtures/nested_csv', 'csv', recursive := true, exclude := 'backup'));
+
+SELECT CASE WHEN betrag = 10 THEN 'PASS' ELSE 'FAIL: expected betrag 10 in "2024_jan", got ' || betrag::VARCHAR END as test_recursive_table_name
+FROM "2024_jan";
+
+SELECT CASE WHEN cnt = 1 THEN 'PASS' ELSE 'FAIL: expected 1 file matching include glob, got ' || cnt::VARCHAR END as test_recursive_include
+FROM (SELECT COUNT(*) as cnt FROM import_folder('test/fixtures/nested_csv', 'csv', recursive := true, include := '2023/*'));
+
+-- ============================================================
+-- Test 14: Incremental folder sync (manifest, unchanged files skipped)
+-- ============================================================
+SELECT '--- Test 14: Incremental folder sync ---' as test;
+
+SELECT * FROM import_folder('test/fixtures/union_csv', 'csv', mode := 'sync');
+
+SELECT CASE WHEN cnt = 2 THEN 'PASS' ELSE 'FAIL: expected 2 manifest rows, got ' || cnt::VARCHAR END as test_sync_manifest
+FROM (SELECT COUNT(*) as cnt FROM gdpdu_import_manifest WHERE folder = 'test/fixtures/union_csv' AND length(content_hash) = 32);
+
+SELECT CASE WHEN cnt = 2 THEN 'PASS' ELSE 'FAIL: expected 2 unchanged files on second sync, got ' || cnt::VARCHAR END as test_sync_unchanged
+FROM (SELECT COUNT(*) as cnt FROM import_folder('test/fixtures/union_csv', 'csv', mode := 'sync') WHERE status = 'Unchanged');
+
+DROP TABLE umsatz_2024_02;
+
+SELECT CASE WHEN status = 'OK' THEN 'PASS' ELSE 'FAIL: expected dropped table to be re-imported, got ' || status END as test_sync_reimport
+FROM import_folder('test/fixtures/union_csv', 'csv', mode := 'sync') WHERE file_name = 'umsatz_2024_02.csv';
+
+-- ============================================================
+-- Test 15: CSV encoding detected from the byte sample
+-- ============================================================
+SELECT '--- Test 15: CSV encoding detection ---' as test;
+
+SELECT CASE WHEN encoding = 'ISO-8859-1' AND status = 'OK' THEN 'PASS' ELSE 'FAIL: expected ISO-8859-1, got ' || COALESCE(encoding, 'NULL') || ' / ' || status END as test_encoding_detected
+FROM import_folder('test/fixtures/latin1_csv', 'csv');
+
+SELECT CASE WHEN ort = 'Köln' THEN 'PASS' ELSE 'FAIL: expected Köln, got ' || ort END as test_encoding_decoded
+FROM kunden WHERE name = 'Müller';
+
+SELECT CASE WHEN cnt = 0 THEN 'PASS' ELSE 'FAIL: expected no manifest rows from a plain import, got ' || cnt::VARCHAR END as test_tables_mode_no_manifest
+FROM (SELECT COUNT(*) as cnt FROM gdpdu_import_manifest WHERE folder = 'test/fixtures/latin1_csv');
+
+SELECT CASE WHEN encoding = 'UTF-8' THEN 'PASS' ELSE 'FAIL: expected UTF-8 for ASCII file, got ' || COALESCE(encoding, 'NULL') END as test_encoding_ascii
+FROM import_folder('test/fixtures/union_csv', 'csv') WHERE file_name = 'umsatz_2024_01.csv';
+
+-- CP850 and Windows-1252 are read from a UTF-8 copy, no encodings extension needed
+SELECT CASE WHEN string_agg(file_name || '=' || encoding, ',' ORDER BY file_name) = 'lieferanten.csv=CP850,preise.csv=Windows-1252'
+            THEN 'PASS' ELSE 'FAIL: expected CP850 and Windows-1252, got ' || string_agg(file_name || '=' || COALESCE(encoding, 'NULL') || ' ' || status, ',') END as test_encoding_codepages
+FROM import_folder('test/fixtures/codepage_csv', 'csv');
+
+SELECT CASE WHEN ort = 'Köln' THEN 'PASS' ELSE 'FAIL: expected Köln from CP850, got ' || ort END as test_encoding_cp850_decoded
+FROM lieferanten WHERE name = 'Müller';
+
+SELECT CASE WHEN preis = '4,50 €' THEN 'PASS' ELSE 'FAIL: expected 4,50 € from Windows-1252, got ' || preis END as test_encoding_1252_decoded
+FROM preise WHERE artikel = 'Käse';
+
+SELECT CASE WHEN status = 'OK' AND encoding = 'CP850' THEN 'PASS' ELSE 'FAIL: expected CP850 union import, got ' || COALESCE(encoding, 'NULL') || ' / ' || status END as test_encoding_union_copy
+FROM import_folder('test/fixtures/codepage_csv', 'csv', mode := 'union', table_name := 'codepage_union', include := 'lieferanten*');
+
+SELECT CASE WHEN string_agg(source_file || ':' || name, ',' ORDER BY name) = 'lieferanten.csv:Bäcker,lieferanten.csv:Müller' THEN 'PASS'
+            ELSE 'FAIL: expected decoded rows named by their own file, got ' || string_agg(source_file || ':' || name, ',') END as test_encoding_union_source
+FROM codepage_union;
+
+-- ============================================================
+-- Test 16: Hot-folder watcher lifecycle
+-- ============================================================
+SELECT '--- Test 16: Hot-folder watcher ---' as test;
+
+-- The watcher syncs its folder on start, so it gets a fixture folder no other test imports
+SELECT CASE WHEN status = 'Watching' AND watch_id IS NOT NULL THEN 'PASS' ELSE 'FAIL: expected watcher to start, got ' || status END as test_watch_start
+FROM watch_folder('test/fixtures/watch_csv', 'csv', stable_seconds := 1);
+
+SELECT CASE WHEN status LIKE 'Folder is already watched%' THEN 'PASS' ELSE 'FAIL: expected duplicate watch to be rejected, got ' || status END as test_watch_duplicate
+FROM watch_folder('test/fixtures/watch_csv', 'csv');
+
+SELECT CASE WHEN cnt = 1 THEN 'PASS' ELSE 'FAIL: expected 1 watcher in status, got ' || cnt::VARCHAR END as test_watch_status
+FROM (SELECT COUNT(*) as cnt FROM gdpdu_watch_status() WHERE folder = 'test/fixtures/watch_csv' AND file_type = 'csv');
+
+SELECT CASE WHEN status = 'Stopped' THEN 'PASS' ELSE 'FAIL: expected watcher to stop, got ' || status END as test_watch_stop
+FROM unwatch_folder('test/fixtures/watch_csv');
+
+SELECT CASE WHEN cnt = 0 THEN 'PASS' ELSE 'FAIL: expected no watchers after unwatch, got ' || cnt::VARCHAR END as test_watch_gone
+FROM (SELECT COUNT(*) as cnt FROM gdpdu_watch_status());
+
+-- ============================================================
+-- Test 17: Exact numeric types for German numbers, with overrides
+-- ============================================================
+SELECT '--- Test 17: Numeric type inference ---' as test;
+
+SELECT CASE WHEN column_types = 'konto BIGINT, betrag DECIMAL(9,2), menge BIGINT, kurs DECIMAL(4,2)' THEN 'PASS' ELSE 'FAIL: unexpected column types ' || COALESCE(column_types, 'NULL') END as test_numeric_types
+FROM import_folder('test/fixtures/german_numbers', 'csv');
+
+SELECT CASE WHEN total = 1134.52 THEN 'PASS' ELSE 'FAIL: expected exact sum 1134.52, got ' || total::VARCHAR END as test_numeric_exact_sum
+FROM (SELECT SUM(betrag) as total FROM buchungen);
+
+SELECT CASE WHEN column_types LIKE '%kurs DOUBLE%' AND column_types LIKE '%betrag DECIMAL(9,2)%' THEN 'PASS' ELSE 'FAIL: expected kurs override to DOUBLE, got ' || COALESCE(column_types, 'NULL') END as test_numeric_override
+FROM import_folder('test/fixtures/german_numbers', 'csv', column_types := 'kurs DOUBLE');
+
+-- Excel columns keep the type read_xlsx sniffed; the casts share the single type rewrite
+SELECT CASE WHEN status = 'OK' AND column_types LIKE 'konto DOUBLE, bezeichnung VARCHAR, soll DOUBLE%' THEN 'PASS' ELSE 'FAIL: expected native xlsx types, got ' || COALESCE(column_types, 'NULL') || ' / ' || status END as test_xlsx_native_types
+FROM import_folder('test/fixtures/saldenliste', 'xlsx');
+
+SELECT CASE WHEN status LIKE 'Types not converted: %' AND column_types LIKE 'konto VARCHAR%' THEN 'PASS' ELSE 'FAIL: expected the failed rewrite in status, got ' || status END as test_types_not_converted
+FROM import_folder('test/fixtures/saldenliste', 'xlsx', column_types := 'soll NO_SUCH_TYPE');
+
+-- ============================================================
+-- Test 18: Native DATEV Buchungsstapel reader
+-- ============================================================
+SELECT '--- Test 18: Buchungsstapel reader ---' as test;
+
+SELECT CASE WHEN status = 'OK' AND row_count = 3 THEN 'PASS' ELSE 'FAIL: expected 3 rows, got ' || row_count::VARCHAR || ' / ' || status END as test_extf_load
+FROM read_buchungsstapel('test/fixtures/buchungsstapel');
+
+SELECT CASE WHEN total = 1499.50 THEN 'PASS' ELSE 'FAIL: expected Umsatz sum 1499.50, got ' || total::VARCHAR END as test_extf_amounts
+FROM (SELECT SUM(umsatz_ohne_soll_haben_kz) as total FROM "EXTF_Buchungsstapel_2024_01");
+
+SELECT CASE WHEN belegdatum = DATE '2024-01-15' AND buchungstext = 'Müller GmbH' THEN 'PASS' ELSE 'FAIL: got ' || belegdatum::VARCHAR || ' / ' || buchungstext END as test_extf_date_text
+FROM "EXTF_Buchungsstapel_2024_01" WHERE belegfeld_1 = 'RE-1001';
+
+SELECT CASE WHEN kurs = 1.085 AND buchungstext = 'Gutschrift "Skonto"' THEN 'PASS' ELSE 'FAIL: unexpected kurs/quoted text' END as test_extf_quotes
+FROM (SELECT MAX(kurs) as kurs, MAX(buchungstext) FILTER (WHERE belegfeld_1 = 'RE-1002') as buchungstext FROM "EXTF_Buchungsstapel_2024_01");
+
+-- ============================================================
+-- Test 19: Belegdatum across a year end (Datum-von/Datum-bis)
+-- ============================================================
+SELECT '--- Test 19: Belegdatum year rollover ---' as test;
+
+SELECT CASE WHEN row_count = 2 AND status LIKE 'OK (1 rows%' THEN 'PASS' ELSE 'FAIL: expected 2 rows and 1 skipped, got ' || row_count::VARCHAR || ' / ' || status END as test_belegdatum_load
+FROM read_buchungsstapel('test/fixtures/buchungsstapel_fy');
+
+SELECT CASE WHEN dez = DATE '2024-12-15' AND jan = DATE '2025-01-10' THEN 'PASS' ELSE 'FAIL: got ' || dez::VARCHAR || ' / ' || jan::VARCHAR END as test_belegdatum_rollover
+FROM (SELECT MAX(belegdatum) FILTER (WHERE belegfeld_1 = 'RE-2001') as dez,
+             MAX(belegdatum) FILTER (WHERE belegfeld_1 = 'RE-2002') as jan
+      FROM "EXTF_Buchungsstapel_2024_12");
+
+-- ============================================================
+-- Test 20: Buchungsstapel journal mode
+-- ============================================================
+SELECT '--- Test 20: Buchungsstapel journal ---' as test;
+
+SELECT CASE WHEN cnt = 2 AND total_rows = 5 THEN 'PASS' ELSE 'FAIL: expected 2 files / 5 rows, got ' || cnt::VARCHAR || ' / ' || total_rows::VARCHAR END as test_journal_load
+FROM (SELECT COUNT(*) as cnt, SUM(row_count) as total_rows
+      FROM read_buchungsstapel('test/fixtures', mode := 'journal', recursive := true, table_name := 'journal_test'));
+
+SELECT CASE WHEN cnt = 5 AND min_ordinal = 1 AND von = DATE '2024-12-01' THEN 'PASS' ELSE 'FAIL: unexpected journal content' END as test_journal_content
+FROM (SELECT COUNT(*) as cnt, MIN(row_ordinal) as min_ordinal,
+             MAX(stapel_datum_von) as von FROM journal_test);
+
+SELECT CASE WHEN cnt = 2 THEN 'PASS' ELSE 'FAIL: expected NULL kurs for the file without that column, got ' || cnt::VARCHAR END as test_journal_missing_column
+FROM (SELECT COUNT(*) as cnt FROM journal_test WHERE file_name LIKE 'buchungsstapel_fy/%' AND kurs IS NULL);
+
+-- ============================================================
+-- Test 21: DATEV EXTF master data formats
+-- ============================================================
+SELECT '--- Test 21: DATEV EXTF formats ---' as test;
+
+SELECT CASE WHEN cnt = 2 AND formats = 'Debitoren/Kreditoren v5,Sachkontenbeschriftungen v3' THEN 'PASS' ELSE 'FAIL: expected 2 typed formats, got ' || cnt::VARCHAR || ' / ' || COALESCE(formats, 'NULL') END as test_extf_formats
+FROM (SELECT COUNT(*) as cnt, string_agg(format, ',' ORDER BY format) as formats
+      FROM read_datev_extf('test/fixtures/datev_stammdaten'));
+
+SELECT CASE WHEN row_count = 3 AND status = 'OK (1 rows with invalid values skipped, 1 invalid values set to NULL)' THEN 'PASS' ELSE 'FAIL: got ' || row_count::VARCHAR || ' / ' || status END as test_extf_invalid_values
+FROM read_datev_extf('test/fixtures/datev_stammdaten') WHERE file_name = 'EXTF_Debitoren_Kreditoren.csv';
+
+SELECT CASE WHEN typeof(konto) = 'INTEGER' AND typeof(kreditlimit_debitor) = 'DECIMAL(18,2)' AND typeof(kennz_hauptbankverb_1) = 'BOOLEAN'
+                 AND typeof(bankverb_1_g_ltig_von) = 'DATE' AND postleitzahl = '01067' AND kreditlimit_debitor = 5000.00
+            THEN 'PASS' ELSE 'FAIL: unexpected Debitoren/Kreditoren types' END as test_extf_master_types
+FROM "EXTF_Debitoren_Kreditoren" WHERE konto = 10000;
+
+SELECT CASE WHEN cnt = 1 THEN 'PASS' ELSE 'FAIL: expected the invalid date as NULL, got ' || cnt::VARCHAR END as test_extf_null_value
+FROM (SELECT COUNT(*) as cnt FROM "EXTF_Debitoren_Kreditoren" WHERE konto = 10001 AND bankverb_1_g_ltig_von IS NULL);
+
+SELECT CASE WHEN kontenbeschriftung = 'Erlöse 19 % USt' AND typeof(konto) = 'INTEGER' THEN 'PASS' ELSE 'FAIL: unexpected Sachkontenbeschriftungen' END as test_extf_sachkonten
+FROM "EXTF_Sachkontenbeschriftungen" WHERE konto = 8400;
+
+SELECT CASE WHEN row_count = 0 AND status = 'Load failed: unterminated quote starting at record 4 (line 4)' THEN 'PASS' ELSE 'FAIL: got ' || row_count::VARCHAR || ' / ' || status END as test_extf_unterminated_quote
+FROM read_datev_extf('test/fixtures/extf_unterminated');
+
+SELECT CASE WHEN cnt = 0 THEN 'PASS' ELSE 'FAIL: expected no table for the failed file, got ' || cnt::VARCHAR END as test_extf_unterminated_no_table
+FROM (SELECT COUNT(*) as cnt FROM duckdb_tables() WHERE table_name = 'EXTF_Stapel_unterminated');
+
+-- ============================================================
+-- Test 22: EXTF header metadata table
+-- ============================================================
+SELECT '--- Test 22: buchungsstapel_header ---' as test;
+
+SELECT CASE WHEN mandant = '2002' AND berater = '1001' AND format_version = 13 AND sachkontenlaenge = 4
+                 AND datum_von = DATE '2024-01-01' AND datum_bis = DATE '2024-01-31' AND NOT festschreibung
+                 AND wkz = 'EUR' AND erzeugt_am = TIMESTAMP '2024-02-05 10:15:00' AND table_name = 'EXTF_Buchungsstapel_2024_01'
+            THEN 'PASS' ELSE 'FAIL: unexpected header metadata' END as test_header_fields
+FROM buchungsstapel_header
+WHERE folder = 'test/fixtures/buchungsstapel' AND file_name = 'EXTF_Buchungsstapel_2024_01.csv';
+
+SELECT CASE WHEN cnt = 2 THEN 'PASS' ELSE 'FAIL: expected 2 journal header rows, got ' || cnt::VARCHAR END as test_header_journal
+FROM (SELECT COUNT(*) as cnt FROM buchungsstapel_header WHERE folder = 'test/fixtures' AND table_name = 'journal_test');
+
+-- ============================================================
+-- Test 23: Saldenliste from a Buchungsstapel
+-- ============================================================
+SELECT '--- Test 23: gdpdu_saldenliste ---' as test;
+
+SELECT CASE WHEN cnt = 4 AND total = 0 AND bank = 1130.50 AND erloese_haben = 1190.00 THEN 'PASS' ELSE 'FAIL: unexpected January Saldenliste' END as test_saldenliste_month
+FROM (SELECT COUNT(*) as cnt, SUM(endsaldo) as total,
+             MAX(endsaldo) FILTER (WHERE konto = '1200') as bank,
+             MAX(haben) FILTER (WHERE konto = '8400') as erloese_haben
+      FROM gdpdu_saldenliste('EXTF_Buchungsstapel_2024_01', DATE '2024-01-01', DATE '2024-01-31'));
+
+SELECT CASE WHEN anfangssaldo = 1130.50 AND soll = 0 AND haben = 0 AND endsaldo = 1130.50 THEN 'PASS' ELSE 'FAIL: expected January as opening balance of February' END as test_saldenliste_opening
+FROM gdpdu_saldenliste('EXTF_Buchungsstapel_2024_01', DATE '2024-02-01', DATE '2024-02-29') WHERE konto = '1200';
+
+SELECT CASE WHEN cnt = 4 THEN 'PASS' ELSE 'FAIL: expected 4 cached monthly sums, got ' || cnt::VARCHAR END as test_saldenliste_cache
+FROM (SELECT COUNT(*) as cnt FROM gdpdu_saldenliste_cache WHERE source_table = 'EXTF_Buchungsstapel_2024_01');
+
+-- A ledger re-imported with other amounts (same row count) must not mix with cached months
+SELECT * FROM import_folder('test/fixtures/saldenliste_ledger/v1', 'csv');
+SELECT CASE WHEN anfangssaldo = 100.00 THEN 'PASS' ELSE 'FAIL: expected January of the first import, got ' || anfangssaldo::VARCHAR END as test_saldenliste_first_import
+FROM gdpdu_saldenliste('sachposten', DATE '2024-02-01', DATE '2024-02-29') WHERE konto = '1200';
+SELECT * FROM import_folder('test/fixtures/saldenliste_ledger/v2', 'csv');
+
+SELECT CASE WHEN anfangssaldo = 200.00 THEN 'PASS' ELSE 'FAIL: expected the re-imported January, got ' || anfangssaldo::VARCHAR END as test_saldenliste_reimport
+FROM gdpdu_saldenliste('sachposten', DATE '2024-02-01', DATE '2024-02-29') WHERE konto = '1200';
+
+SELECT CASE WHEN generation = 2 THEN 'PASS' ELSE 'FAIL: expected generation 2 after two imports, got ' || generation::VARCHAR END as test_saldenliste_generation
+FROM gdpdu_table_versions WHERE table_name = 'sachposten';
+
+-- ============================================================
+-- Test 24: Reconcile a Saldenliste workbook
+-- ============================================================
+SELECT '--- Test 24: gdpdu_reconcile_saldenliste ---' as test;
+
+-- 4930 has Haben 200 in the workbook but 250 in the ledger; 9000 has no bookings;
+-- 0800 without bookings only carries its EB-Wert and matches
+SELECT CASE WHEN cnt = 2 AND buero_delta = 50.00 AND buero_saldo = -50.00 AND vortrag = 'missing in ledger'
+            THEN 'PASS' ELSE 'FAIL: unexpected reconciliation differences' END as test_reconcile_differences
+FROM (SELECT COUNT(*) as cnt,
+             MAX(delta_haben) FILTER (WHERE konto = '4930') as buero_delta,
+             MAX(delta_saldo) FILTER (WHERE konto = '4930') as buero_saldo,
+             MAX(status) FILTER (WHERE konto = '9000') as vortrag
+      FROM gdpdu_reconcile_saldenliste('EXTF_Buchungsstapel_2024_01', 'test/fixtures/saldenliste/saldenliste_2024_01.xlsx'));
+
+SELECT CASE WHEN cnt = 0 THEN 'PASS' ELSE 'FAIL: expected no differences within tolerance, got ' || cnt::VARCHAR END as test_reconcile_tolerance
+FROM (SELECT COUNT(*) as cnt
+      FROM gdpdu_reconcile_saldenliste('EXTF_Buchungsstapel_2024_01', 'test/fixtures/saldenliste/saldenliste_2024_01.xlsx',
+                                       tolerance := 50));
+
+-- ============================================================
+-- Test 25: zip:// source URIs
+-- ============================================================
+SELECT '--- Test 25: zip:// source ---' as test;
+
+DROP TABLE IF EXISTS "Kunden";
+SELECT * FROM import_gdpdu_navision('zip://test/fixtures/zip_source/export_2024.zip!/Export 2024');
+
+SELECT CASE WHEN cnt = 3 THEN 'PASS' ELSE 'FAIL: expected 3 rows from the zip, got ' || cnt::VARCHAR END as test_zip_source_rows
+FROM (SELECT COUNT(*) as cnt FROM "Kunden");
+
+SELECT CASE WHEN table_name = '(source)' AND status LIKE 'Failed to open%not found%' THEN 'PASS' ELSE 'FAIL: expected source error, got ' || status END as test_zip_source_missing
+FROM import_gdpdu_navision('zip://test/fixtures/zip_source/missing.zip');
+
+-- Every mount extracts into a new folder; the manifest is keyed by the URI, so a second sync of
+-- the same archive finds nothing changed
+SELECT * FROM import_folder('zip://test/fixtures/zip_source/export_2024.zip!/Export 2024', 'txt', mode := 'sync');
+
+SELECT CASE WHEN cnt = 2 THEN 'PASS' ELSE 'FAIL: expected 2 unchanged files on the second zip sync, got ' || cnt::VARCHAR END as test_zip_source_sync_unchanged
+FROM (SELECT COUNT(*) as cnt FROM import_folder('zip://test/fixtures/zip_source/export_2024.zip!/Export 2024', 'txt', mode := 'sync') WHERE status = 'Unchanged');
+
+SELECT CASE WHEN cnt = 2 THEN 'PASS' ELSE 'FAIL: expected 2 manifest rows keyed by the zip URI, got ' || cnt::VARCHAR END as test_zip_source_manifest_uri
+FROM (SELECT COUNT(*) as cnt FROM gdpdu_import_manifest WHERE folder = 'zip://test/fixtures/zip_source/export_2024.zip!/Export 2024');
+
+-- Headers of a zip source are recorded under its URI, so reading it again replaces them
+SELECT * FROM read_buchungsstapel('zip://test/fixtures/zip_source/buchungsstapel_2024.zip');
+SELECT * FROM read_buchungsstapel('zip://test/fixtures/zip_source/buchungsstapel_2024.zip');
+
+SELECT CASE WHEN cnt = 1 AND uri_rows = 1 THEN 'PASS' ELSE 'FAIL: expected 1 header row keyed by the zip URI, got ' || cnt::VARCHAR || ' / ' || uri_rows::VARCHAR END as test_zip_source_header_rows
+FROM (SELECT COUNT(*) as cnt, COUNT(*) FILTER (WHERE folder = 'zip://test/fixtures/zip_source/buchungsstapel_2024.zip') as uri_rows
+      FROM buchungsstapel_header WHERE file_name = 'EXTF_Buchungsstapel_2024_01.csv' AND folder NOT LIKE 'test/fixtures%');
+
 -- ============================================================
 -- Summary
 -- ============================================================
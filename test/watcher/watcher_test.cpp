@@ -0,0 +1,171 @@
+// Hot-folder watcher test against a real temporary folder: a file is imported only once it
+// stopped changing, a malformed file is counted as failed
+// Run: build/test/watcher/gdpdu_watcher_test (exit code 1 if a check fails)
+
+#include "duckdb.hpp"
+#include "folder_watcher.hpp"
+#include "directory_walker.hpp"
+#include "webdav_client.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <thread>
+
+using namespace duckdb;
+
+static int failures = 0;
+
+static void check(bool ok, const std::string& name, const std::string& detail = "") {
+    if (ok) {
+        printf("PASS %s\n", name.c_str());
+    } else {
+        printf("FAIL %s%s%s\n", name.c_str(), detail.empty() ? "" : ": ", detail.c_str());
+        failures++;
+    }
+}
+
+static void append_line(const std::string& path, const std::string& line) {
+    std::ofstream out(path, std::ios::binary | std::ios::app);
+    out << line << "\n";
+}
+
+static bool table_exists(Connection& conn, const std::string& table) {
+    auto result = conn.Query("SELECT COUNT(*) FROM duckdb_tables() WHERE table_name = '" + table + "'");
+    return !result->HasError() && result->GetValue(0, 0).GetValue<int64_t>() > 0;
+}
+
+static int64_t count_rows(Connection& conn, const std::string& table) {
+    auto result = conn.Query("SELECT COUNT(*) FROM \"" + table + "\"");
+    return result->HasError() ? -1 : result->GetValue(0, 0).GetValue<int64_t>();
+}
+
+static FolderWatchStatus watch_status(DatabaseInstance& db) {
+    std::vector<FolderWatchStatus> all = get_folder_watch_status(db);
+    return all.empty() ? FolderWatchStatus() : all[0];
+}
+
+static void sleep_ms(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+// Threads of this process (Linux: one entry per thread in /proc/self/task)
+static size_t thread_count() {
+    return list_subdirectories("/proc/self/task", std::vector<std::string>()).size();
+}
+
+static const int STABLE_SECONDS = 2;
+
+int main() {
+    DuckDB db(nullptr);
+    Connection conn(db);
+    std::string folder = create_temp_download_dir();
+    int64_t started = static_cast<int64_t>(time(nullptr));
+
+    FolderWatchConfig config;
+    config.folder = folder;
+    config.file_type = "csv";
+    // Files without a betrag column fail to load (binder error, not skipped by ignore_errors)
+    config.options = "types={'betrag': 'VARCHAR'}";
+    config.stable_seconds = STABLE_SECONDS;
+    config.poll_seconds = 3600;  // imports come from inotify events only, not from a full sync
+
+    std::string error;
+    int64_t watch_id = start_folder_watch(db.instance, config, error);
+    check(watch_id > 0, "watcher starts", error);
+    if (watch_id <= 0) {
+        cleanup_temp_dir(folder);
+        return 1;
+    }
+
+    // ============================================================
+    printf("--- Test 1: A file that keeps changing is not imported ---\n");
+    const std::string path = folder + "/zahlungen.csv";
+    append_line(path, "konto,betrag");
+    int rows = 0;
+    bool imported_early = false;
+    int64_t max_queue = 0;
+    // Write for twice as long as the file has to be stable, well past the first settle deadline
+    auto writing_until = std::chrono::steady_clock::now() + std::chrono::seconds(2 * STABLE_SECONDS + 1);
+    while (std::chrono::steady_clock::now() < writing_until) {
+        append_line(path, std::to_string(4000 + rows) + "," + std::to_string(10 * (rows + 1)));
+        rows++;
+        sleep_ms(300);
+        FolderWatchStatus status = watch_status(*db.instance);
+        imported_early = imported_early || status.imported_files > 0 || table_exists(conn, "zahlungen");
+        max_queue = std::max(max_queue, status.queue_length);
+    }
+    auto last_write = std::chrono::steady_clock::now();
+    check(!imported_early, "not imported while it was written");
+    check(max_queue == 1, "queue_length counts the waiting file", std::to_string(max_queue));
+
+    // ============================================================
+    printf("--- Test 2: The file is imported once it settled ---\n");
+    std::this_thread::sleep_until(last_write + std::chrono::milliseconds(STABLE_SECONDS * 1000 - 500));
+    FolderWatchStatus status = watch_status(*db.instance);
+    check(status.imported_files == 0 && !table_exists(conn, "zahlungen"), "not imported before stable_seconds passed");
+    for (int i = 0; i < 100 && status.imported_files == 0; ++i) {
+        sleep_ms(100);
+        status = watch_status(*db.instance);
+    }
+    check(status.imported_files == 1, "imported after it settled", std::to_string(status.imported_files));
+    check(count_rows(conn, "zahlungen") == rows, "every written row imported",
+          std::to_string(count_rows(conn, "zahlungen")) + " of " + std::to_string(rows));
+    check(status.queue_length == 0, "queue empty after the import", std::to_string(status.queue_length));
+    check(status.last_import >= started, "last_import reported", std::to_string(status.last_import));
+    check(status.last_file == "zahlungen.csv" && status.last_status == "OK", "last file and status",
+          status.last_file + " / " + status.last_status);
+    check(status.failed_files == 0 && status.last_error.empty(), "no failures yet", status.last_error);
+
+    // ============================================================
+    printf("--- Test 3: A malformed file is counted as failed ---\n");
+    // A zip renamed to .csv: no betrag column
+    append_line(folder + "/kaputt.csv", std::string("PK\x03\x04\x14\x00", 6) + "not a csv export");
+    for (int i = 0; i < 100 && status.failed_files == 0; ++i) {
+        sleep_ms(100);
+        status = watch_status(*db.instance);
+    }
+    check(status.failed_files == 1, "failed_files counts the malformed file", std::to_string(status.failed_files));
+    check(status.last_error.compare(0, 25, "kaputt.csv: Load failed: ") == 0, "last_error names file and reason",
+          status.last_error);
+    check(status.imported_files == 1, "imported_files unchanged", std::to_string(status.imported_files));
+    check(!table_exists(conn, "kaputt"), "no table for the malformed file");
+    check(status.active && status.queue_length == 0, "watcher keeps running with an empty queue");
+
+    // ============================================================
+    printf("--- Test 4: Closing the database ends its watcher ---\n");
+    {
+        std::string other_folder = create_temp_download_dir();
+        size_t threads_before = thread_count();
+        {
+            DuckDB other(nullptr);
+            size_t threads_open = thread_count();  // with the database's own worker threads
+            FolderWatchConfig other_config;
+            other_config.folder = other_folder;
+            other_config.poll_seconds = 3600;
+            check(start_folder_watch(other.instance, other_config, error) > 0, "second watcher starts", error);
+            check(thread_count() == threads_open + 1, "watcher thread running");
+        }
+        size_t threads_after = thread_count();
+        for (int i = 0; i < 30 && threads_after > threads_before; ++i) {
+            sleep_ms(100);
+            threads_after = thread_count();
+        }
+        check(threads_after == threads_before, "thread ends within seconds of the close, not at the next sync",
+              std::to_string(threads_after) + " threads, " + std::to_string(threads_before) + " before");
+        // Forgets (and joins) the watcher of the closed database
+        check(get_folder_watch_status(*db.instance).size() == 1, "only the open database's watcher listed");
+        cleanup_temp_dir(other_folder);
+    }
+
+    std::vector<int64_t> stopped = stop_folder_watch(*db.instance, folder);
+    check(stopped.size() == 1 && stopped[0] == watch_id, "watcher stops");
+    check(get_folder_watch_status(*db.instance).empty(), "no watcher left after stop");
+
+    cleanup_temp_dir(folder);
+    printf("%s: %d check(s) failed\n", failures == 0 ? "PASS" : "FAIL", failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,640 @@
+#include "mock_webdav_server.hpp"
+
+#include "miniz.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace duckdb {
+
+// One parsed HTTP request
+struct MockWebDavServer::Request {
+    std::string method;
+    std::string target;                          // request path as sent (percent-encoded)
+    std::map<std::string, std::string> headers;  // lower-case names
+    std::string body;
+    bool keep_alive;
+
+    std::string header(const std::string& name) const {
+        auto it = headers.find(name);
+        return it == headers.end() ? "" : it->second;
+    }
+};
+
+static int64_t steady_micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::string base64_encode(const std::string& input) {
+    static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    int val = 0, bits = -6;
+    for (unsigned char c : input) {
+        val = (val << 8) + c;
+        bits += 8;
+        while (bits >= 0) {
+            out.push_back(chars[(val >> bits) & 0x3F]);
+            bits -= 6;
+        }
+    }
+    if (bits > -6) {
+        out.push_back(chars[((val << 8) >> (bits + 8)) & 0x3F]);
+    }
+    while (out.size() % 4) {
+        out.push_back('=');
+    }
+    return out;
+}
+
+static std::string url_decode(const std::string& encoded) {
+    std::string out;
+    for (size_t i = 0; i < encoded.size(); ++i) {
+        if (encoded[i] == '%' && i + 2 < encoded.size() &&
+            std::isxdigit(static_cast<unsigned char>(encoded[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(encoded[i + 2]))) {
+            out += static_cast<char>(std::strtol(encoded.substr(i + 1, 2).c_str(), nullptr, 16));
+            i += 2;
+        } else {
+            out += encoded[i];
+        }
+    }
+    return out;
+}
+
+// Percent-encode a path for an href, keeping '/'
+static std::string url_encode_path(const std::string& path) {
+    static const char hex[] = "0123456789ABCDEF";
+    std::string out;
+    for (unsigned char c : path) {
+        if (std::isalnum(c) || c == '/' || c == '-' || c == '_' || c == '.' || c == '~') {
+            out += static_cast<char>(c);
+        } else {
+            out += '%';
+            out += hex[c >> 4];
+            out += hex[c & 15];
+        }
+    }
+    return out;
+}
+
+static std::string xml_escape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        switch (c) {
+        case '&': out += "&amp;"; break;
+        case '<': out += "&lt;"; break;
+        case '>': out += "&gt;"; break;
+        case '"': out += "&quot;"; break;
+        default: out += c;
+        }
+    }
+    return out;
+}
+
+// RFC 1123 date, e.g. "Tue, 15 Oct 2024 10:15:00 GMT"
+static std::string http_date(int64_t epoch_seconds) {
+    time_t t = static_cast<time_t>(epoch_seconds);
+    struct tm tm_utc;
+    gmtime_r(&t, &tm_utc);
+    char buffer[64];
+    strftime(buffer, sizeof(buffer), "%a, %d %b %Y %H:%M:%S GMT", &tm_utc);
+    return buffer;
+}
+
+// Content-Type by file extension
+static const char* content_type(const std::string& path) {
+    static const char* const types[][2] = {
+        {".zip", "application/zip"}, {".xml", "application/xml"}, {".csv", "text/csv"},
+        {".txt", "text/plain"}, {".xlsx", "application/vnd.openxmlformats-officedocument.spreadsheetml.sheet"}};
+    for (const auto& type : types) {
+        size_t length = strlen(type[0]);
+        if (path.size() >= length && path.compare(path.size() - length, length, type[0]) == 0) {
+            return type[1];
+        }
+    }
+    return "application/octet-stream";
+}
+
+// True if an Accept-Encoding header lists coding (q=0 is taken as listed too; clients here don't send it)
+static bool accepts_encoding(const std::string& accept_encoding, const std::string& coding) {
+    std::istringstream tokens(accept_encoding);
+    std::string token;
+    while (std::getline(tokens, token, ',')) {
+        size_t start = token.find_first_not_of(' ');
+        size_t end = token.find_first_of(" ;", start);
+        if (start != std::string::npos && token.substr(start, end - start) == coding) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Compress data with miniz: a gzip member (RFC 1952) or a zlib stream (RFC 1950, "deflate")
+static std::string compress(const std::string& data, bool gzip) {
+    duckdb_miniz::mz_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    int window_bits = gzip ? -MZ_DEFAULT_WINDOW_BITS : MZ_DEFAULT_WINDOW_BITS;
+    if (duckdb_miniz::mz_deflateInit2(&stream, duckdb_miniz::MZ_DEFAULT_LEVEL, duckdb_miniz::MZ_DEFLATED, window_bits,
+                                      9, duckdb_miniz::MZ_DEFAULT_STRATEGY) != duckdb_miniz::MZ_OK) {
+        throw std::runtime_error("mock WebDAV server: deflateInit failed");
+    }
+    std::string out;
+    if (gzip) {
+        static const char header[10] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 0, '\xff'};
+        out.assign(header, sizeof(header));
+    }
+    size_t start = out.size();
+    out.resize(start + duckdb_miniz::mz_deflateBound(&stream, static_cast<duckdb_miniz::mz_ulong>(data.size())));
+    stream.next_in = reinterpret_cast<const unsigned char*>(data.data());
+    stream.avail_in = static_cast<unsigned int>(data.size());
+    stream.next_out = reinterpret_cast<unsigned char*>(&out[start]);
+    stream.avail_out = static_cast<unsigned int>(out.size() - start);
+    int status = duckdb_miniz::mz_deflate(&stream, duckdb_miniz::MZ_FINISH);
+    out.resize(start + stream.total_out);
+    duckdb_miniz::mz_deflateEnd(&stream);
+    if (status != duckdb_miniz::MZ_STREAM_END) {
+        throw std::runtime_error("mock WebDAV server: deflate failed");
+    }
+    if (gzip) {
+        uint32_t crc = static_cast<uint32_t>(duckdb_miniz::mz_crc32(
+            MZ_CRC32_INIT, reinterpret_cast<const unsigned char*>(data.data()), data.size()));
+        uint32_t size = static_cast<uint32_t>(data.size());
+        for (uint32_t value : {crc, size}) {
+            for (int i = 0; i < 4; ++i) {
+                out += static_cast<char>((value >> (8 * i)) & 0xFF);
+            }
+        }
+    }
+    return out;
+}
+
+static const char* status_text(int status) {
+    switch (status) {
+    case 200: return "OK";
+    case 206: return "Partial Content";
+    case 207: return "Multi-Status";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 416: return "Range Not Satisfiable";
+    default: return "Error";
+    }
+}
+
+MockWebDavServer::MockWebDavServer(const std::string& username, const std::string& password)
+    : username_(username), password_(password), root_("/remote.php/dav/files/" + username + "/"),
+      port_(0), listen_fd_(-1), latency_ms_(0), bandwidth_(0),
+      depth_infinity_(static_cast<int>(MockDepthInfinity::ALLOW)),
+      content_encoding_(static_cast<int>(MockContentEncoding::NONE)), drop_after_(-1), link_busy_until_(0),
+      connections_(0), propfind_requests_(0), get_requests_(0), range_requests_(0), body_bytes_(0),
+      compressed_responses_(0), running_(false) {}
+
+MockWebDavServer::~MockWebDavServer() {
+    stop();
+}
+
+int MockWebDavServer::start() {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error("mock WebDAV server: socket() failed");
+    }
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        listen(listen_fd_, 64) != 0 ||
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len) != 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error("mock WebDAV server: cannot listen on 127.0.0.1");
+    }
+    port_ = ntohs(addr.sin_port);
+
+    running_ = true;
+    accept_thread_ = std::thread(&MockWebDavServer::accept_loop, this);
+    return port_;
+}
+
+void MockWebDavServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    // Wake up accept() and every connection blocked in recv()
+    shutdown(listen_fd_, SHUT_RDWR);
+    close(listen_fd_);
+    accept_thread_.join();
+    {
+        std::lock_guard<std::mutex> guard(connections_lock_);
+        for (int fd : connection_fds_) {
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+    for (auto& thread : connection_threads_) {
+        thread.join();
+    }
+    connection_threads_.clear();
+    connection_fds_.clear();
+    listen_fd_ = -1;
+}
+
+std::string MockWebDavServer::url(const std::string& folder) const {
+    std::string path = root_ + url_encode_path(folder);
+    if (path.back() != '/') {
+        path += '/';
+    }
+    return "http://127.0.0.1:" + std::to_string(port_) + path;
+}
+
+void MockWebDavServer::put_file(const std::string& path, const std::string& content, int64_t modified_time) {
+    // ETag: FNV-1a of content and modification time, quoted as servers send it
+    uint64_t hash = 14695981039346656037ULL;
+    std::string identity = content + "|" + std::to_string(modified_time);
+    for (char c : identity) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    char etag[32];
+    snprintf(etag, sizeof(etag), "\"%016llx\"", static_cast<unsigned long long>(hash));
+
+    File file;
+    file.content = content;
+    file.modified_time = modified_time;
+    file.etag = etag;
+    std::lock_guard<std::mutex> guard(files_lock_);
+    files_[path] = file;
+}
+
+void MockWebDavServer::remove_file(const std::string& path) {
+    std::lock_guard<std::mutex> guard(files_lock_);
+    files_.erase(path);
+}
+
+MockWebDavStats MockWebDavServer::stats() const {
+    MockWebDavStats s;
+    s.connections = connections_;
+    s.propfind_requests = propfind_requests_;
+    s.get_requests = get_requests_;
+    s.range_requests = range_requests_;
+    s.body_bytes = body_bytes_;
+    s.compressed_responses = compressed_responses_;
+    return s;
+}
+
+void MockWebDavServer::reset_stats() {
+    connections_ = 0;
+    propfind_requests_ = 0;
+    get_requests_ = 0;
+    range_requests_ = 0;
+    body_bytes_ = 0;
+    compressed_responses_ = 0;
+}
+
+void MockWebDavServer::accept_loop() {
+    while (running_) {
+        int fd = accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        connections_++;
+        std::lock_guard<std::mutex> guard(connections_lock_);
+        if (!running_) {
+            close(fd);
+            break;
+        }
+        connection_fds_.push_back(fd);
+        connection_threads_.push_back(std::thread(&MockWebDavServer::serve_connection, this, fd));
+    }
+}
+
+// Serve one connection until the client closes it
+void MockWebDavServer::serve_connection(int fd) {
+    serve_requests(fd);
+    // Forget the descriptor before closing it, so stop() never shuts down a reused number
+    std::lock_guard<std::mutex> guard(connections_lock_);
+    connection_fds_.erase(std::remove(connection_fds_.begin(), connection_fds_.end(), fd), connection_fds_.end());
+    shutdown(fd, SHUT_RDWR);
+    close(fd);
+}
+
+// Read requests off a keep-alive connection and answer them until either side closes it
+void MockWebDavServer::serve_requests(int fd) {
+    std::string buffer;
+    char chunk[16384];
+    while (running_) {
+        // Request line and headers
+        size_t header_end;
+        while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+
+        Request req;
+        std::istringstream head(buffer.substr(0, header_end));
+        std::string line, version;
+        std::getline(head, line);
+        std::istringstream request_line(line);
+        request_line >> req.method >> req.target >> version;
+        while (std::getline(head, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+            std::string name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            size_t value_start = line.find_first_not_of(' ', colon + 1);
+            req.headers[name] = value_start == std::string::npos ? "" : line.substr(value_start);
+        }
+        buffer.erase(0, header_end + 4);
+
+        // Body (Content-Length only; clients here don't send chunked bodies)
+        size_t body_length = static_cast<size_t>(std::strtoull(req.header("content-length").c_str(), nullptr, 10));
+        while (buffer.size() < body_length) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        req.body = buffer.substr(0, body_length);
+        buffer.erase(0, body_length);
+
+        std::string connection = req.header("connection");
+        std::transform(connection.begin(), connection.end(), connection.begin(), ::tolower);
+        req.keep_alive = version == "HTTP/1.1" ? connection != "close" : connection == "keep-alive";
+
+        if (!handle_request(fd, req) || !req.keep_alive) {
+            return;
+        }
+    }
+}
+
+// Dispatch one request; false if the connection must be closed
+bool MockWebDavServer::handle_request(int fd, const Request& req) {
+    int latency = latency_ms_;
+    if (latency > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(latency));
+    }
+
+    if (req.header("authorization") != "Basic " + base64_encode(username_ + ":" + password_)) {
+        return send_response(fd, 401, {{"WWW-Authenticate", "Basic realm=\"mock\""}}, "", 0, 0, -1);
+    }
+
+    std::string path = url_decode(req.target);
+    size_t query = path.find('?');
+    if (query != std::string::npos) {
+        path = path.substr(0, query);
+    }
+    std::string root_no_slash = root_.substr(0, root_.size() - 1);
+    if (path != root_no_slash && path.compare(0, root_.size(), root_) != 0) {
+        return send_response(fd, 404, {}, "", 0, 0, -1);
+    }
+    path = path.size() > root_.size() ? path.substr(root_.size()) : "";
+
+    if (req.method == "PROPFIND") {
+        propfind_requests_++;
+        return handle_propfind(fd, req, path);
+    }
+    if (req.method == "GET") {
+        get_requests_++;
+        return handle_get(fd, req, path);
+    }
+    return send_response(fd, 405, {{"Allow", "PROPFIND, GET"}}, "", 0, 0, -1);
+}
+
+bool MockWebDavServer::handle_propfind(int fd, const Request& req, const std::string& path) {
+    std::string folder = path;
+    while (!folder.empty() && folder.back() == '/') {
+        folder.pop_back();
+    }
+    std::string prefix = folder.empty() ? "" : folder + "/";
+
+    std::string depth = req.header("depth");
+    bool infinity = depth.empty() || depth == "infinity";
+    if (infinity && depth_infinity_ == static_cast<int>(MockDepthInfinity::REFUSE)) {
+        return send_response(fd, 403, {{"Content-Type", "application/xml; charset=utf-8"}},
+                             "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+                             "<d:error xmlns:d=\"DAV:\"><d:propfind-finite-depth/></d:error>", 0, -1, -1);
+    }
+    if (infinity && depth_infinity_ == static_cast<int>(MockDepthInfinity::DEPTH_ONE)) {
+        depth = "1";
+        infinity = false;
+    }
+
+    // Snapshot of the matching entries: files and the folders implied by their paths
+    std::vector<std::pair<std::string, File>> found_files;
+    std::set<std::string> found_folders;
+    bool exists = folder.empty();
+    {
+        std::lock_guard<std::mutex> guard(files_lock_);
+        auto file = files_.find(folder);
+        if (!folder.empty() && file != files_.end()) {
+            // PROPFIND on a file: just the file
+            found_files.push_back(*file);
+            exists = true;
+            depth = "0";
+        }
+        for (auto it = files_.lower_bound(prefix); it != files_.end() &&
+                                                   it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+            exists = true;
+            if (depth == "0") {
+                break;
+            }
+            std::string rest = it->first.substr(prefix.size());
+            size_t slash = rest.find('/');
+            if (slash == std::string::npos) {
+                found_files.push_back(*it);
+                continue;
+            }
+            // Folders on the way to the file, down to the requested depth
+            for (size_t pos = slash; pos != std::string::npos; pos = rest.find('/', pos + 1)) {
+                found_folders.insert(prefix + rest.substr(0, pos));
+                if (!infinity) {
+                    break;
+                }
+            }
+            if (infinity) {
+                found_files.push_back(*it);
+            }
+        }
+    }
+    if (!exists) {
+        return send_response(fd, 404, {}, "", 0, 0, -1);
+    }
+
+    std::ostringstream xml;
+    xml << "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        << "<d:multistatus xmlns:d=\"DAV:\" xmlns:oc=\"http://owncloud.org/ns\">\n";
+    auto folder_entry = [&](const std::string& folder_path) {
+        xml << "<d:response><d:href>" << xml_escape(url_encode_path(root_ + (folder_path.empty() ? "" : folder_path + "/")))
+            << "</d:href><d:propstat><d:prop><d:resourcetype><d:collection/></d:resourcetype>"
+            << "</d:prop><d:status>HTTP/1.1 200 OK</d:status></d:propstat>"
+            << "<d:propstat><d:prop><d:getcontentlength/></d:prop>"
+            << "<d:status>HTTP/1.1 404 Not Found</d:status></d:propstat></d:response>\n";
+    };
+    if (found_files.size() != 1 || found_files[0].first != folder) {
+        folder_entry(folder);
+    }
+    for (const auto& sub : found_folders) {
+        folder_entry(sub);
+    }
+    for (const auto& entry : found_files) {
+        xml << "<d:response><d:href>" << xml_escape(url_encode_path(root_ + entry.first)) << "</d:href>"
+            << "<d:propstat><d:prop><d:resourcetype/>"
+            << "<d:getetag>" << xml_escape(entry.second.etag) << "</d:getetag>"
+            << "<d:getcontentlength>" << entry.second.content.size() << "</d:getcontentlength>"
+            << "<d:getlastmodified>" << http_date(entry.second.modified_time) << "</d:getlastmodified>"
+            << "</d:prop><d:status>HTTP/1.1 200 OK</d:status></d:propstat></d:response>\n";
+    }
+    xml << "</d:multistatus>\n";
+    std::string body = xml.str();
+    std::vector<std::pair<std::string, std::string>> headers = {{"Content-Type", "application/xml; charset=utf-8"}};
+    encode_body(req, body, headers);
+    return send_response(fd, 207, headers, body, 0, -1, -1);
+}
+
+bool MockWebDavServer::handle_get(int fd, const Request& req, const std::string& path) {
+    File file;
+    {
+        std::lock_guard<std::mutex> guard(files_lock_);
+        auto it = files_.find(path);
+        if (it == files_.end()) {
+            return send_response(fd, 404, {}, "", 0, 0, -1);
+        }
+        file = it->second;
+    }
+    int64_t size = static_cast<int64_t>(file.content.size());
+    std::vector<std::pair<std::string, std::string>> headers = {
+        {"Content-Type", content_type(path)},
+        {"ETag", file.etag},
+        {"Last-Modified", http_date(file.modified_time)},
+        {"Accept-Ranges", "bytes"}
+    };
+    int64_t drop_after = drop_after_.exchange(-1);
+
+    // Range "bytes=N-" or "bytes=N-M", honoured only while If-Range (if sent) matches
+    std::string range = req.header("range");
+    std::string if_range = req.header("if-range");
+    if (range.compare(0, 6, "bytes=") == 0 && (if_range.empty() || if_range == file.etag)) {
+        size_t dash = range.find('-');
+        int64_t first = std::strtoll(range.substr(6, dash - 6).c_str(), nullptr, 10);
+        int64_t last = dash + 1 < range.size() ? std::strtoll(range.substr(dash + 1).c_str(), nullptr, 10) : size - 1;
+        if (first >= size || last < first) {
+            headers.push_back(std::make_pair("Content-Range", "bytes */" + std::to_string(size)));
+            return send_response(fd, 416, headers, "", 0, 0, -1);
+        }
+        last = std::min(last, size - 1);
+        range_requests_++;
+        headers.push_back(std::make_pair("Content-Range", "bytes " + std::to_string(first) + "-" +
+                                                          std::to_string(last) + "/" + std::to_string(size)));
+        return send_response(fd, 206, headers, file.content, static_cast<size_t>(first), last - first + 1, drop_after);
+    }
+    // Whole files may go compressed, except zips (compressed already); drop_after then counts
+    // compressed bytes
+    if (content_type(path) != std::string("application/zip")) {
+        encode_body(req, file.content, headers);
+    }
+    return send_response(fd, 200, headers, file.content, 0, -1, drop_after);
+}
+
+void MockWebDavServer::encode_body(const Request& req, std::string& body,
+                                   std::vector<std::pair<std::string, std::string>>& headers) {
+    int mode = content_encoding_;
+    const char* coding = mode == static_cast<int>(MockContentEncoding::GZIP)      ? "gzip"
+                         : mode == static_cast<int>(MockContentEncoding::DEFLATE) ? "deflate"
+                                                                                  : nullptr;
+    if (!coding || !accepts_encoding(req.header("accept-encoding"), coding)) {
+        return;
+    }
+    body = compress(body, mode == static_cast<int>(MockContentEncoding::GZIP));
+    headers.push_back(std::make_pair("Content-Encoding", coding));
+    headers.push_back(std::make_pair("Vary", "Accept-Encoding"));
+    compressed_responses_++;
+}
+
+// Send status, headers and body[body_offset, +body_length) (-1 = rest); with drop_after >= 0 the
+// body is cut off after that many bytes and the connection closed. False if the connection is
+// closed afterwards.
+bool MockWebDavServer::send_response(int fd, int status, const std::vector<std::pair<std::string, std::string>>& headers,
+                                     const std::string& body, size_t body_offset, int64_t body_length,
+                                     int64_t drop_after) {
+    size_t length = body_length < 0 ? body.size() - body_offset : static_cast<size_t>(body_length);
+    std::ostringstream head;
+    head << "HTTP/1.1 " << status << " " << status_text(status) << "\r\n";
+    for (const auto& header : headers) {
+        head << header.first << ": " << header.second << "\r\n";
+    }
+    head << "Content-Length: " << length << "\r\n\r\n";
+    std::string head_str = head.str();
+    if (send(fd, head_str.data(), head_str.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(head_str.size())) {
+        return false;
+    }
+
+    bool drop = drop_after >= 0 && static_cast<size_t>(drop_after) < length;
+    size_t to_send = drop ? static_cast<size_t>(drop_after) : length;
+    if (!send_throttled(fd, body.data() + body_offset, to_send)) {
+        return false;
+    }
+    return !drop;
+}
+
+// Send in 16 KB slices; with a bandwidth limit every slice books its transfer time on the shared
+// link and waits for it, so parallel connections split the bandwidth like on a real line
+bool MockWebDavServer::send_throttled(int fd, const char* data, size_t size) {
+    const size_t slice = 16384;
+    for (size_t sent = 0; sent < size;) {
+        size_t n = std::min(slice, size - sent);
+        int64_t bandwidth = bandwidth_;
+        if (bandwidth > 0) {
+            int64_t done_at;
+            {
+                std::lock_guard<std::mutex> guard(link_lock_);
+                link_busy_until_ = std::max(link_busy_until_, steady_micros()) +
+                                   static_cast<int64_t>(n) * 1000000 / bandwidth;
+                done_at = link_busy_until_;
+            }
+            int64_t wait = done_at - steady_micros();
+            if (wait > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(wait));
+            }
+        }
+        ssize_t written = send(fd, data + sent, n, MSG_NOSIGNAL);
+        if (written <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(written);
+        body_bytes_ += written;
+    }
+    return true;
+}
+
+} // namespace duckdb
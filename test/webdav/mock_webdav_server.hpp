@@ -0,0 +1,129 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace duckdb {
+
+// How the mock server answers a PROPFIND with "Depth: infinity"
+enum class MockDepthInfinity {
+    ALLOW,       // list the whole tree
+    REFUSE,      // 403 (RFC 4918 propfind-finite-depth)
+    DEPTH_ONE    // quietly answer with one level, as Nextcloud does by default
+};
+
+// Content-Encoding the mock server compresses responses with, if the request accepts it
+enum class MockContentEncoding {
+    NONE,
+    GZIP,
+    DEFLATE      // zlib-wrapped, as RFC 9110 specifies
+};
+
+// Request counters of a MockWebDavServer
+struct MockWebDavStats {
+    int64_t connections;     // TCP connections accepted
+    int64_t propfind_requests;
+    int64_t get_requests;
+    int64_t range_requests;  // GETs answered with 206
+    int64_t body_bytes;      // response body bytes sent (all requests)
+    int64_t compressed_responses;  // responses sent with a Content-Encoding
+
+    MockWebDavStats()
+        : connections(0), propfind_requests(0), get_requests(0), range_requests(0), body_bytes(0),
+          compressed_responses(0) {}
+};
+
+// In-process WebDAV server on 127.0.0.1 for tests and benchmarks of WebDavClient and
+// import_from_nextcloud without a real Nextcloud. Serves files from memory under
+// /remote.php/dav/files/<username>/ with HTTP Basic Auth and keep-alive connections:
+//   PROPFIND  Depth 0/1/infinity, multistatus with resourcetype, getetag, getcontentlength and
+//             getlastmodified
+//   GET       ETag, Last-Modified, Range ("bytes=N-" / "bytes=N-M") with If-Range, 416
+// With set_content_encoding, multistatus bodies and whole-file GETs of files other than .zip are
+// sent gzip- or deflate-compressed (DuckDB's miniz) when Accept-Encoding allows it.
+// Latency (per request), bandwidth (shared by all connections, like one link) and broken-off
+// downloads can be injected. A small HTTP/1.1 server over plain sockets: the bundled httplib
+// server rejects request methods it doesn't know, PROPFIND among them. POSIX only.
+class MockWebDavServer {
+public:
+    MockWebDavServer(const std::string& username = "test", const std::string& password = "secret");
+    ~MockWebDavServer();
+
+    // Listen on an ephemeral port of 127.0.0.1; returns the port (throws std::runtime_error)
+    int start();
+    void stop();
+
+    // WebDAV URL of a folder below the user's root, e.g. url("exports") ->
+    // "http://127.0.0.1:<port>/remote.php/dav/files/test/exports/"
+    std::string url(const std::string& folder = "") const;
+
+    // Add or replace a file; path is relative to the user's root ("exports/2024/a.zip"), folders
+    // exist implicitly. The ETag changes with content and modification time.
+    void put_file(const std::string& path, const std::string& content, int64_t modified_time);
+    void remove_file(const std::string& path);
+
+    void set_latency_ms(int latency_ms) { latency_ms_ = latency_ms; }
+    void set_bandwidth(int64_t bytes_per_second) { bandwidth_ = bytes_per_second; }  // 0 = unlimited
+    void set_depth_infinity(MockDepthInfinity mode) { depth_infinity_ = static_cast<int>(mode); }
+    void set_content_encoding(MockContentEncoding mode) { content_encoding_ = static_cast<int>(mode); }
+    // The next GET sends only the first bytes of its body, then closes the connection
+    void drop_next_download_after(int64_t bytes) { drop_after_ = bytes; }
+
+    MockWebDavStats stats() const;
+    void reset_stats();
+
+private:
+    struct File {
+        std::string content;
+        int64_t modified_time;
+        std::string etag;
+    };
+    struct Request;
+
+    void accept_loop();
+    void serve_connection(int fd);
+    void serve_requests(int fd);
+    bool handle_request(int fd, const Request& req);
+    bool handle_propfind(int fd, const Request& req, const std::string& path);
+    bool handle_get(int fd, const Request& req, const std::string& path);
+    // Compress body in place if the server is set to and the request accepts it; adds Content-Encoding
+    void encode_body(const Request& req, std::string& body, std::vector<std::pair<std::string, std::string>>& headers);
+    bool send_response(int fd, int status, const std::vector<std::pair<std::string, std::string>>& headers,
+                       const std::string& body, size_t body_offset, int64_t body_length, int64_t drop_after);
+    bool send_throttled(int fd, const char* data, size_t size);
+
+    std::string username_;
+    std::string password_;
+    std::string root_;  // "/remote.php/dav/files/<username>/"
+    int port_;
+    int listen_fd_;
+
+    std::map<std::string, File> files_;  // by path relative to root_
+    mutable std::mutex files_lock_;
+
+    std::atomic<int> latency_ms_;
+    std::atomic<int64_t> bandwidth_;
+    std::atomic<int> depth_infinity_;
+    std::atomic<int> content_encoding_;
+    std::atomic<int64_t> drop_after_;
+
+    // Bandwidth shaping: the time (in steady-clock microseconds) the link is busy until
+    int64_t link_busy_until_;
+    std::mutex link_lock_;
+
+    std::atomic<int64_t> connections_, propfind_requests_, get_requests_, range_requests_, body_bytes_,
+        compressed_responses_;
+
+    std::thread accept_thread_;
+    std::vector<std::thread> connection_threads_;
+    std::vector<int> connection_fds_;
+    std::mutex connections_lock_;
+    std::atomic<bool> running_;
+};
+
+} // namespace duckdb
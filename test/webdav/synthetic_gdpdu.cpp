@@ -0,0 +1,141 @@
+#include "synthetic_gdpdu.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+
+namespace duckdb {
+
+static uint32_t crc32(const std::string& data) {
+    static uint32_t table[256];
+    static bool initialized = false;
+    if (!initialized) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        initialized = true;
+    }
+    uint32_t crc = 0xFFFFFFFFu;
+    for (unsigned char c : data) {
+        crc = table[(crc ^ c) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static void put16(std::string& out, uint32_t value) {
+    out += static_cast<char>(value & 0xFF);
+    out += static_cast<char>((value >> 8) & 0xFF);
+}
+
+static void put32(std::string& out, uint32_t value) {
+    put16(out, value & 0xFFFF);
+    put16(out, value >> 16);
+}
+
+std::string make_zip(const std::vector<std::pair<std::string, std::string>>& entries) {
+    std::string out;
+    std::string central;
+    for (const auto& entry : entries) {
+        uint32_t offset = static_cast<uint32_t>(out.size());
+        uint32_t crc = crc32(entry.second);
+        uint32_t size = static_cast<uint32_t>(entry.second.size());
+
+        // Local file header, method 0 (stored), DOS date 2024-01-01 00:00
+        put32(out, 0x04034b50);
+        put16(out, 20);
+        put16(out, 0);
+        put16(out, 0);
+        put16(out, 0);
+        put16(out, (44 << 9) | (1 << 5) | 1);
+        put32(out, crc);
+        put32(out, size);
+        put32(out, size);
+        put16(out, static_cast<uint32_t>(entry.first.size()));
+        put16(out, 0);
+        out += entry.first;
+        out += entry.second;
+
+        // Central directory record
+        put32(central, 0x02014b50);
+        put16(central, 20);
+        put16(central, 20);
+        put16(central, 0);
+        put16(central, 0);
+        put16(central, 0);
+        put16(central, (44 << 9) | (1 << 5) | 1);
+        put32(central, crc);
+        put32(central, size);
+        put32(central, size);
+        put16(central, static_cast<uint32_t>(entry.first.size()));
+        put16(central, 0);
+        put16(central, 0);
+        put16(central, 0);
+        put16(central, 0);
+        put32(central, 0);
+        put32(central, offset);
+        central += entry.first;
+    }
+
+    // End of central directory
+    uint32_t central_offset = static_cast<uint32_t>(out.size());
+    out += central;
+    put32(out, 0x06054b50);
+    put16(out, 0);
+    put16(out, 0);
+    put16(out, static_cast<uint32_t>(entries.size()));
+    put16(out, static_cast<uint32_t>(entries.size()));
+    put32(out, static_cast<uint32_t>(central.size()));
+    put32(out, central_offset);
+    put16(out, 0);
+    return out;
+}
+
+static const char* const INDEX_XML =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<DataSet>\n"
+    "  <Media>\n"
+    "    <Name>Synthetic Export</Name>\n"
+    "    <Table>\n"
+    "      <URL>buchungen.txt</URL>\n"
+    "      <Name>Buchungen</Name>\n"
+    "      <Description>Sachposten</Description>\n"
+    "      <DecimalSymbol>,</DecimalSymbol>\n"
+    "      <DigitGroupingSymbol>.</DigitGroupingSymbol>\n"
+    "      <VariableLength>\n"
+    "        <VariablePrimaryKey><Name>LfdNr</Name><Numeric/></VariablePrimaryKey>\n"
+    "        <VariableColumn><Name>KontoNr</Name><AlphaNumeric/></VariableColumn>\n"
+    "        <VariableColumn><Name>Betrag</Name><Numeric><Accuracy>2</Accuracy></Numeric></VariableColumn>\n"
+    "        <VariableColumn><Name>BuchungsDatum</Name><Date/></VariableColumn>\n"
+    "        <VariableColumn><Name>Buchungstext</Name><AlphaNumeric/></VariableColumn>\n"
+    "      </VariableLength>\n"
+    "    </Table>\n"
+    "  </Media>\n"
+    "</DataSet>\n";
+
+std::string make_buchungen_txt(size_t rows, unsigned seed) {
+    static const char* const konten[] = {"1200", "1400", "1600", "4400", "6300", "8400"};
+    std::string data;
+    data.reserve(rows * 48);
+    uint32_t state = seed * 2654435761u + 1;
+    char line[128];
+    for (size_t i = 1; i <= rows; ++i) {
+        state = state * 1664525u + 1013904223u;
+        long cents = static_cast<long>(state % 2000000) - 500000;
+        long whole = (cents < 0 ? -cents : cents) / 100;
+        snprintf(line, sizeof(line), "%zu;%s;%s%ld,%02ld;%02d.%02d.2024;Beleg %zu\n", i, konten[state % 6],
+                 cents < 0 ? "-" : "", whole, (cents < 0 ? -cents : cents) % 100,
+                 static_cast<int>(state % 28) + 1, static_cast<int>((state >> 8) % 12) + 1, i);
+        data += line;
+    }
+    return data;
+}
+
+std::string make_gdpdu_zip(size_t rows, unsigned seed) {
+    return make_zip({{"index.xml", INDEX_XML}, {"buchungen.txt", make_buchungen_txt(rows, seed)}});
+}
+
+} // namespace duckdb
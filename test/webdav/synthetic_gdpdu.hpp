@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace duckdb {
+
+// Zip archive of the given (name, content) entries, stored without compression
+std::string make_zip(const std::vector<std::pair<std::string, std::string>>& entries);
+
+// `rows` semicolon-separated Buchungen lines (LfdNr;KontoNr;Betrag;BuchungsDatum;Buchungstext) in
+// the German number and date format of a Navision export. seed varies the amounts.
+std::string make_buchungen_txt(size_t rows, unsigned seed = 1);
+
+// GDPdU export as a zip: index.xml describing one table "Buchungen" and buchungen.txt
+// from make_buchungen_txt(rows, seed).
+std::string make_gdpdu_zip(size_t rows, unsigned seed = 1);
+
+} // namespace duckdb
@@ -0,0 +1,193 @@
+// Transfer benchmark of WebDavClient and import_from_nextcloud against the in-process mock server
+// Run: build/test/webdav/gdpdu_webdav_benchmark [--zips=N] [--rows=N] [--latency-ms=N]
+//                                             [--bandwidth-mbit=N] [--concurrency=N]
+// Reports listing latency, download throughput (one connection and `concurrency` connections),
+// the transfer time of uncompressed data files with and without gzip, and end-to-end zips per
+// minute (download, extract, import; cache off).
+
+#include "mock_webdav_server.hpp"
+#include "synthetic_gdpdu.hpp"
+
+#include "duckdb.hpp"
+#include "nextcloud_importer.hpp"
+#include "webdav_client.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace duckdb;
+
+struct BenchmarkOptions {
+    int zips;
+    int rows;            // rows per zip
+    int latency_ms;      // added to every request
+    int bandwidth_mbit;  // shared by all connections, 0 = unlimited
+    int concurrency;     // download connections
+
+    BenchmarkOptions() : zips(20), rows(20000), latency_ms(20), bandwidth_mbit(0), concurrency(4) {}
+};
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool parse_option(const char* arg, const char* name, int& value) {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=') {
+        return false;
+    }
+    value = atoi(arg + length + 1);
+    return true;
+}
+
+// Download all files with `connections` parallel workers; returns seconds
+static double download_all(const std::string& url, const std::vector<WebDavFile>& files, int connections,
+                           const std::string& local_dir, int64_t& bytes, int& failed, bool compression = true) {
+    WebDavClient client(url, "test", "secret", connections);
+    client.set_compression(compression);
+    std::atomic<size_t> next(0);
+    std::atomic<int64_t> total(0);
+    std::atomic<int> errors(0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int w = 0; w < connections; ++w) {
+        workers.push_back(std::thread([&]() {
+            for (size_t i = next++; i < files.size(); i = next++) {
+                auto dl = client.download_file(files[i].href, local_dir, files[i].size, files[i].etag);
+                if (!dl.success) {
+                    errors++;
+                    continue;
+                }
+                total += dl.bytes_transferred;
+                remove(dl.local_path.c_str());
+            }
+        }));
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    bytes = total;
+    failed = errors;
+    return seconds_since(start);
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        if (!parse_option(argv[i], "--zips", options.zips) && !parse_option(argv[i], "--rows", options.rows) &&
+            !parse_option(argv[i], "--latency-ms", options.latency_ms) &&
+            !parse_option(argv[i], "--bandwidth-mbit", options.bandwidth_mbit) &&
+            !parse_option(argv[i], "--concurrency", options.concurrency)) {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    options.concurrency = std::max(1, options.concurrency);
+
+    // Synthetic exports, spread over year folders
+    MockWebDavServer server;
+    server.start();
+    int64_t zip_bytes = 0;
+    for (int i = 0; i < options.zips; ++i) {
+        std::string zip = make_gdpdu_zip(static_cast<size_t>(options.rows), static_cast<unsigned>(i));
+        zip_bytes += static_cast<int64_t>(zip.size());
+        char name[64];
+        snprintf(name, sizeof(name), "bench/%04d/Export %04d.zip", 2000 + i % 25, i);
+        server.put_file(name, zip, 1704067200 + i);
+    }
+    server.set_latency_ms(options.latency_ms);
+    server.set_bandwidth(static_cast<int64_t>(options.bandwidth_mbit) * 1000000 / 8);
+    const std::string url = server.url("bench");
+
+    printf("zips: %d x %d rows (%.1f MB), latency %d ms, bandwidth %s, concurrency %d\n", options.zips,
+           options.rows, zip_bytes / 1e6, options.latency_ms,
+           options.bandwidth_mbit ? (std::to_string(options.bandwidth_mbit) + " Mbit/s").c_str() : "unlimited",
+           options.concurrency);
+
+    // Listing latency: median of repeated recursive listings (Depth infinity and Depth-1 walk)
+    WebDavResult listing;
+    const MockDepthInfinity modes[] = {MockDepthInfinity::ALLOW, MockDepthInfinity::DEPTH_ONE};
+    const char* const mode_names[] = {"depth infinity", "depth-1 walk"};
+    for (int m = 0; m < 2; ++m) {
+        server.set_depth_infinity(modes[m]);
+        WebDavClient client(url, "test", "secret", options.concurrency);
+        std::vector<double> times;
+        for (int run = 0; run < 9; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            listing = client.list_files(true, true);
+            times.push_back(seconds_since(start) * 1000);
+            if (!listing.success) {
+                fprintf(stderr, "listing failed: %s\n", listing.error_message.c_str());
+                return 1;
+            }
+        }
+        std::sort(times.begin(), times.end());
+        printf("listing (%s, %zu zips): %.1f ms\n", mode_names[m], listing.files.size(), times[times.size() / 2]);
+    }
+    server.set_depth_infinity(MockDepthInfinity::ALLOW);
+
+    // Download throughput
+    std::string local_dir = create_temp_download_dir();
+    const int connection_counts[] = {1, options.concurrency};
+    for (int c = 0; c < (options.concurrency > 1 ? 2 : 1); ++c) {
+        int64_t bytes = 0;
+        int failed = 0;
+        double seconds = download_all(url, listing.files, connection_counts[c], local_dir, bytes, failed);
+        printf("download (%d connection%s): %.1f MB/s%s\n", connection_counts[c], connection_counts[c] > 1 ? "s" : "",
+               bytes / 1e6 / seconds, failed ? (" (" + std::to_string(failed) + " failed)").c_str() : "");
+    }
+
+    // Uncompressed data files (as in a DATEV or CSV folder), served gzip-compressed on request
+    {
+        for (int i = 0; i < options.concurrency * 2; ++i) {
+            server.put_file("text/buchungen_" + std::to_string(i) + ".txt",
+                            make_buchungen_txt(static_cast<size_t>(options.rows), static_cast<unsigned>(i)),
+                            1704067200 + i);
+        }
+        server.set_content_encoding(MockContentEncoding::GZIP);
+        const std::string text_url = server.url("text");
+        WebDavResult text_listing = WebDavClient(text_url, "test", "secret").list_files(false);
+        for (int gzip = 1; gzip >= 0; --gzip) {
+            int64_t bytes = 0;
+            int failed = 0;
+            double seconds = download_all(text_url, text_listing.files, options.concurrency, local_dir, bytes,
+                                          failed, gzip != 0);
+            printf("data files (%s): %.2f s, %.1f MB on the wire%s\n", gzip ? "gzip" : "identity", seconds,
+                   bytes / 1e6, failed ? (" (" + std::to_string(failed) + " failed)").c_str() : "");
+        }
+        server.set_content_encoding(MockContentEncoding::NONE);
+    }
+    cleanup_temp_dir(local_dir);
+
+    // End to end: list, download, extract and import every zip
+    {
+        DuckDB db(nullptr);
+        Connection conn(db);
+        NextcloudImportConfig config;
+        config.recursive = true;
+        config.use_cache = false;
+        config.download_concurrency = static_cast<size_t>(options.concurrency);
+        auto start = std::chrono::steady_clock::now();
+        auto results = import_from_nextcloud(conn, url, "test", "secret", config);
+        double seconds = seconds_since(start);
+        int64_t rows = 0;
+        int failed = 0;
+        for (const auto& r : results) {
+            rows += r.row_count;
+            failed += r.status == "OK" ? 0 : 1;
+        }
+        printf("end to end: %.1f zips/min (%.2f s, %lld rows%s)\n", options.zips / seconds * 60, seconds,
+               static_cast<long long>(rows), failed ? (", " + std::to_string(failed) + " failed").c_str() : "");
+        cleanup_temp_dir(get_download_dir(url));
+    }
+
+    server.stop();
+    return 0;
+}
@@ -0,0 +1,381 @@
+// WebDAV client and Nextcloud import tests against the in-process mock server
+// Run: build/test/webdav/gdpdu_webdav_test (exit code 1 if a check fails)
+
+#include "mock_webdav_server.hpp"
+#include "synthetic_gdpdu.hpp"
+
+#include "data_source.hpp"
+#include "directory_walker.hpp"
+#include "duckdb.hpp"
+#include "nextcloud_importer.hpp"
+#include "webdav_client.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace duckdb;
+
+static int failures = 0;
+
+static void check(bool ok, const std::string& name, const std::string& detail = "") {
+    if (ok) {
+        printf("PASS %s\n", name.c_str());
+    } else {
+        printf("FAIL %s%s%s\n", name.c_str(), detail.empty() ? "" : ": ", detail.c_str());
+        failures++;
+    }
+}
+
+static std::string read_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream content;
+    content << in.rdbuf();
+    return content.str();
+}
+
+static int64_t count_rows(Connection& conn, const std::string& table) {
+    auto result = conn.Query("SELECT COUNT(*) FROM \"" + table + "\"");
+    return result->HasError() ? -1 : result->GetValue(0, 0).GetValue<int64_t>();
+}
+
+static const int64_t T2022 = 1672531200;  // 2023-01-01 00:00:00 UTC
+static const int64_t T2023 = 1704067200;  // 2024-01-01
+static const int64_t T2024 = 1735689600;  // 2025-01-01
+
+int main() {
+    MockWebDavServer server;
+    server.start();
+    const std::string zip_2023 = make_gdpdu_zip(50, 2023);
+    const std::string zip_2024 = make_gdpdu_zip(80, 2024);
+    const std::string zip_2022 = make_gdpdu_zip(30, 2022);
+    server.put_file("exports/Export 2023.zip", zip_2023, T2023);
+    server.put_file("exports/Export 2024.zip", zip_2024, T2024);
+    server.put_file("exports/notes.txt", "not a zip", T2024);
+    server.put_file("exports/archiv/2022/Export 2022.zip", zip_2022, T2022);
+    const std::string url = server.url("exports");
+
+    std::string local_dir = create_temp_download_dir();
+
+    // ============================================================
+    printf("--- Test 1: Listing ---\n");
+    {
+        WebDavClient client(url, "test", "secret");
+        auto listing = client.list_files(true);
+        check(listing.success, "list succeeds", listing.error_message);
+        check(listing.files.size() == 2, "two zips at the top level", std::to_string(listing.files.size()));
+        bool props = listing.files.size() == 2;
+        for (const auto& file : listing.files) {
+            props = props && !file.etag.empty() && file.size > 0 && file.modified_time > 0;
+        }
+        check(props, "ETag, size and last-modified reported");
+        check(listing.files.size() == 2 && listing.files[0].name == "Export 2023.zip" &&
+              listing.files[0].size == static_cast<int64_t>(zip_2023.size()) &&
+              listing.files[0].modified_time == T2023, "name decoded, size and date match");
+
+        WebDavClient wrong(url, "test", "wrong");
+        auto denied = wrong.list_files(true);
+        check(!denied.success && denied.error_message.find("Authentication") != std::string::npos,
+              "wrong password reported", denied.error_message);
+    }
+
+    // ============================================================
+    printf("--- Test 2: Recursive listing ---\n");
+    {
+        const MockDepthInfinity modes[] = {MockDepthInfinity::ALLOW, MockDepthInfinity::REFUSE,
+                                           MockDepthInfinity::DEPTH_ONE};
+        const char* const mode_names[] = {"depth infinity", "depth infinity refused", "depth infinity as depth 1"};
+        const int64_t expected_requests[] = {1, 4, 3};
+        for (int m = 0; m < 3; ++m) {
+            server.set_depth_infinity(modes[m]);
+            server.reset_stats();
+            WebDavClient client(url, "test", "secret");
+            auto listing = client.list_files(true, true);
+            std::string paths;
+            for (const auto& file : listing.files) {
+                paths += file.path + ";";
+            }
+            check(listing.success && paths == "Export 2023.zip;Export 2024.zip;archiv/2022/Export 2022.zip;",
+                  std::string(mode_names[m]) + ": all zips below the folder", listing.error_message + paths);
+            check(server.stats().propfind_requests == expected_requests[m],
+                  std::string(mode_names[m]) + ": PROPFIND requests",
+                  std::to_string(server.stats().propfind_requests));
+        }
+        server.set_depth_infinity(MockDepthInfinity::ALLOW);
+    }
+
+    // ============================================================
+    printf("--- Test 3: Download ---\n");
+    {
+        WebDavClient client(url, "test", "secret");
+        auto listing = client.list_files(true);
+        const WebDavFile& file = listing.files[1];
+        auto dl = client.download_file(file.href, local_dir, file.size, file.etag);
+        check(dl.success, "download succeeds", dl.error_message);
+        check(read_file(dl.local_path) == zip_2024, "content matches");
+        check(dl.bytes_written == static_cast<int64_t>(zip_2024.size()) && !dl.resumed, "size reported");
+        remove(dl.local_path.c_str());
+    }
+
+    // ============================================================
+    printf("--- Test 4: Resume with Range ---\n");
+    {
+        WebDavClient client(url, "test", "secret");
+        client.set_retry_policy(1, 0);
+        auto listing = client.list_files(true);
+        const WebDavFile& file = listing.files[0];
+
+        server.drop_next_download_after(1000);
+        auto broken = client.download_file(file.href, local_dir, file.size, file.etag);
+        check(!broken.success, "broken-off download fails");
+
+        server.reset_stats();
+        auto dl = client.download_file(file.href, local_dir, file.size, file.etag);
+        check(dl.success && dl.resumed, "second call resumes", dl.error_message);
+        check(dl.bytes_transferred == static_cast<int64_t>(zip_2023.size()) - 1000 &&
+              server.stats().range_requests == 1, "only the rest is transferred",
+              std::to_string(dl.bytes_transferred));
+        check(read_file(dl.local_path) == zip_2023, "resumed content matches");
+        remove(dl.local_path.c_str());
+    }
+
+    // ============================================================
+    printf("--- Test 5: If-Range after a change on the server ---\n");
+    {
+        WebDavClient client(url, "test", "secret");
+        client.set_retry_policy(1, 0);
+        auto listing = client.list_files(true);
+        const WebDavFile& file = listing.files[0];
+
+        server.drop_next_download_after(1000);
+        client.download_file(file.href, local_dir);
+        const std::string changed = make_gdpdu_zip(60, 7);
+        server.put_file("exports/Export 2023.zip", changed, T2023 + 60);
+
+        // No ETag passed: the part file's ETag goes out as If-Range and no longer matches
+        auto dl = client.download_file(file.href, local_dir);
+        check(dl.success && !dl.resumed && read_file(dl.local_path) == changed,
+              "changed file is fetched whole", dl.error_message);
+        remove(dl.local_path.c_str());
+        server.put_file("exports/Export 2023.zip", zip_2023, T2023);
+    }
+
+    // ============================================================
+    printf("--- Test 6: import_from_nextcloud ---\n");
+    DuckDB db(nullptr);
+    Connection conn(db);
+    NextcloudImportConfig config;
+    config.recursive = true;
+    {
+        server.reset_stats();
+        auto results = import_from_nextcloud(conn, url, "test", "secret", config);
+        bool all_ok = results.size() == 3;
+        for (const auto& r : results) {
+            all_ok = all_ok && r.status == "OK";
+        }
+        check(all_ok, "three zips imported", std::to_string(results.size()) +
+              (results.empty() ? "" : " " + results[0].table_name + ": " + results[0].status));
+        check(count_rows(conn, "Export_2023_Buchungen") == 50 && count_rows(conn, "Export_2024_Buchungen") == 80 &&
+              count_rows(conn, "archiv_2022_Export_2022_Buchungen") == 30, "row counts");
+        check(server.stats().get_requests == 3, "one GET per zip", std::to_string(server.stats().get_requests));
+    }
+
+    // ============================================================
+    printf("--- Test 7: since := 'last' ---\n");
+    {
+        server.reset_stats();
+        config.since_last = true;
+        auto results = import_from_nextcloud(conn, url, "test", "secret", config);
+        bool all_skipped = results.size() == 3;
+        for (const auto& r : results) {
+            all_skipped = all_skipped && r.table_name == "(skipped)";
+        }
+        check(all_skipped && server.stats().get_requests == 0, "unchanged zips are skipped without a download");
+
+        server.put_file("exports/Export 2024.zip", make_gdpdu_zip(90, 9), T2024 + 3600);
+        results = import_from_nextcloud(conn, url, "test", "secret", config);
+        check(count_rows(conn, "Export_2024_Buchungen") == 90 && server.stats().get_requests == 1,
+              "changed zip is imported again", std::to_string(server.stats().get_requests));
+        config.since_last = false;
+    }
+
+    // ============================================================
+    printf("--- Test 8: ETag cache ---\n");
+    {
+        server.reset_stats();
+        auto results = import_from_nextcloud(conn, url, "test", "secret", config);
+        check(results.size() == 3 && server.stats().get_requests == 0,
+              "full re-import is served from the cache", std::to_string(server.stats().get_requests));
+
+        // A cache_dir given by the user is shared safely: entries go to a subdirectory per URL
+        const std::string shared_cache = create_temp_download_dir();
+        { std::ofstream(shared_cache + "/unrelated.zip") << "keep me"; }
+        NextcloudImportConfig shared_config = config;
+        shared_config.cache_dir = shared_cache;
+        import_from_nextcloud(conn, url, "test", "secret", shared_config);
+        server.put_file("other/Export 2019.zip", make_gdpdu_zip(19, 19), T2022);
+        import_from_nextcloud(conn, server.url("other"), "test", "secret", shared_config);
+        server.reset_stats();
+        import_from_nextcloud(conn, url, "test", "secret", shared_config);
+        check(read_file(shared_cache + "/unrelated.zip") == "keep me" && server.stats().get_requests == 0,
+              "shared cache_dir keeps other files and other URLs' entries", std::to_string(server.stats().get_requests));
+        cleanup_temp_dir(shared_cache);
+    }
+
+    // ============================================================
+    printf("--- Test 9: webdav:// source ---\n");
+    {
+        const std::string uri = "webdav://test:secret@" + url.substr(url.find("://") + 3);
+        server.reset_stats();
+        {
+            SourceMount mount(uri);
+            check(mount.ok() && read_file(mount.local_path() + "/archiv/2022/Export 2022.zip") == zip_2022 &&
+                  server.stats().get_requests == 4, "mirror downloads every file", mount.error());
+            DirectoryWalkOptions walk;
+            walk.recursive = true;
+            check(walk_directory(mount.local_path(), walk).size() == 4, "all files mirrored");
+            check(mount.uri().find("secret") == std::string::npos, "password not in the URI", mount.uri());
+        }
+        server.reset_stats();
+        server.put_file("exports/notes.txt", "changed", T2024 + 60);
+        {
+            SourceMount mount(uri);
+            check(mount.ok() && server.stats().get_requests == 1 && read_file(mount.local_path() + "/notes.txt") == "changed",
+                  "second mirror fetches only the changed file", std::to_string(server.stats().get_requests));
+        }
+
+        // Two mounts of the URL at once take turns on the mirror instead of downloading into the
+        // same .part file
+        const std::string large(512 * 1024, 'x');
+        server.put_file("exports/notes.txt", large, T2024 + 120);
+        server.set_latency_ms(20);
+        server.reset_stats();
+        bool mounted[2] = {false, false};
+        std::string contents[2];
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 2; ++t) {
+            threads.push_back(std::thread([&, t]() {
+                SourceMount mount(uri);
+                mounted[t] = mount.ok();
+                contents[t] = read_file(mount.local_path() + "/notes.txt");
+            }));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        server.set_latency_ms(0);
+        check(mounted[0] && mounted[1] && contents[0] == large && contents[1] == large &&
+              server.stats().get_requests == 1, "concurrent mounts share one download",
+              std::to_string(server.stats().get_requests));
+        server.put_file("exports/notes.txt", "not a zip", T2024);
+    }
+
+    // ============================================================
+    printf("--- Test 10: Compressed transfer ---\n");
+    {
+        const std::string text = make_buchungen_txt(5000);
+        server.put_file("texts/buchungen.txt", text, T2024);
+        server.put_file("texts/Export 2024.zip", zip_2024, T2024);
+        server.set_content_encoding(MockContentEncoding::GZIP);
+        WebDavClient client(server.url("texts"), "test", "secret");
+        client.set_retry_policy(1, 0);
+
+        server.reset_stats();
+        auto listing = client.list_files(false);
+        check(listing.success && listing.files.size() == 2 && server.stats().compressed_responses == 1,
+              "listing arrives gzip-compressed", listing.error_message);
+        WebDavFile text_file, zip_file;
+        for (const auto& file : listing.files) {
+            (file.name == "buchungen.txt" ? text_file : zip_file) = file;
+        }
+
+        server.reset_stats();
+        auto dl = client.download_file(text_file.href, local_dir, text_file.size, text_file.etag);
+        check(dl.success && read_file(dl.local_path) == text && dl.content_encoding == "gzip",
+              "text file is decoded on the way to disk", dl.error_message);
+        check(dl.bytes_written == static_cast<int64_t>(text.size()) &&
+              dl.bytes_transferred < static_cast<int64_t>(text.size()) / 2,
+              "less than half the bytes on the wire", std::to_string(dl.bytes_transferred));
+        remove(dl.local_path.c_str());
+
+        auto zip_dl = client.download_file(zip_file.href, local_dir, zip_file.size, zip_file.etag);
+        check(zip_dl.success && zip_dl.content_encoding.empty() && read_file(zip_dl.local_path) == zip_2024 &&
+              server.stats().compressed_responses == 1, "zip is fetched as is", zip_dl.error_message);
+        remove(zip_dl.local_path.c_str());
+
+        server.set_content_encoding(MockContentEncoding::DEFLATE);
+        dl = client.download_file(text_file.href, local_dir, text_file.size, text_file.etag);
+        check(dl.success && read_file(dl.local_path) == text && dl.content_encoding == "deflate",
+              "deflate-encoded file is decoded", dl.error_message);
+        remove(dl.local_path.c_str());
+
+        // The decoded part of a broken-off transfer is resumed with a plain Range request
+        server.set_content_encoding(MockContentEncoding::GZIP);
+        server.drop_next_download_after(2000);
+        auto broken = client.download_file(text_file.href, local_dir, text_file.size, text_file.etag);
+        check(!broken.success, "broken-off compressed download fails");
+        server.reset_stats();
+        dl = client.download_file(text_file.href, local_dir, text_file.size, text_file.etag);
+        check(dl.success && dl.resumed && read_file(dl.local_path) == text && server.stats().range_requests == 1 &&
+              server.stats().compressed_responses == 0, "resumed without compression", dl.error_message);
+        remove(dl.local_path.c_str());
+
+        std::string whole, error;
+        bool read = client.read_file(text_file.href, 0, -1, [&](const char* data, size_t size) {
+            whole.append(data, size);
+            return true;
+        }, error);
+        check(read && whole == text, "whole-file read is decoded", error);
+
+        server.reset_stats();
+        client.set_compression(false);
+        listing = client.list_files(false);
+        dl = client.download_file(text_file.href, local_dir, text_file.size, text_file.etag);
+        check(listing.success && dl.success && dl.content_encoding.empty() && server.stats().compressed_responses == 0,
+              "set_compression(false) asks for identity", dl.error_message);
+        remove(dl.local_path.c_str());
+        server.set_content_encoding(MockContentEncoding::NONE);
+    }
+
+    // ============================================================
+    printf("--- Test 11: since := 'last' after a failed zip ---\n");
+    {
+        // The older zip fails, the newer one imports; the older one must not be skipped afterwards
+        const std::string late_url = server.url("late");
+        server.put_file("late/Export 2021.zip", "not a zip", T2022);
+        server.put_file("late/Export 2025.zip", make_gdpdu_zip(25, 25), T2024);
+        NextcloudImportConfig late_config;
+        late_config.since_last = true;
+        auto results = import_from_nextcloud(conn, late_url, "test", "secret", late_config);
+        bool older_failed = false;
+        for (const auto& r : results) {
+            older_failed = older_failed || (r.source_zip == "Export 2021.zip" && r.status != "OK");
+        }
+        check(older_failed && count_rows(conn, "Export_2025_Buchungen") == 25, "older zip fails, newer one imports");
+
+        server.put_file("late/Export 2021.zip", make_gdpdu_zip(21, 21), T2022);
+        results = import_from_nextcloud(conn, late_url, "test", "secret", late_config);
+        bool newer_skipped = false;
+        for (const auto& r : results) {
+            newer_skipped = newer_skipped || (r.source_zip == "Export 2025.zip" && r.table_name == "(skipped)");
+        }
+        check(count_rows(conn, "Export_2021_Buchungen") == 21, "older zip is imported by the next run");
+        check(newer_skipped, "imported zip is still skipped");
+
+        // A zip uploaded late with its original modification time
+        server.put_file("late/Export 2020.zip", make_gdpdu_zip(20, 20), T2022 - 86400);
+        results = import_from_nextcloud(conn, late_url, "test", "secret", late_config);
+        check(results.size() == 3 && count_rows(conn, "Export_2020_Buchungen") == 20, "late upload is imported",
+              std::to_string(results.size()));
+    }
+
+    cleanup_temp_dir(local_dir);
+    cleanup_temp_dir(get_download_dir(url));
+    server.stop();
+
+    printf("%s: %d check(s) failed\n", failures ? "FAIL" : "PASS", failures);
+    return failures ? 1 : 0;
+}